@@ -0,0 +1,73 @@
+/**
+ * @file    CounterUARTTX_Benchmark.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Includes
+#include <PropWare/PropWare.h>
+#include <PropWare/serial/uart/counteruarttx.h>
+#include <PropWare/hmi/output/printer.h>
+
+using PropWare::UARTTX;
+using PropWare::CounterUARTTX;
+using PropWare::Port;
+
+static const size_t BUFFER_SIZE = 1024;
+
+static uint8_t g_buffer[BUFFER_SIZE];
+
+static void benchmark (const char name[], UARTTX &uart, const int32_t baudRate);
+
+/**
+ * @example     CounterUARTTX_Benchmark.cpp
+ *
+ * Measure the throughput of `PropWare::UARTTX` and `PropWare::CounterUARTTX` on P0. Hook a logic analyzer to P0 to
+ * verify the framing at each baud rate.
+ *
+ * @include PropWare_CounterUARTTX/CMakeLists.txt
+ */
+int main () {
+    for (size_t i = 0; i < BUFFER_SIZE; ++i)
+        g_buffer[i] = (uint8_t) i;
+
+    UARTTX        uart(Port::P0);
+    CounterUARTTX counterUart(Port::P0);
+
+    benchmark("UARTTX", uart, PropWare::UART::MAX_BAUD);
+    benchmark("CounterUARTTX", counterUart, CLKFREQ / CounterUARTTX::MIN_WAITCNT_CYCLES);
+    benchmark("CounterUARTTX", counterUart, CLKFREQ / CounterUARTTX::MIN_BIT_CYCLES);
+
+    return 0;
+}
+
+void benchmark (const char name[], UARTTX &uart, const int32_t baudRate) {
+    uart.set_baud_rate(baudRate);
+
+    const uint32_t start   = CNT;
+    uart.send_array((const char *) g_buffer, BUFFER_SIZE);
+    const uint32_t elapsed = CNT - start;
+
+    const uint32_t bytesPerSecond = (uint32_t) (((uint64_t) BUFFER_SIZE * CLKFREQ) / elapsed);
+    pwOut.printf("%s @ %d baud: %u cycles/byte, %u bytes/s, %u bits/s effective\n", name, baudRate,
+                 elapsed / BUFFER_SIZE, bytesPerSecond, bytesPerSecond * 10);
+}
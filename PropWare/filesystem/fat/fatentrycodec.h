@@ -0,0 +1,219 @@
+/**
+ * @file        PropWare/filesystem/fat/fatentrycodec.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/PropWare.h>
+
+namespace PropWare {
+
+/**
+ * @brief   Describes how the entries of one flavor of file allocation table are laid out and interpreted
+ *
+ * `PropWare::FatFS` chooses a codec while mounting and then never needs to know which flavor of FAT it is working
+ * with: it reads `FatEntryCodec::get_width` bytes from `FatEntryCodec::get_offset` (which may straddle two sectors of
+ * the FAT), and lets the codec extract or insert the entry's value.
+ */
+class FatEntryCodec {
+    public:
+        /**
+         * @brief   Number of bytes that must be read from the FAT to obtain a single entry - either 2 or 4
+         */
+        virtual uint8_t get_width () const = 0;
+
+        /**
+         * @brief   Offset, in bytes from the start of the FAT, of the first byte holding `entry`
+         */
+        virtual uint32_t get_offset (const uint32_t entry) const = 0;
+
+        /**
+         * @brief       Extract an entry's value
+         *
+         * @param[in]   raw     `FatEntryCodec::get_width` bytes read from `FatEntryCodec::get_offset`, little-endian
+         * @param[in]   entry   Entry number (cluster) that was read
+         */
+        virtual uint32_t decode (const uint32_t raw, const uint32_t entry) const = 0;
+
+        /**
+         * @brief       Insert an entry's value, leaving any bits belonging to neighboring entries untouched
+         *
+         * @param[in]   raw     `FatEntryCodec::get_width` bytes read from `FatEntryCodec::get_offset`, little-endian
+         * @param[in]   entry   Entry number (cluster) being written
+         * @param[in]   value   New value for the entry (the next cluster)
+         *
+         * @return      Bytes to be written back in place of `raw`
+         */
+        virtual uint32_t encode (const uint32_t raw, const uint32_t entry, const uint32_t value) const = 0;
+
+        /**
+         * @brief   Value written to the last entry of a chain
+         */
+        virtual uint32_t get_eoc () const = 0;
+
+        /**
+         * @brief   Determine whether a decoded value marks the end of a chain
+         */
+        bool is_eoc (const uint32_t value) const {
+            // Every flavor reserves its eight highest values for end-of-chain markers, and every flavor's marker is
+            // also a mask of the bits that hold a value
+            const uint32_t eoc = this->get_eoc();
+            return eoc - 7 <= (value & eoc);
+        }
+};
+
+/**
+ * @brief   12-bit entries, packed two to every three bytes
+ */
+class Fat12EntryCodec : public FatEntryCodec {
+    public:
+        static const Fat12EntryCodec &get_instance () {
+            static const Fat12EntryCodec instance;
+            return instance;
+        }
+
+        uint8_t get_width () const {
+            return 2;
+        }
+
+        uint32_t get_offset (const uint32_t entry) const {
+            return entry + (entry >> 1);
+        }
+
+        uint32_t decode (const uint32_t raw, const uint32_t entry) const {
+            // Odd entries occupy the upper 12 bits of their two bytes, even entries the lower 12
+            return (entry & 1) ? raw >> 4 : raw & 0x0FFF;
+        }
+
+        uint32_t encode (const uint32_t raw, const uint32_t entry, const uint32_t value) const {
+            if (entry & 1)
+                return (raw & 0x000F) | ((value & 0x0FFF) << 4);
+            else
+                return (raw & 0xF000) | (value & 0x0FFF);
+        }
+
+        uint32_t get_eoc () const {
+            return 0x0FFF;
+        }
+};
+
+/**
+ * @brief   16-bit entries
+ */
+class Fat16EntryCodec : public FatEntryCodec {
+    public:
+        static const Fat16EntryCodec &get_instance () {
+            static const Fat16EntryCodec instance;
+            return instance;
+        }
+
+        uint8_t get_width () const {
+            return 2;
+        }
+
+        uint32_t get_offset (const uint32_t entry) const {
+            return entry << 1;
+        }
+
+        uint32_t decode (const uint32_t raw, const uint32_t entry) const {
+            return raw & WORD_0;
+        }
+
+        uint32_t encode (const uint32_t raw, const uint32_t entry, const uint32_t value) const {
+            return value & WORD_0;
+        }
+
+        uint32_t get_eoc () const {
+            return WORD_0;
+        }
+};
+
+/**
+ * @brief   32-bit entries, of which only the lower 28 bits are used
+ */
+class Fat32EntryCodec : public FatEntryCodec {
+    public:
+        static const Fat32EntryCodec &get_instance () {
+            static const Fat32EntryCodec instance;
+            return instance;
+        }
+
+        uint8_t get_width () const {
+            return 4;
+        }
+
+        uint32_t get_offset (const uint32_t entry) const {
+            return entry << 2;
+        }
+
+        uint32_t decode (const uint32_t raw, const uint32_t entry) const {
+            // The highest 4 bits are reserved
+            return raw & 0x0FFFFFFF;
+        }
+
+        uint32_t encode (const uint32_t raw, const uint32_t entry, const uint32_t value) const {
+            // The reserved bits must be preserved
+            return (raw & 0xF0000000) | (value & 0x0FFFFFFF);
+        }
+
+        uint32_t get_eoc () const {
+            return 0x0FFFFFFF;
+        }
+};
+
+/**
+ * @brief   32-bit entries, all of which are used
+ *
+ * Only files that are fragmented have their chain recorded in an exFAT volume's FAT; see
+ * `FatFile::m_contiguousClusters`.
+ */
+class ExFatEntryCodec : public FatEntryCodec {
+    public:
+        static const ExFatEntryCodec &get_instance () {
+            static const ExFatEntryCodec instance;
+            return instance;
+        }
+
+        uint8_t get_width () const {
+            return 4;
+        }
+
+        uint32_t get_offset (const uint32_t entry) const {
+            return entry << 2;
+        }
+
+        uint32_t decode (const uint32_t raw, const uint32_t entry) const {
+            return raw;
+        }
+
+        uint32_t encode (const uint32_t raw, const uint32_t entry, const uint32_t value) const {
+            return value;
+        }
+
+        uint32_t get_eoc () const {
+            return 0xFFFFFFFF;
+        }
+};
+
+}
@@ -27,22 +27,72 @@
 
 #include <PropWare/filesystem/file.h>
 #include <PropWare/filesystem/fat/fatfs.h>
+#include <PropWare/memory/bufferpool.h>
 
 namespace PropWare {
 
 /**
- * @brief   A generic interface for all files on the FAT 16/32 filesystem
+ * @brief   A generic interface for all files on the FAT 12/16/32 and exFAT filesystems
  */
 class FatFile : virtual public File {
+        friend class FatFS;
+
     public:
         typedef enum {
                                     NO_ERROR       = 0,
-                                    BEG_ERROR      = Filesystem::END_ERROR + 1,
+                                    BEG_ERROR      = FatFS::END_ERROR + 1,
             /** FatFile Error  0 */ ENTRY_NOT_FILE = BEG_ERROR,
             /** FatFile Error  1 */ FILENAME_NOT_FOUND,
-                                    END_ERROR      = FILENAME_NOT_FOUND
+            /** FatFile Error  2 */ UNALIGNED_POINTER,
+            /** FatFile Error  3 */ NO_UNIQUE_SHORT_NAME,
+            /** FatFile Error  4 */ ENTRY_NOT_DIRECTORY,
+            /** FatFile Error  5 */ ENTRY_EXISTS,
+            /** FatFile Error  6 */ FILE_TOO_LARGE,
+                                    END_ERROR      = FILE_TOO_LARGE
         } ErrorCode;
 
+        /**
+         * @brief   A run of consecutive clusters on disk that hold consecutive clusters of a file
+         */
+        struct Extent {
+            /** First cluster of the run, counting from the beginning of the file */
+            uint32_t fileCluster;
+            /** Cluster on the storage device that holds `fileCluster` */
+            uint32_t diskCluster;
+            /** Number of clusters in the run */
+            uint32_t runLength;
+        };
+
+    protected:
+        /**
+         * @brief   A long file name, assembled from its directory entries
+         */
+        struct LongName {
+            char    name[MAX_FILENAME_LENGTH];
+            uint8_t checksum;
+            /** Ordinal of the next entry expected; entries are stored in descending order */
+            uint8_t nextOrdinal;
+            /** Every entry of the name has been read */
+            bool    complete;
+            /** The name does not fit in `name` and can therefore never match */
+            bool    truncated;
+        };
+
+        /**
+         * @brief   The fields of an exFAT entry set that are needed to open a file or directory. They are spread across
+         *          several directory entries, which need not share a sector
+         */
+        struct ExFatEntry {
+            uint32_t firstCluster;
+            /** Number of clusters when the data is stored without a FAT chain, otherwise 0 */
+            uint32_t contiguousClusters;
+            /** Length of the valid data, in bytes */
+            uint32_t length;
+            /** The length does not fit in `File::m_length` */
+            bool     oversized;
+            bool     directory;
+        };
+
     public:
         /**
          * @brief   Determine the name of a file
@@ -61,7 +111,7 @@ class FatFile : virtual public File {
          */
         bool exists () const {
             uint16_t temp = 0;
-            return NO_ERROR == this->find(this->get_name(), &temp);
+            return NO_ERROR == this->locate(&temp);
         }
 
         /**
@@ -71,17 +121,246 @@ class FatFile : virtual public File {
          */
         bool exists (PropWare::ErrorCode &err) const {
             uint16_t temp = 0;
-            err = this->find(this->get_name(), &temp);
+            err = this->locate(&temp);
             return NO_ERROR == err;
         }
 
+        /**
+         * @brief       Provide storage for caching the layout of this file's cluster chain
+         *
+         * Without a cache, seeking backwards requires walking the FAT from the very beginning of the file. With one,
+         * the chain is recorded as a list of extents the first time it is walked, and any position within the
+         * recorded portion of the file is reached with at most a single FAT lookup. A file written to a freshly
+         * formatted volume (or with `FatFileWriter::preallocate`) usually needs only a single extent; each
+         * fragment of the file beyond the capacity of the cache falls back to walking the FAT.
+         *
+         * @param[in]   extents[]   Array used to store the extents, or NULL to disable the cache
+         * @param[in]   capacity    Number of elements in `extents`
+         */
+        void set_extent_cache (Extent extents[], const uint8_t capacity) {
+            this->m_extents        = extents;
+            this->m_extentCapacity = NULL == extents ? 0 : capacity;
+            this->reset_extents();
+        }
+
+        /**
+         * @brief   Create a human-readable error string
+         *
+         * @param[in]   printer     Printer used for logging the message
+         * @param[in]   err         Error number used to determine error string
+         */
+        static void print_error_str (const Printer &printer, const ErrorCode err) {
+            const uint8_t relativeError = err - BEG_ERROR;
+
+            switch (err) {
+                case ENTRY_NOT_FILE:
+                    printer << "FatFile Error " << relativeError << ": Entry is not a file\n";
+                    break;
+                case FILENAME_NOT_FOUND:
+                    printer << "FatFile Error " << relativeError << ": File name not found\n";
+                    break;
+                case UNALIGNED_POINTER:
+                    printer << "FatFile Error " << relativeError << ": Position is not aligned to a sector\n";
+                    break;
+                case NO_UNIQUE_SHORT_NAME:
+                    printer << "FatFile Error " << relativeError << ": Unable to generate a unique short name\n";
+                    break;
+                case ENTRY_NOT_DIRECTORY:
+                    printer << "FatFile Error " << relativeError << ": Entry is not a directory\n";
+                    break;
+                case ENTRY_EXISTS:
+                    printer << "FatFile Error " << relativeError << ": Entry already exists\n";
+                    break;
+                case FILE_TOO_LARGE:
+                    printer << "FatFile Error " << relativeError << ": File is too large\n";
+                    break;
+                default:
+                    Filesystem::print_error_str(printer, (Filesystem::ErrorCode) err);
+            }
+        }
+
     protected:
 
-        FatFile (FatFS &fs, const char name[], BlockStorage::Buffer &buffer, const Printer &logger = pwOut)
+        FatFile (FatFS &fs, const char name[], BlockStorage::Buffer &buffer, const Printer &logger = pwOut,
+                 BufferPool *pool = NULL)
                 : File(fs, name, buffer, logger),
-                  m_fs(&fs) {
-            strcpy(this->m_name, name);
-            Utility::to_upper(this->m_name);
+                  m_fs(&fs),
+                  m_pool(pool),
+                  m_extents(NULL),
+                  m_extentCapacity(0),
+                  m_extentCount(0),
+                  m_extentCoverage(0),
+                  m_contiguousClusters(0),
+                  m_dirFirstCluster(fs.m_dir_firstCluster),
+                  m_dirContiguousClusters(fs.m_dirContiguousClusters) {
+            if (MAX_FILENAME_LENGTH > strlen(name)) {
+                strcpy(this->m_name, name);
+                Utility::to_upper(this->m_name);
+            } else
+                // An empty name makes every attempt to locate the file fail with INVALID_FILENAME
+                this->m_name[0] = 0;
+        }
+
+        /**
+         * @brief   The buffer is given back to the pool (if it came from one) and left without any reference to this
+         *          file's metadata
+         */
+        virtual ~FatFile () {
+            this->detach_buffer();
+            if (NULL != this->m_pool)
+                this->m_pool->release(*this->m_buf);
+        }
+
+        /**
+         * @brief   Final component of a path - the name of the file itself
+         */
+        static const char *leaf_name (const char path[]) {
+            const char *slash = strrchr(path, '/');
+            return NULL == slash ? path : slash + 1;
+        }
+
+        /**
+         * @brief       Find this file's entry, following any directories named in its path
+         *
+         * @param[out]  *fileEntryOffset    See `FatFile::find`
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode locate (uint16_t *fileEntryOffset) const {
+            PropWare::ErrorCode err;
+
+            check_errors(this->resolve_parent());
+            return this->find(leaf_name(this->m_name), fileEntryOffset);
+        }
+
+        /**
+         * @brief       Follow the directories named in this file's path, making the last of them the directory that
+         *              `FatFile::find` searches
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode resolve_parent () const {
+            PropWare::ErrorCode err;
+            const char          *leaf = leaf_name(this->m_name);
+
+            if (!*leaf)
+                return INVALID_FILENAME;
+
+            uint32_t directory;
+            check_errors(this->resolve_directory(this->m_name, leaf, &directory));
+            this->m_dirFirstCluster = directory;
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Follow a path of directories
+         *
+         * @param[in]   path[]      Absolute (beginning with '/') or relative path. Empty components and "." are
+         *                          ignored
+         * @param[in]   *end        Address immediately following the last character of the path to be followed
+         * @param[out]  *cluster    First cluster of the final directory in the path. Whether it is stored without
+         *                          a FAT chain is left in `FatFile::m_dirContiguousClusters`
+         *
+         * @return      Returns 0 upon success, error code otherwise. `INVALID_FILENAME` if a component does not fit
+         *              in a file name
+         */
+        PropWare::ErrorCode resolve_directory (const char path[], const char *end, uint32_t *cluster) const {
+            PropWare::ErrorCode err;
+            char                component[MAX_FILENAME_LENGTH];
+
+            if ('/' == path[0]) {
+                *cluster                      = this->m_fs->root_directory_cluster();
+                this->m_dirContiguousClusters = 0;
+            } else {
+                *cluster                      = this->m_fs->m_dir_firstCluster;
+                this->m_dirContiguousClusters = this->m_fs->m_dirContiguousClusters;
+            }
+
+            while (path < end) {
+                const char *next = path;
+                while (next < end && '/' != *next)
+                    ++next;
+
+                const size_t length = (size_t) (next - path);
+                if (MAX_FILENAME_LENGTH <= length)
+                    return INVALID_FILENAME;
+                else if (length && !(1 == length && '.' == path[0])) {
+                    memcpy(component, path, length);
+                    component[length] = 0;
+                    check_errors(this->find_subdirectory(*cluster, component, cluster));
+                }
+
+                path = next + 1;
+            }
+
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Find where a subdirectory begins, using the filesystem's path cache when possible
+         *
+         * @param[in]   parent      First cluster of the directory to be searched, whose length (if it has no FAT
+         *                          chain) must be in `FatFile::m_dirContiguousClusters`
+         * @param[in]   name[]      Name of the subdirectory, in upper case
+         * @param[out]  *cluster    First cluster of the subdirectory, whose length (if it has no FAT chain) is left in
+         *                          `FatFile::m_dirContiguousClusters`
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode find_subdirectory (const uint32_t parent, const char name[], uint32_t *cluster) const {
+            PropWare::ErrorCode err;
+            const uint32_t      root = this->m_fs->root_directory_cluster();
+
+            // The root directory has no ".." entry - it is its own parent
+            if (root == parent && !strcmp("..", name)) {
+                *cluster                      = root;
+                this->m_dirContiguousClusters = 0;
+                return NO_ERROR;
+            }
+
+            // Only directories with a FAT chain are cached
+            if (this->m_fs->find_cached_directory(parent, name, cluster)) {
+                this->m_dirContiguousClusters = 0;
+                return NO_ERROR;
+            }
+
+            uint16_t fileEntryOffset;
+            this->m_dirFirstCluster = parent;
+            if ((err = this->find(name, &fileEntryOffset)))
+                return FatFS::EOC_END == err ? FILENAME_NOT_FOUND : err;
+            if (!this->is_directory(fileEntryOffset))
+                return ENTRY_NOT_DIRECTORY;
+
+            // ".." entries refer to the root directory as cluster 0
+            *cluster = this->get_entry_cluster(fileEntryOffset);
+            if (0 == *cluster)
+                *cluster = root;
+
+            if (FatFS::EXFAT == this->m_fs->m_filesystem)
+                this->m_dirContiguousClusters = this->m_exFatEntry.contiguousClusters;
+            if (!this->m_dirContiguousClusters)
+                this->m_fs->cache_directory(parent, name, *cluster);
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   Read the first cluster of the entry at `fileEntryOffset` of the buffer (or, on an exFAT volume, of
+         *          the entry most recently found)
+         */
+        uint32_t get_entry_cluster (const uint16_t fileEntryOffset) const {
+            if (FatFS::EXFAT == this->m_fs->m_filesystem)
+                return this->m_exFatEntry.firstCluster;
+
+            uint32_t cluster = this->m_driver->get_short(fileEntryOffset + FILE_START_CLSTR_LOW, this->m_buf->buf);
+            if (FatFS::FAT_32 == this->m_fs->m_filesystem) {
+                const uint16_t highWord = this->m_driver->get_short(fileEntryOffset + FILE_START_CLSTR_HIGH,
+                                                                    this->m_buf->buf);
+                cluster |= highWord << 16;
+
+                // Clear the highest 4 bits - they are always reserved
+                cluster &= 0x0FFFFFFF;
+            }
+            return cluster;
         }
 
         const uint8_t get_file_attributes (uint16_t fileEntryOffset) const {
@@ -89,6 +368,8 @@ class FatFile : virtual public File {
         }
 
         const bool is_directory (uint16_t fileEntryOffset) const {
+            if (FatFS::EXFAT == this->m_fs->m_filesystem)
+                return this->m_exFatEntry.directory;
             return SUB_DIR & this->get_file_attributes(fileEntryOffset);
         }
 
@@ -96,53 +377,414 @@ class FatFile : virtual public File {
          * @brief       Find a file entry (file or sub-directory)
          *
          * Find a file or directory that matches the name in *filename in the
-         * current directory; its relative location is communicated by
-         * placing it in the address of *fileEntryOffset
+         * file's directory; its relative location is communicated by
+         * placing it in the address of *fileEntryOffset. A file matches if
+         * either its long (VFAT) name or its short name is equal to
+         * `filename`, ignoring case. If the file's directory is the current
+         * working directory and the filesystem has a directory index, it is
+         * used to skip straight to the file's entries. exFAT directories are
+         * never indexed (see `FatFile::scan_exfat_directory`).
          *
          * @param[out]  *fileEntryOffset    The buffer offset will be returned
          *                                  via this address if the file is
-         *                                  found
-         * @param[in]   *filename           C-string representing the short
-         *                                  (standard) filename
+         *                                  found. Otherwise, the offset of the
+         *                                  first unused entry is returned
+         * @param[in]   *filename           C-string representing the long or
+         *                                  short filename, in upper case
          *
          * @return      Returns 0 upon success, error code otherwise (common
-         *              error code is FatFS::EOC_END for end-of-chain or
-         *              file-not-found marker)
+         *              error codes are FatFile::FILENAME_NOT_FOUND when an
+         *              unused entry follows the last file, and FatFS::EOC_END
+         *              when the directory has no unused entries)
          */
         PropWare::ErrorCode find (const char *filename, uint16_t *fileEntryOffset) const {
             PropWare::ErrorCode err;
-            char                readEntryName[FILENAME_STR_LEN];
+            FatFS               *fs = this->m_fs;
 
-            *fileEntryOffset = 0;
+            if (FatFS::EXFAT == fs->m_filesystem) {
+                *fileEntryOffset = 0;
+                check_errors(this->reload_directory_start());
+                return this->scan_exfat_directory(filename, fileEntryOffset);
+            }
+
+            const bool          indexed = FatFS::INDEX_INVALID != fs->m_dirIndexState &&
+                    fs->m_dir_firstCluster == this->m_dirFirstCluster;
+
+            if (indexed) {
+                const uint16_t                  hash   = FatFS::hash_name(filename);
+                uint16_t                        probes = 0;
+                const FatFS::DirectoryIndexSlot *candidate;
+                while ((candidate = fs->next_index_candidate(hash, &probes))) {
+                    check_errors(this->load_directory_position(*candidate));
+                    *fileEntryOffset = (uint16_t) (candidate->entry * FILE_ENTRY_LENGTH);
+                    err = this->scan_directory(filename, fileEntryOffset, true);
+                    if (FILENAME_NOT_FOUND != err)
+                        return err;
+                }
+
+                // Every name is in the index, so this one does not exist. Leave the buffer at the end of the directory
+                // so that a new entry can be created there.
+                if (FatFS::INDEX_COMPLETE == fs->m_dirIndexState) {
+                    check_errors(this->load_directory_position(fs->m_dirIndexEnd));
+                    *fileEntryOffset = (uint16_t) (fs->m_dirIndexEnd.entry * FILE_ENTRY_LENGTH);
+                    return FILENAME_NOT_FOUND;
+                }
+            }
 
+            *fileEntryOffset = 0;
             check_errors(this->reload_directory_start());
+            return this->scan_directory(filename, fileEntryOffset, false);
+        }
+
+        /**
+         * @brief       Walk the directory, starting with the entry at `*fileEntryOffset` of the sector in the buffer,
+         *              until a file named `filename` is found
+         *
+         * When walking the whole directory and the filesystem's directory index needs to be rebuilt, the walk does not
+         * stop at the requested file but continues to the end of the directory, indexing every name along the way.
+         *
+         * @param[in]       filename[]          Long or short name of the file, in upper case
+         * @param[in,out]   *fileEntryOffset    Offset of the first entry to inspect. Upon success, offset of the
+         *                                      file's short name entry; otherwise, offset of the first unused entry
+         * @param[in]       firstFileOnly       Give up after inspecting the entries of a single file
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode scan_directory (const char filename[], uint16_t *fileEntryOffset,
+                                            const bool firstFileOnly) const {
+            PropWare::ErrorCode       err        = FILENAME_NOT_FOUND;
+            FatFS                     *fs        = this->m_fs;
+            const bool                buildIndex = !firstFileOnly && fs->m_dirIndexCapacity &&
+                    FatFS::INDEX_INVALID == fs->m_dirIndexState && fs->m_dir_firstCluster == this->m_dirFirstCluster;
+            char                      shortName[FILENAME_STR_LEN];
+            LongName                  longName;
+            FatFS::DirectoryIndexSlot entryStart = this->directory_position(*fileEntryOffset);
+            FatFS::DirectoryIndexSlot match;
+            uint16_t                  matchOffset = 0;
+            bool                      found       = false;
+
+            longName.nextOrdinal = 0;
+            longName.complete    = false;
+            longName.truncated   = false;
+            if (buildIndex)
+                fs->clear_directory_index();
 
-            // Loop through all entries in the current directory until we find the correct one
-            // Function will exit normally with FatFS::EOC_END error code if the file is not found
             while (this->m_buf->buf[*fileEntryOffset]) {
-                // Check if file is valid, retrieve the name if it is
-                if (!this->file_deleted(*fileEntryOffset)) {
-                    this->get_filename(&this->m_buf->buf[*fileEntryOffset], readEntryName);
-                    if (!strcmp(filename, readEntryName))
-                        // File names match, return 0 to indicate a successful search
-                        return 0;
+                const uint8_t *entry = &this->m_buf->buf[*fileEntryOffset];
+
+                if (DELETED_FILE_MARK == entry[0]) {
+                    longName.nextOrdinal = 0;
+                    longName.complete    = false;
+                } else if (LONG_NAME_ATTRIBUTES == entry[FILE_ATTRIBUTE_OFFSET]) {
+                    if (LAST_LONG_NAME_ENTRY & entry[0])
+                        entryStart = this->directory_position(*fileEntryOffset);
+                    this->read_long_name_entry(entry, &longName);
+                } else {
+                    this->get_filename(entry, shortName);
+                    const bool hasLongName = longName.complete && !longName.truncated &&
+                            short_name_checksum(entry) == longName.checksum;
+                    if (!hasLongName)
+                        entryStart = this->directory_position(*fileEntryOffset);
+
+                    if (buildIndex && !(VOLUME_ID & entry[FILE_ATTRIBUTE_OFFSET])) {
+                        fs->index_directory_entry(FatFS::hash_name(shortName), entryStart);
+                        if (hasLongName)
+                            fs->index_directory_entry(FatFS::hash_name(longName.name), entryStart);
+                    }
+
+                    if (!found && (!strcmp(filename, shortName) || (hasLongName && names_match(filename,
+                                                                                                longName.name)))) {
+                        found              = true;
+                        match              = this->directory_position(*fileEntryOffset);
+                        matchOffset        = *fileEntryOffset;
+                        this->m_entryStart = entryStart;
+                        if (!buildIndex)
+                            return NO_ERROR;
+                    } else if (firstFileOnly)
+                        return FILENAME_NOT_FOUND;
+
+                    longName.nextOrdinal = 0;
+                    longName.complete    = false;
                 }
 
                 // Increment to the next file
                 *fileEntryOffset += FILE_ENTRY_LENGTH;
 
-                // If it was the last entry in this sector, proceed to the next
-                // one
+                // If it was the last entry in this sector, proceed to the next one
                 if (this->m_driver->get_sector_size() == *fileEntryOffset) {
                     // Last entry in the sector, attempt to load a new sector
                     // Possible error value includes end-of-chain marker
-                    check_errors(this->load_next_sector(this->m_buf));
+                    if ((err = this->load_next_sector(this->m_buf)))
+                        break;
 
                     *fileEntryOffset = 0;
                 }
             }
 
-            return FatFile::FILENAME_NOT_FOUND;
+            if (buildIndex) {
+                if (err)
+                    // The directory has no unused entry to remember
+                    fs->m_dirIndexState = FatFS::INDEX_PARTIAL;
+                else
+                    fs->m_dirIndexEnd = this->directory_position(*fileEntryOffset);
+            }
+
+            if (found) {
+                check_errors(this->load_directory_position(match));
+                *fileEntryOffset = matchOffset;
+                return NO_ERROR;
+            } else if (err)
+                return err;
+            else
+                return FILENAME_NOT_FOUND;
+        }
+
+        /**
+         * @brief       Walk an exFAT directory, starting with the entry at `*fileEntryOffset` of the sector in the
+         *              buffer, until a file named `filename` is found
+         *
+         * exFAT describes each file with a set of consecutive entries: a file entry holding its attributes, a stream
+         * extension holding its location and length, and as many name entries as its name requires. The stream
+         * extension also carries a hash of the name, so most sets are rejected without comparing a single character.
+         *
+         * @param[in]       filename[]          Name of the file, in upper case
+         * @param[in,out]   *fileEntryOffset    Offset of the first entry to inspect. Upon success, offset of the last
+         *                                      entry of the file's set, with the file's details left in
+         *                                      `FatFile::m_exFatEntry`
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode scan_exfat_directory (const char filename[], uint16_t *fileEntryOffset) const {
+            PropWare::ErrorCode err;
+            const size_t        length       = strlen(filename);
+            const uint16_t      hash         = exfat_name_hash(filename);
+            const uint8_t       clusterShift = (uint8_t) (this->m_driver->get_sector_size_shift() +
+                    this->m_fs->m_tier1sPerTier2Shift);
+            uint8_t             remaining    = 0;  // Secondary entries of the current set that are yet to be read
+            size_t              position     = 0;  // Characters of the name compared so far
+            bool                matching     = false;
+
+            while (EXFAT_END_OF_DIRECTORY != this->m_buf->buf[*fileEntryOffset]) {
+                const uint8_t *entry = &this->m_buf->buf[*fileEntryOffset];
+                const uint8_t type   = entry[0];
+
+                if (EXFAT_FILE == type) {
+                    remaining = entry[EXFAT_SECONDARY_COUNT_OFFSET];
+                    matching  = false;
+                    this->m_exFatEntry.directory = SUB_DIR & entry[EXFAT_ATTRIBUTES_OFFSET];
+                } else if (remaining && (EXFAT_IN_USE | EXFAT_SECONDARY) == (type & (EXFAT_IN_USE | EXFAT_SECONDARY))) {
+                    --remaining;
+                    if (EXFAT_STREAM_EXTENSION == type) {
+                        position = 0;
+                        matching = length == entry[EXFAT_NAME_LENGTH_OFFSET]
+                                && hash == this->m_driver->get_short(EXFAT_NAME_HASH_OFFSET, entry);
+                        if (matching)
+                            this->read_stream_extension(entry, clusterShift);
+                    } else if (EXFAT_FILE_NAME == type && matching) {
+                        for (uint8_t i = 0; i < EXFAT_NAME_CHARS_PER_ENTRY && position < length; ++i, ++position) {
+                            uint16_t c = this->m_driver->get_short((uint16_t) (EXFAT_NAME_OFFSET + 2 * i), entry);
+                            if ('a' <= c && c <= 'z')
+                                c -= 'a' - 'A';
+                            if (c != (uint8_t) filename[position]) {
+                                matching = false;
+                                break;
+                            }
+                        }
+                    }
+
+                    if (!remaining && matching && position == length)
+                        return NO_ERROR;
+                } else
+                    // Deleted entries and every other kind of primary entry end the set
+                    remaining = 0;
+
+                // Increment to the next entry, loading the next sector when this one is finished
+                *fileEntryOffset += FILE_ENTRY_LENGTH;
+                if (this->m_driver->get_sector_size() == *fileEntryOffset) {
+                    check_errors(this->load_next_sector(this->m_buf));
+                    *fileEntryOffset = 0;
+                }
+            }
+
+            return FILENAME_NOT_FOUND;
+        }
+
+        /**
+         * @brief       Save the location and length of a file from its exFAT stream extension entry
+         *
+         * @param[in]   entry[]         First byte of the stream extension entry
+         * @param[in]   clusterShift    log2 of the number of bytes in a cluster
+         */
+        void read_stream_extension (const uint8_t entry[], const uint8_t clusterShift) const {
+            const uint32_t dataLow   = this->m_driver->get_long(EXFAT_DATA_LENGTH_OFFSET, entry);
+            const uint32_t dataHigh  = this->m_driver->get_long(EXFAT_DATA_LENGTH_OFFSET + 4, entry);
+            const uint32_t validLow  = this->m_driver->get_long(EXFAT_VALID_LENGTH_OFFSET, entry);
+            const uint32_t validHigh = this->m_driver->get_long(EXFAT_VALID_LENGTH_OFFSET + 4, entry);
+
+            this->m_exFatEntry.firstCluster = this->m_driver->get_long(EXFAT_FIRST_CLUSTER_OFFSET, entry);
+            this->m_exFatEntry.length       = validLow;
+            this->m_exFatEntry.oversized    = validHigh || (validLow & BIT_31);
+
+            if (EXFAT_NO_FAT_CHAIN & entry[EXFAT_FLAGS_OFFSET]) {
+                uint32_t clusters = (dataHigh << (32 - clusterShift)) | (dataLow >> clusterShift);
+                if (dataLow & ((1 << clusterShift) - 1))
+                    ++clusters;
+                this->m_exFatEntry.contiguousClusters = clusters;
+            } else
+                this->m_exFatEntry.contiguousClusters = 0;
+        }
+
+        /**
+         * @brief   Hash of a name, as stored in an exFAT stream extension entry
+         *
+         * @param[in]   name[]  Name in upper case, consisting of 7-bit ASCII characters only
+         */
+        static uint16_t exfat_name_hash (const char name[]) {
+            uint16_t hash = 0;
+            for (; *name; ++name) {
+                // Each character is hashed as two bytes of UTF-16, the second of which is 0 for ASCII
+                hash = (uint16_t) (((hash & 1) ? 0x8000 : 0) + (hash >> 1) + (uint8_t) *name);
+                hash = (uint16_t) (((hash & 1) ? 0x8000 : 0) + (hash >> 1));
+            }
+            return hash;
+        }
+
+        /**
+         * @brief       Describe the location of an entry within the directory sector currently in the buffer
+         */
+        FatFS::DirectoryIndexSlot directory_position (const uint16_t fileEntryOffset) const {
+            FatFS::DirectoryIndexSlot position;
+            position.tier2       = this->m_buf->meta->curTier2;
+            position.tier1Offset = (uint8_t) this->m_buf->meta->curTier1Offset;
+            position.entry       = (uint8_t) (fileEntryOffset / FILE_ENTRY_LENGTH);
+            position.hash        = 0;
+            return position;
+        }
+
+        /**
+         * @brief       Load the directory sector holding an entry into the buffer
+         *
+         * @param[in]   position    Location previously returned by `FatFile::directory_position`
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode load_directory_position (const FatFS::DirectoryIndexSlot &position) const {
+            PropWare::ErrorCode    err;
+            BlockStorage::MetaData *dirMeta = &this->m_fs->m_dirMeta;
+
+            if (this->holds_directory_sector(dirMeta) && dirMeta->curTier2 == position.tier2 &&
+                    dirMeta->curTier1Offset == position.tier1Offset)
+                return NO_ERROR;
+
+            check_errors(this->m_driver->flush(this->m_buf));
+            dirMeta->curTier2       = position.tier2;
+            dirMeta->curTier1Offset = position.tier1Offset;
+            if ((uint32_t) -1 == position.tier2)
+                // Root directory of a FAT16 volume
+                dirMeta->curTier2Addr = this->m_fs->m_rootAddr;
+            else {
+                dirMeta->curTier2Addr = this->m_fs->compute_tier1_from_tier2(position.tier2);
+                check_errors(this->load_next_tier2(dirMeta));
+            }
+
+            this->m_buf->meta      = dirMeta;
+            this->m_fs->m_dirOwner = this->m_buf;
+            return this->m_driver->reload_buffer(this->m_buf);
+        }
+
+        /**
+         * @brief       Add the characters of one long name directory entry to a long name being assembled
+         *
+         * Long names are stored in reverse order, with the last piece of the name in the first entry. Entries that
+         * are out of sequence or belong to a different short entry (according to their checksum) abandon the name.
+         * Characters outside of 7-bit ASCII are replaced with '?'.
+         *
+         * @param[in]       entry[]     First byte of the long name entry
+         * @param[in,out]   *longName   Long name being assembled
+         */
+        static void read_long_name_entry (const uint8_t entry[], LongName *longName) {
+            const uint8_t ordinal = (uint8_t) (entry[0] & LONG_NAME_ORDINAL_MASK);
+
+            if (LAST_LONG_NAME_ENTRY & entry[0]) {
+                longName->nextOrdinal = ordinal;
+                longName->checksum    = entry[LONG_NAME_CHECKSUM_OFFSET];
+                longName->truncated   = false;
+
+                // The name is not null-terminated if it fills the last entry exactly
+                const uint16_t length = (uint16_t) (ordinal * LONG_NAME_CHARS_PER_ENTRY);
+                longName->name[length < MAX_FILENAME_LENGTH ? length : MAX_FILENAME_LENGTH - 1] = 0;
+            }
+
+            if (0 == ordinal || ordinal != longName->nextOrdinal ||
+                    entry[LONG_NAME_CHECKSUM_OFFSET] != longName->checksum) {
+                longName->nextOrdinal = 0;
+                longName->complete    = false;
+                return;
+            }
+
+            uint16_t position = (uint16_t) ((ordinal - 1) * LONG_NAME_CHARS_PER_ENTRY);
+            for (uint8_t i = 0; i < LONG_NAME_CHARS_PER_ENTRY; ++i, ++position) {
+                const uint8_t  offset = long_name_char_offset(i);
+                const uint16_t c      = (uint16_t) (entry[offset] | (entry[offset + 1] << 8));
+                if (0xFFFF == c)
+                    // Padding after the null-terminator
+                    break;
+                else if (MAX_FILENAME_LENGTH <= position + 1) {
+                    if (c)
+                        longName->truncated = true;
+                    break;
+                } else if (0x80 <= c)
+                    longName->name[position] = '?';
+                else
+                    longName->name[position] = (char) c;
+
+                if (0 == c)
+                    break;
+            }
+
+            longName->complete = 1 == ordinal;
+            --longName->nextOrdinal;
+        }
+
+        /**
+         * @brief   Offset, within a long name entry, of the `index`th UCS-2 character of the entry
+         */
+        static uint8_t long_name_char_offset (const uint8_t index) {
+            if (5 > index)
+                return (uint8_t) (0x01 + 2 * index);
+            else if (11 > index)
+                return (uint8_t) (0x0E + 2 * (index - 5));
+            else
+                return (uint8_t) (0x1C + 2 * (index - 11));
+        }
+
+        /**
+         * @brief   Checksum of an 8.3 name, as stored in each long name entry belonging to it
+         *
+         * @param[in]   shortName[]     11 bytes of the short name, exactly as stored in the directory entry
+         */
+        static uint8_t short_name_checksum (const uint8_t shortName[]) {
+            uint8_t sum = 0;
+            for (uint8_t i = 0; i < FILE_NAME_LEN + FILE_EXTENSION_LEN; ++i)
+                sum = (uint8_t) (((sum & 1) << 7) + (sum >> 1) + shortName[i]);
+            return sum;
+        }
+
+        /**
+         * @brief   Compare two names, ignoring case
+         */
+        static bool names_match (const char lhs[], const char rhs[]) {
+            for (; *lhs && *rhs; ++lhs, ++rhs) {
+                char l = *lhs;
+                char r = *rhs;
+                if ('a' <= l && l <= 'z')
+                    l -= 'a' - 'A';
+                if ('a' <= r && r <= 'z')
+                    r -= 'a' - 'A';
+                if (l != r)
+                    return false;
+            }
+            return *lhs == *rhs;
         }
 
         /**
@@ -161,31 +803,29 @@ class FatFile : virtual public File {
             this->m_dirEntryMeta = *(this->m_buf->meta);
 
             // Determine the file's first cluster
-            if (FatFS::FAT_16 == this->m_fs->m_filesystem)
-                this->firstTier2 = this->m_driver->get_short(fileEntryOffset + FILE_START_CLSTR_LOW,
-                                                             this->m_buf->buf);
-            else {
-                this->firstTier2 = this->m_driver->get_short(fileEntryOffset + FILE_START_CLSTR_LOW,
-                                                             this->m_buf->buf);
-                const uint16_t highWord = this->m_driver->get_short(fileEntryOffset + FILE_START_CLSTR_HIGH,
-                                                                    this->m_buf->buf);
-                this->firstTier2 |= highWord << 16;
-
-                // Clear the highest 4 bits - they are always reserved
-                this->firstTier2 &= 0x0FFFFFFF;
-            }
+            this->firstTier2 = this->get_entry_cluster(fileEntryOffset);
 
             // Compute some stuffs for the file
+            this->m_curTier1      = 0;
             this->m_curTier2      = 0;
             this->fileEntryOffset = fileEntryOffset;
-            this->m_length        = this->m_driver->get_long(fileEntryOffset + FatFile::FILE_LEN_OFFSET,
-                                                             this->m_buf->buf);
+            if (FatFS::EXFAT == this->m_fs->m_filesystem) {
+                if (this->m_exFatEntry.oversized)
+                    return FILE_TOO_LARGE;
+                this->m_length             = this->m_exFatEntry.length;
+                this->m_contiguousClusters = this->m_exFatEntry.contiguousClusters;
+            } else {
+                this->m_length             = this->m_driver->get_long(fileEntryOffset + FatFile::FILE_LEN_OFFSET,
+                                                                      this->m_buf->buf);
+                this->m_contiguousClusters = 0;
+            }
 
             // Claim this buffer as our own
             this->m_contentMeta.curTier1Offset = 0;
             this->m_contentMeta.curTier2       = this->firstTier2;
             this->m_contentMeta.curTier2Addr   = this->m_fs->compute_tier1_from_tier2(this->firstTier2);
-            check_errors(this->m_fs->get_fat_value(this->m_contentMeta.curTier2, &(this->m_contentMeta.nextTier2)));
+            check_errors(this->load_next_tier2(&this->m_contentMeta));
+            this->reset_extents();
 
             // Finally, read the first sector
             this->m_buf->meta = &this->m_contentMeta;
@@ -251,32 +891,38 @@ class FatFile : virtual public File {
         PropWare::ErrorCode load_next_sector (BlockStorage::Buffer *buf) const {
             PropWare::ErrorCode err;
 
-            // Check for the end-of-chain marker (end of file)
-            if (this->m_fs->is_eoc(buf->meta->curTier2))
-                return FatFS::EOC_END;
-
-            // Are we looking at the root directory of a FAT16 system?
-            if (FatFS::FAT_16 == this->m_fs->m_filesystem && this->m_fs->m_rootAddr == (buf->meta->curTier2Addr)) {
+            // Are we looking at the root directory of a FAT12/16 system?
+            if (this->m_fs->has_fixed_root() && this->m_fs->m_rootAddr == (buf->meta->curTier2Addr)) {
                 // Root dir of FAT16; Is it the last sector in the root directory?
-                if (this->m_fs->m_rootDirSectors == buf->meta->curTier1Offset)
+                if (this->m_fs->m_rootDirSectors == buf->meta->curTier1Offset + 1)
                     return FatFS::EOC_END;
                     // Root dir of FAT16; Not last sector
                 else {
                     // Any error from reading the data block will be returned to calling function
                     check_errors(this->m_driver->flush(buf));
-                    return this->m_driver->read_data_block(++(buf->meta->curTier1Offset), buf->buf);
+                    ++(buf->meta->curTier1Offset);
+                    return this->m_driver->read_data_block(buf->meta->curTier2Addr + buf->meta->curTier1Offset,
+                                                           buf->buf);
                 }
             }
+            // Check for the end-of-chain marker (end of file)
+            else if (this->m_fs->is_eoc(buf->meta->curTier2))
+                return FatFS::EOC_END;
                 // We are looking at a generic data cluster.
             else {
                 // Generic data cluster; Have we reached the end of the cluster?
                 const unsigned int tier1sPerTier2 = (unsigned int) (1 << this->m_fs->get_tier1s_per_tier2_shift());
-                buf->meta->curTier1Offset++;
-                if (tier1sPerTier2 == buf->meta->curTier1Offset) {
+                if (tier1sPerTier2 == buf->meta->curTier1Offset + 1) {
+                    // Stay on the last sector when the chain ends here, so the caller is able to extend it
+                    if (this->m_fs->is_eoc(buf->meta->nextTier2))
+                        return FatFS::EOC_END;
                     return this->inc_cluster();
-                } else
+                } else {
+                    check_errors(this->m_driver->flush(buf));
+                    buf->meta->curTier1Offset++;
                     return this->m_driver->read_data_block(
                             buf->meta->curTier1Offset + buf->meta->curTier2Addr, buf->buf);
+                }
             }
         }
 
@@ -305,7 +951,7 @@ class FatFile : virtual public File {
             // Only look ahead to the next cluster if the current alloc unit is not EOC
             if (!this->m_fs->is_eoc(buf->meta->curTier2)) {
                 // Current cluster is not EOC, read the next one
-                check_errors(this->m_fs->get_fat_value(buf->meta->curTier2, &(buf->meta->nextTier2)));
+                check_errors(this->load_next_tier2(buf->meta));
             }
             buf->meta->curTier2Addr   = this->m_fs->compute_tier1_from_tier2(buf->meta->curTier2);
             buf->meta->curTier1Offset = 0;
@@ -313,11 +959,41 @@ class FatFile : virtual public File {
             return this->m_driver->read_data_block(buf->meta->curTier2Addr, buf->buf);
         }
 
+        /**
+         * @brief       Find the cluster following `meta->curTier2` and store it in `meta->nextTier2`
+         *
+         * The FAT is not read for exFAT files and directories stored without a FAT chain - their clusters simply
+         * follow one another until the end of the data.
+         *
+         * @param[in]   *meta   Metadata of either this file's content or the directory that holds it
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode load_next_tier2 (BlockStorage::MetaData *meta) const {
+            uint32_t firstCluster;
+            uint32_t contiguousClusters;
+            if (&this->m_contentMeta == meta) {
+                firstCluster       = this->firstTier2;
+                contiguousClusters = this->m_contiguousClusters;
+            } else {
+                firstCluster       = this->m_dirFirstCluster;
+                contiguousClusters = this->m_dirContiguousClusters;
+            }
+
+            if (contiguousClusters) {
+                if (meta->curTier2 + 1 - firstCluster < contiguousClusters)
+                    meta->nextTier2 = meta->curTier2 + 1;
+                else
+                    meta->nextTier2 = this->m_fs->m_codec->get_eoc();
+                return NO_ERROR;
+            } else
+                return this->m_fs->get_fat_value(meta->curTier2, &meta->nextTier2);
+        }
+
         const bool buffer_holds_directory_start () const {
-            const bool bufferIsDirectory = &this->m_fs->m_dirMeta == this->m_buf->meta;
+            const bool bufferIsDirectory = this->holds_directory_sector(&this->m_fs->m_dirMeta);
             const bool tier1AtStart      = 0 == this->m_fs->m_dirMeta.curTier1Offset;
-            const bool tier2AtStart      = this->m_fs->compute_tier1_from_tier2(this->m_fs->m_dir_firstCluster) ==
-                    this->m_fs->m_dirMeta.curTier2Addr;
+            const bool tier2AtStart      = this->m_dirFirstCluster == this->m_fs->m_dirMeta.curTier2;
 
             return bufferIsDirectory && tier1AtStart && tier2AtStart;
         }
@@ -330,18 +1006,43 @@ class FatFile : virtual public File {
                 BlockStorage::MetaData *dirMeta = &this->m_fs->m_dirMeta;
 
                 // Reset metadata to beginning of directory
-                dirMeta->curTier2Addr   = this->m_fs->compute_tier1_from_tier2(this->m_fs->m_dir_firstCluster);
+                dirMeta->curTier2Addr   = this->m_fs->directory_start_address(this->m_dirFirstCluster);
                 dirMeta->curTier1Offset = 0;
-                dirMeta->curTier2       = this->m_fs->m_dir_firstCluster;
-                check_errors(this->m_fs->get_fat_value(this->m_fsBufMeta->curTier2, &this->m_fsBufMeta->nextTier2));
+                dirMeta->curTier2       = this->m_dirFirstCluster;
+                if ((uint32_t) -1 != dirMeta->curTier2) {
+                    check_errors(this->load_next_tier2(dirMeta));
+                }
 
-                this->m_buf->meta = dirMeta;
+                this->m_buf->meta      = dirMeta;
+                this->m_fs->m_dirOwner = this->m_buf;
                 check_errors(this->m_driver->reload_buffer(this->m_buf));
             }
 
             return NO_ERROR;
         }
 
+        /**
+         * @brief       Determine whether the buffer holds an up-to-date copy of the directory sector described by
+         *              `meta`
+         *
+         * A directory sector is only trusted in the buffer that most recently loaded a directory sector. Any other
+         * buffer might hold a copy from before a file in another buffer changed the directory.
+         */
+        bool holds_directory_sector (const BlockStorage::MetaData *meta) const {
+            return meta == this->m_buf->meta && this->m_fs->m_dirOwner == this->m_buf;
+        }
+
+        /**
+         * @brief   Flush the buffer and disconnect it from this file's metadata, if it is still described by either
+         *          the file's content or its directory entry
+         */
+        void detach_buffer () {
+            if (&this->m_contentMeta == this->m_buf->meta || &this->m_dirEntryMeta == this->m_buf->meta) {
+                this->m_driver->flush(this->m_buf);
+                this->m_buf->meta = NULL;
+            }
+        }
+
         PropWare::ErrorCode load_sector_under_ptr () {
             PropWare::ErrorCode err;
 
@@ -350,12 +1051,8 @@ class FatFile : virtual public File {
 
             // If the buffer is being used by another file, flush it
             // We're not reloading yet because it could potentially lead to redundant reads
-            bool wrongData = false;
-            if (this->m_buf->meta != &this->m_contentMeta) {
-                check_errors(this->m_driver->flush(this->m_buf));
-                this->m_buf->meta = &this->m_contentMeta;
-                wrongData = true;
-            }
+            bool wrongData;
+            check_errors(this->claim_buffer(&wrongData));
 
             if (requiredSector != this->m_curTier1) {
                 check_errors(this->load_sector_from_offset(requiredSector, this->m_buf->meta));
@@ -370,6 +1067,33 @@ class FatFile : virtual public File {
             return NO_ERROR;
         }
 
+        /**
+         * @brief       Make sure the buffer is described by this file's content, flushing whatever another file left
+         *              in it (or, with a pool, moving to a buffer of our own)
+         *
+         * @param[out]  *claimed    Set when the buffer had to be taken from another file, in which case its contents
+         *                          are not yet this file's data
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode claim_buffer (bool *claimed) {
+            PropWare::ErrorCode err;
+
+            *claimed = false;
+            if (this->m_buf->meta != &this->m_contentMeta) {
+                check_errors(this->m_driver->flush(this->m_buf));
+                // Rather than evict the other file right back, move to a buffer of our own if the pool has one free
+                if (NULL != this->m_pool) {
+                    this->detach_buffer();
+                    this->m_buf = &this->m_pool->exchange(*this->m_buf);
+                }
+                this->m_buf->meta = &this->m_contentMeta;
+                *claimed = true;
+            }
+
+            return NO_ERROR;
+        }
+
         /**
          * @brief       Load a sector into the buffer independent of the current sector or cluster
          *
@@ -385,52 +1109,287 @@ class FatFile : virtual public File {
                                                      BlockStorage::MetaData *bufferMetadata) {
             PropWare::ErrorCode    err;
             const uint8_t          sectorsPerCluster = this->m_fs->m_tier1sPerTier2Shift;
-            unsigned int           requiredCluster   = requiredSector >> sectorsPerCluster;
 
             check_errors(this->m_driver->flush(this->m_buf));
 
             // Find the correct cluster
-            if (this->m_curTier2 < requiredCluster) {
-                // Desired cluster comes after the currently loaded one - this is easy and requires continuing to look
-                // forward through the FAT from the current position
-                do {
-                    bufferMetadata->curTier2 = bufferMetadata->nextTier2;
-                    check_errors(this->m_fs->get_fat_value(bufferMetadata->curTier2,
-                                                           &(bufferMetadata->nextTier2)));
-
-                    ++this->m_curTier2;
-                } while (this->m_curTier2 < requiredCluster);
+            check_errors(this->seek_tier2(requiredSector >> sectorsPerCluster, bufferMetadata));
+
+            // Followed by finding the correct sector
+            bufferMetadata->curTier1Offset = requiredSector & ((1 << sectorsPerCluster) - 1);
+            this->m_curTier1               = requiredSector;
+
+            check_errors(this->m_driver->read_data_block(
+                    bufferMetadata->curTier2Addr + bufferMetadata->curTier1Offset, this->m_buf->buf));
+
+            return 0;
+        }
+
+        /**
+         * @brief       Walk the FAT until `bufferMetadata` describes the requested cluster of the file. No data is
+         *              read or written.
+         *
+         * @param[in]   requiredCluster     Cluster, counting from the first cluster of the file
+         * @param[in]   *bufferMetadata     Metadata which will be updated to point at the required cluster
+         * @param[in]   extend              When set, the file will be enlarged if the chain ends before
+         *                                  `requiredCluster` is reached
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode seek_tier2 (unsigned int requiredCluster, BlockStorage::MetaData *bufferMetadata,
+                                        const bool extend = false) {
+            PropWare::ErrorCode err;
+
+            if (this->m_curTier2 == requiredCluster)
+                return NO_ERROR;
+
+            // Clusters of a file stored without a FAT chain can be found without walking anything
+            if (requiredCluster < this->m_contiguousClusters) {
+                this->m_curTier2             = requiredCluster;
+                bufferMetadata->curTier2     = this->firstTier2 + requiredCluster;
                 bufferMetadata->curTier2Addr = this->m_fs->compute_tier1_from_tier2(bufferMetadata->curTier2);
-            } else if (this->m_curTier2 > requiredCluster) {
+                return this->load_next_tier2(bufferMetadata);
+            }
+
+            // Jump as close to the desired cluster as the extent cache allows
+            if (this->m_extentCoverage) {
+                const uint32_t cachedCluster = requiredCluster < this->m_extentCoverage ? requiredCluster
+                                                                                        : this->m_extentCoverage - 1;
+                if (requiredCluster < this->m_curTier2 || this->m_curTier2 < cachedCluster) {
+                    check_errors(this->jump_to_cached_cluster(cachedCluster, bufferMetadata));
+                }
+            }
+
+            if (this->m_curTier2 > requiredCluster) {
                 // Desired cluster is an earlier cluster than the currently loaded one - this requires starting from
                 // the beginning and working forward
                 this->m_curTier2         = 0;
                 bufferMetadata->curTier2 = this->firstTier2;
-                check_errors(this->m_fs->get_fat_value(bufferMetadata->curTier2, &(bufferMetadata->nextTier2)));
-                while (requiredCluster--) {
-                    ++this->m_curTier2;
-                    bufferMetadata->curTier2 = bufferMetadata->nextTier2;
-                    check_errors(this->m_fs->get_fat_value(bufferMetadata->curTier2,
-                                                           &(bufferMetadata->nextTier2)));
+                check_errors(this->load_next_tier2(bufferMetadata));
+            }
+
+            // Desired cluster comes after the current one - continue looking forward through the FAT
+            while (this->m_curTier2 < requiredCluster) {
+                if (extend && this->m_fs->is_eoc(bufferMetadata->nextTier2)) {
+                    check_errors(this->m_fs->extend_fat(bufferMetadata));
                 }
-                bufferMetadata->curTier2Addr = this->m_fs->compute_tier1_from_tier2(bufferMetadata->curTier2);
+                bufferMetadata->curTier2 = bufferMetadata->nextTier2;
+                check_errors(this->load_next_tier2(bufferMetadata));
+
+                ++this->m_curTier2;
+                this->record_extent(this->m_curTier2, bufferMetadata->curTier2);
             }
+            bufferMetadata->curTier2Addr = this->m_fs->compute_tier1_from_tier2(bufferMetadata->curTier2);
 
-            // Followed by finding the correct sector
-            bufferMetadata->curTier1Offset = (uint8_t) (requiredSector % (1 << sectorsPerCluster));
-            this->m_curTier1               = requiredSector;
+            return NO_ERROR;
+        }
 
-            check_errors(this->m_driver->read_data_block(
-                    bufferMetadata->curTier2Addr + bufferMetadata->curTier1Offset, this->m_buf->buf));
+        /**
+         * @brief       Forget everything known about the cluster chain except for its first cluster
+         */
+        void reset_extents () {
+            this->m_extentCount    = 0;
+            this->m_extentCoverage = 0;
+            this->record_extent(0, this->firstTier2);
+        }
 
-            return 0;
+        /**
+         * @brief       Add a newly walked cluster to the extent cache
+         *
+         * Clusters are only recorded in order, so the cache always describes an unbroken prefix of the file
+         *
+         * @param[in]   fileCluster     Cluster number, counting from the first in the file
+         * @param[in]   diskCluster     Cluster on the storage device
+         */
+        void record_extent (const uint32_t fileCluster, const uint32_t diskCluster) {
+            if (fileCluster != this->m_extentCoverage)
+                return;
+
+            if (this->m_extentCount) {
+                Extent *last = &this->m_extents[this->m_extentCount - 1];
+                if (last->diskCluster + last->runLength == diskCluster) {
+                    ++last->runLength;
+                    ++this->m_extentCoverage;
+                    return;
+                }
+            }
+
+            if (this->m_extentCount < this->m_extentCapacity) {
+                Extent *next = &this->m_extents[this->m_extentCount++];
+                next->fileCluster = fileCluster;
+                next->diskCluster = diskCluster;
+                next->runLength   = 1;
+                ++this->m_extentCoverage;
+            }
+        }
+
+        /**
+         * @brief       Use the extent cache to position `bufferMetadata` at a cluster without walking the FAT
+         *
+         * @param[in]   fileCluster         Cluster, counting from the first in the file. Must be covered by the cache
+         * @param[in]   *bufferMetadata     Metadata which will be updated to point at the cluster
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode jump_to_cached_cluster (const uint32_t fileCluster,
+                                                    BlockStorage::MetaData *bufferMetadata) {
+            PropWare::ErrorCode err;
+
+            for (uint8_t i = 0; i < this->m_extentCount; ++i) {
+                const Extent *extent = &this->m_extents[i];
+                if (fileCluster < extent->fileCluster + extent->runLength) {
+                    const uint32_t offset = fileCluster - extent->fileCluster;
+                    bufferMetadata->curTier2 = extent->diskCluster + offset;
+
+                    // Only the last cluster in the cache requires a trip to the FAT to find its successor
+                    if (offset + 1 < extent->runLength)
+                        bufferMetadata->nextTier2 = bufferMetadata->curTier2 + 1;
+                    else if (i + 1 < this->m_extentCount)
+                        bufferMetadata->nextTier2 = this->m_extents[i + 1].diskCluster;
+                    else
+                        check_errors(this->load_next_tier2(bufferMetadata));
+
+                    this->m_curTier2 = fileCluster;
+                    return NO_ERROR;
+                }
+            }
+
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Move whole sectors directly between the storage device and `buf`, starting with the sector under
+         *              the file pointer
+         *
+         * The file's buffer is bypassed entirely. Each run of consecutive sectors within a cluster is transferred with
+         * a single call to `BlockStorage::read_data_blocks` or `BlockStorage::write_data_blocks`, so devices with
+         * native multi-block commands only pay command overhead once per cluster rather than once per sector.
+         *
+         * @param[in,out]   buf[]   Source or destination of the data - must be `count` sectors long
+         * @param[in]       count   Number of sectors to transfer
+         * @param[in]       write   Write `buf` to the file when set, otherwise read from the file into `buf`
+         *
+         * @pre         The file pointer must be aligned to a sector boundary, otherwise `UNALIGNED_POINTER` is
+         *              returned before the buffer or the device is touched
+         * @post        The file pointer is advanced by `count` sectors
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode transfer_sectors (uint8_t buf[], uint32_t count, const bool write) {
+            PropWare::ErrorCode err;
+            const uint8_t       sectorSizeShift     = this->m_driver->get_sector_size_shift();
+            const uint8_t       tier1sPerTier2Shift = this->m_fs->m_tier1sPerTier2Shift;
+            const uint32_t      tier1sPerTier2      = (uint32_t) (1 << tier1sPerTier2Shift);
+
+            if ((uint32_t) this->m_ptr & (this->m_driver->get_sector_size() - 1))
+                return UNALIGNED_POINTER;
+
+            // Any modified data in the buffer must reach the device before it is bypassed. The buffer's metadata is
+            // about to be moved, so the sector it holds is marked as unknown and will be reloaded on next access.
+            if (this->m_buf->meta == &this->m_contentMeta) {
+                check_errors(this->m_driver->flush(this->m_buf));
+            }
+            this->m_curTier1 = (uint32_t) -1;
+
+            uint32_t requiredSector = (uint32_t) this->m_ptr >> sectorSizeShift;
+            while (count) {
+                check_errors(this->seek_tier2(requiredSector >> tier1sPerTier2Shift, &this->m_contentMeta, write));
+
+                const uint32_t tier1Offset = requiredSector & (tier1sPerTier2 - 1);
+                uint32_t       run         = tier1sPerTier2 - tier1Offset;
+                if (run > count)
+                    run = count;
+
+                const uint32_t address = this->m_contentMeta.curTier2Addr + tier1Offset;
+                if (write) {
+                    check_errors(this->m_driver->write_data_blocks(address, run, buf));
+                } else {
+                    check_errors(this->m_driver->read_data_blocks(address, run, buf));
+                }
+                this->m_contentMeta.curTier1Offset = tier1Offset + run - 1;
+
+                buf += run << sectorSizeShift;
+                count -= run;
+                requiredSector += run;
+                this->m_ptr += run << sectorSizeShift;
+            }
+
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Read bytes starting at the file pointer directly into `buf`, bypassing the file's buffer
+         *
+         * The range is described to the device as a list of `BlockStorage::Segment`s, one per run of consecutive
+         * clusters, and handed over with `BlockStorage::read_data_segments`. Devices which read segments natively
+         * never copy a byte, even when the file pointer is not aligned to a sector.
+         *
+         * @param[out]  buf[]   Destination - must be at least `length` bytes long
+         * @param[in]   length  Number of bytes to read
+         *
+         * @post        The file pointer is advanced by `length` bytes and the file's buffer no longer holds a known
+         *              sector
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode read_segments (uint8_t buf[], size_t length) {
+            PropWare::ErrorCode   err;
+            BlockStorage::Segment segments[SEGMENTS_PER_READ];
+            uint8_t               used                = 0;
+            uint32_t              nextAddress         = 0;
+            bool                  claimed;
+            const uint16_t        sectorSize          = this->m_driver->get_sector_size();
+            const uint8_t         sectorSizeShift     = this->m_driver->get_sector_size_shift();
+            const uint8_t         tier1sPerTier2Shift = this->m_fs->m_tier1sPerTier2Shift;
+            const uint32_t        tier1sPerTier2      = (uint32_t) (1 << tier1sPerTier2Shift);
+
+            // The buffer is lent to the device as scratch space, so whatever it held is about to be lost
+            check_errors(this->claim_buffer(&claimed));
+            check_errors(this->m_driver->flush(this->m_buf));
+            this->m_curTier1 = (uint32_t) -1;
+
+            while (length) {
+                const uint32_t requiredSector = (uint32_t) this->m_ptr >> sectorSizeShift;
+                const uint16_t offset         = (uint16_t) (this->m_ptr & (sectorSize - 1));
+                check_errors(this->seek_tier2(requiredSector >> tier1sPerTier2Shift, &this->m_contentMeta, false));
+
+                const uint32_t tier1Offset = requiredSector & (tier1sPerTier2 - 1);
+                size_t         chunk       = ((tier1sPerTier2 - tier1Offset) << sectorSizeShift) - offset;
+                if (chunk > length)
+                    chunk = length;
+
+                // A run which continues on the next cluster of the disk is merged into the previous segment
+                const uint32_t address = this->m_contentMeta.curTier2Addr + tier1Offset;
+                if (used && address == nextAddress)
+                    segments[used - 1].length += chunk;
+                else {
+                    if (SEGMENTS_PER_READ == used) {
+                        check_errors(this->m_driver->read_data_segments(segments, used, this->m_buf->buf));
+                        used = 0;
+                    }
+                    segments[used].address = address;
+                    segments[used].offset  = offset;
+                    segments[used].length  = chunk;
+                    segments[used].buf     = buf;
+                    ++used;
+                }
+                this->m_contentMeta.curTier1Offset = tier1Offset + ((offset + chunk - 1) >> sectorSizeShift);
+                nextAddress = address + ((offset + chunk) >> sectorSizeShift);
+
+                buf += chunk;
+                length -= chunk;
+                this->m_ptr += chunk;
+            }
+
+            return this->m_driver->read_data_segments(segments, used, this->m_buf->buf);
         }
 
         PropWare::ErrorCode load_directory_sector () {
             PropWare::ErrorCode err;
-            if (this->m_buf->meta != &this->m_dirEntryMeta) {
+            if (!this->holds_directory_sector(&this->m_dirEntryMeta)) {
                 this->m_driver->flush(this->m_buf);
-                this->m_buf->meta = &this->m_dirEntryMeta;
+                this->m_buf->meta      = &this->m_dirEntryMeta;
+                this->m_fs->m_dirOwner = this->m_buf;
                 check_errors(this->m_driver->reload_buffer(this->m_buf));
             }
             return NO_ERROR;
@@ -504,11 +1463,15 @@ class FatFile : virtual public File {
             this->m_logger->printf("\tDirectory address (sector): 0x%08X/%u\n", this->m_dirTier1Addr,
                                    this->m_dirTier1Addr);
             this->m_logger->printf("\tFile entry offset: 0x%04X\n", this->fileEntryOffset);
+            this->m_logger->printf("\tDirectory cluster: 0x%08X\n", this->m_dirFirstCluster);
+            this->m_logger->printf("\tCached extents: %u/%u covering %u clusters\n", this->m_extentCount,
+                                   this->m_extentCapacity, this->m_extentCoverage);
 
         }
 
     protected:
-        static const uint8_t FILE_LEN_OFFSET = 0x1C;  // Length of a file in bytes
+        static const uint8_t FILE_LEN_OFFSET   = 0x1C;  // Length of a file in bytes
+        static const uint8_t SEGMENTS_PER_READ = 4;     // Discontiguous cluster runs handed to the device at once
 
         // File/directory values
         static const uint8_t FILE_ENTRY_LENGTH     = 32;  // An entry in a directory uses 32 bytes
@@ -519,6 +1482,35 @@ class FatFile : virtual public File {
         static const uint8_t FILE_ATTRIBUTE_OFFSET = 0x0B;  // Byte of a file entry to store attribute flags
         static const uint8_t FILE_START_CLSTR_LOW  = 0x1A;  // Starting cluster number
         static const uint8_t FILE_START_CLSTR_HIGH = 0x14;  // High 16-bits of the starting cluster number (FAT32 only)
+        static const uint8_t NT_CASE_OFFSET        = 0x0C;  // Flags for displaying a short name in lower case
+        static const uint8_t NT_LOWER_CASE_BASE    = BIT_3;
+        static const uint8_t NT_LOWER_CASE_EXT     = BIT_4;
+
+        // Long (VFAT) file names
+        static const uint8_t LONG_NAME_ATTRIBUTES      = 0x0F;  // Attribute byte that marks a long name entry
+        static const uint8_t LAST_LONG_NAME_ENTRY      = BIT_6;  // Set in the ordinal of the first entry on disk
+        static const uint8_t LONG_NAME_ORDINAL_MASK    = 0x1F;
+        static const uint8_t LONG_NAME_CHECKSUM_OFFSET = 0x0D;
+        static const uint8_t LONG_NAME_CHARS_PER_ENTRY = 13;
+
+        // exFAT entry sets
+        static const uint8_t EXFAT_END_OF_DIRECTORY       = 0x00;
+        static const uint8_t EXFAT_IN_USE                 = BIT_7;  // Entry type bit; clear for a deleted entry
+        static const uint8_t EXFAT_SECONDARY              = BIT_6;  // Entry type bit; clear for a primary entry
+        static const uint8_t EXFAT_FILE                   = 0x85;
+        static const uint8_t EXFAT_STREAM_EXTENSION       = 0xC0;
+        static const uint8_t EXFAT_FILE_NAME              = 0xC1;
+        static const uint8_t EXFAT_SECONDARY_COUNT_OFFSET = 0x01;  // File entry
+        static const uint8_t EXFAT_ATTRIBUTES_OFFSET      = 0x04;  // File entry; same bits as a FAT entry's attributes
+        static const uint8_t EXFAT_FLAGS_OFFSET           = 0x01;  // Stream extension
+        static const uint8_t EXFAT_NO_FAT_CHAIN           = BIT_1;
+        static const uint8_t EXFAT_NAME_LENGTH_OFFSET     = 0x03;  // Stream extension
+        static const uint8_t EXFAT_NAME_HASH_OFFSET       = 0x04;  // Stream extension
+        static const uint8_t EXFAT_VALID_LENGTH_OFFSET    = 0x08;  // Stream extension
+        static const uint8_t EXFAT_FIRST_CLUSTER_OFFSET   = 0x14;  // Stream extension
+        static const uint8_t EXFAT_DATA_LENGTH_OFFSET     = 0x18;  // Stream extension
+        static const uint8_t EXFAT_NAME_OFFSET            = 0x02;  // File name entry
+        static const uint8_t EXFAT_NAME_CHARS_PER_ENTRY   = 15;
 
         // File attributes (definitions with trailing underscore represent character for a cleared attribute flag)
         static const uint8_t READ_ONLY         = BIT_0;
@@ -541,7 +1533,9 @@ class FatFile : virtual public File {
         static const char    ARCHIVE_CHAR_     = '.';
 
     protected:
-        FatFS    *m_fs;
+        FatFS      *m_fs;
+        /** Pool that the buffer was acquired from, if any */
+        BufferPool *m_pool;
         /** File's starting cluster */
         uint32_t firstTier2;
         /** like curTier1Offset, but does not reset upon loading a new cluster */
@@ -552,6 +1546,24 @@ class FatFile : virtual public File {
         uint32_t m_dirTier1Addr;
         /** Address within the sector of this file's entry */
         uint16_t fileEntryOffset;
+        /** Optional cache of the cluster chain's layout */
+        Extent   *m_extents;
+        /** Number of elements available in `m_extents` */
+        uint8_t  m_extentCapacity;
+        /** Number of elements of `m_extents` in use */
+        uint8_t  m_extentCount;
+        /** Number of clusters, counting from the first in the file, described by `m_extents` */
+        uint32_t m_extentCoverage;
+        /** Number of clusters in an exFAT file stored without a FAT chain, otherwise 0 */
+        uint32_t m_contiguousClusters;
+        /** Location of the file's first directory entry - its long name, if it has one */
+        mutable FatFS::DirectoryIndexSlot m_entryStart;
+        /** First cluster of the directory holding the file */
+        mutable uint32_t                  m_dirFirstCluster;
+        /** Number of clusters in the directory holding the file if it has no FAT chain (exFAT only), otherwise 0 */
+        mutable uint32_t                  m_dirContiguousClusters;
+        /** Details of the exFAT entry set most recently found by `FatFile::scan_exfat_directory` */
+        mutable ExFatEntry                m_exFatEntry;
 };
 
 }
@@ -75,6 +75,8 @@ extern BlockStorage::Buffer SHARED_BUFFER;
  * }
  * @endcode
  *
+ * Files that are streamed from beginning to end (such as audio) can be given a second buffer with
+ * `FatFileReader::set_read_ahead` so that the next sector is fetched while the current one is being consumed.
  */
 class FatFileReader : virtual public FatFile, virtual public FileReader {
     public:
@@ -82,9 +84,8 @@ class FatFileReader : virtual public FatFile, virtual public FileReader {
          * @brief       Construct a new file instance
          *
          * @param[in]   fs          The filesystem is needed for opening the file
-         * @param[in]   name        Name of the file to open - it must exist in the current working directory (see
-         *                          [issue 55](https://github.com/parallaxinc/PropWare/issues/55) for opening from a
-         *                          relative or absolute path)
+         * @param[in]   name        Name of the file to open - a path relative to the current working directory
+         *                          (see `FatFS::chdir`) or, when it begins with '/', relative to the root directory
          * @param[in]   *buffer     Address of a dedicated buffer that should be used for this file. If left as the
          *                          NULL (the default), a shared buffer will be used.
          * @param[in]   logger      This is only used for printing debug statements. Use of the logger is limited
@@ -94,15 +95,71 @@ class FatFileReader : virtual public FatFile, virtual public FileReader {
                        const Printer &logger = pwOut)
                 : File(fs, name, buffer, logger),
                   FatFile(fs, name, buffer, logger),
-                  FileReader(fs, name, buffer, logger) {
+                  FileReader(fs, name, buffer, logger),
+                  m_readAhead(NULL),
+                  m_readAheadSector((uint32_t) -1),
+                  m_readAheadPending(false) {
+        }
+
+        /**
+         * @brief       Construct a new file instance which uses a buffer from a pool for as long as it exists
+         *
+         * @param[in]   fs          The filesystem is needed for opening the file
+         * @param[in]   name        Name of the file to open
+         * @param[in]   pool        Pool from which the file's buffer is acquired
+         * @param[in]   logger      This is only used for printing debug statements. Use of the logger is limited
+         *                          such that all references will be optimized out in normal application code
+         */
+        FatFileReader (FatFS &fs, const char name[], BufferPool &pool, const Printer &logger = pwOut)
+                : File(fs, name, pool.acquire(), logger),
+                  FatFile(fs, name, *this->m_buf, logger, &pool),
+                  FileReader(fs, name, *this->m_buf, logger),
+                  m_readAhead(NULL),
+                  m_readAheadSector((uint32_t) -1),
+                  m_readAheadPending(false) {
+        }
+
+        /**
+         * @brief   Any sector still being read ahead is waited for, so that the device is done with the read-ahead
+         *          buffer
+         */
+        virtual ~FatFileReader () {
+            this->finish_read_ahead();
+        }
+
+        /**
+         * @brief       Provide a second buffer, so that the sector following the one being read is fetched before it
+         *              is needed
+         *
+         * Once the file has moved from one sector to the next, each new sector that is loaded triggers a read of the
+         * one after it into `buffer` via `BlockStorage::start_read_ahead`; seeking elsewhere stops the read-ahead
+         * until sequential access resumes. With a device that transfers in the background, such as
+         * `PropWare::AsyncSD` (which must have at least two mailboxes), the next sector is already in memory when
+         * `FatFileReader::get_char` or `FatFileReader::read` reaches it, so a stream of small reads no longer stalls
+         * at every sector boundary. Other devices read the sector immediately; the data is still served from
+         * `buffer`, but the time spent waiting for the device is unchanged.
+         *
+         * @param[in]   buffer[]    Array of at least one sector, or NULL to disable read-ahead. It must not be
+         *                          modified for as long as it is in use by this file.
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode set_read_ahead (uint8_t buffer[]) {
+            const PropWare::ErrorCode err = this->finish_read_ahead();
+            this->m_readAhead       = buffer;
+            this->m_readAheadSector = (uint32_t) -1;
+            return err;
         }
 
         PropWare::ErrorCode open () {
             PropWare::ErrorCode err;
             uint16_t            fileEntryOffset = 0;
 
+            this->finish_read_ahead();
+            this->m_readAheadSector = (uint32_t) -1;
+
             // Attempt to find the file
-            if ((err = this->find(this->get_name(), &fileEntryOffset)))
+            if ((err = this->locate(&fileEntryOffset)))
                 // Find returned an error; ensure it was EOC...
                 return FatFS::EOC_END == err ? FatFile::FILENAME_NOT_FOUND : err;
 
@@ -112,11 +169,17 @@ class FatFileReader : virtual public FatFile, virtual public FileReader {
             return NO_ERROR;
         }
 
+        PropWare::ErrorCode close () {
+            this->finish_read_ahead();
+            this->m_readAheadSector = (uint32_t) -1;
+            return this->File::close();
+        }
+
         PropWare::ErrorCode safe_get_char (char &c) {
             PropWare::ErrorCode err;
 
             if (this->m_open) {
-                check_errors(this->load_sector_under_ptr());
+                check_errors(this->load_sector_reading_ahead());
 
                 // Get the character
                 const uint16_t bufferOffset = (uint16_t) (this->m_ptr % this->m_driver->get_sector_size());
@@ -130,6 +193,245 @@ class FatFileReader : virtual public FatFile, virtual public FileReader {
                 return FILE_NOT_OPEN;
             }
         }
+
+        /**
+         * @brief       Read a block of bytes from the file
+         *
+         * Everything up to the last sector boundary in the range is read directly into `dst` with
+         * `BlockStorage::read_data_segments`, whatever the alignment of the file pointer. The exception is a first
+         * sector that is already loaded, either in the file's buffer or in the read-ahead buffer: its bytes are copied
+         * out of the file's buffer instead. That copy and the final partial sector take a single `memcpy` each,
+         * leaving the last sector loaded for the next read.
+         *
+         * @see         PropWare::FileReader::read
+         */
+        PropWare::ErrorCode read (uint8_t dst[], const size_t n, size_t *bytesRead = NULL) {
+            PropWare::ErrorCode err;
+            size_t              ignored;
+            size_t              &done = NULL == bytesRead ? ignored : *bytesRead;
+
+            done = 0;
+            if (!this->m_open)
+                return FILE_NOT_OPEN;
+
+            const uint16_t sectorSize      = this->m_driver->get_sector_size();
+            const uint8_t  sectorSizeShift = this->m_driver->get_sector_size_shift();
+            const size_t   available       = (size_t) (this->m_length - this->m_ptr);
+            const size_t   total           = n < available ? n : available;
+
+            while (done < total) {
+                const uint16_t bufferOffset = (uint16_t) (this->m_ptr & (sectorSize - 1));
+                const size_t   remaining    = total - done;
+                const uint32_t lastBoundary = ((uint32_t) this->m_ptr + remaining) & ~((uint32_t) sectorSize - 1);
+                const uint32_t sector       = (uint32_t) this->m_ptr >> sectorSizeShift;
+                // A sector that has been read ahead is taken from the read-ahead buffer rather than read again
+                const bool     loaded       = (&this->m_contentMeta == this->m_buf->meta && sector == this->m_curTier1)
+                        || sector == this->m_readAheadSector;
+
+                if (!loaded && lastBoundary > (uint32_t) this->m_ptr) {
+                    const size_t direct = lastBoundary - (uint32_t) this->m_ptr;
+                    // The device must be done with the read-ahead before it is given another request. A failed
+                    // read-ahead only means that the sector is read again when needed
+                    this->finish_read_ahead();
+                    check_errors(this->read_segments(&dst[done], direct));
+                    done += direct;
+                } else {
+                    check_errors(this->load_sector_reading_ahead());
+
+                    size_t chunk = sectorSize - bufferOffset;
+                    if (chunk > remaining)
+                        chunk = remaining;
+                    memcpy(&dst[done], &this->m_buf->buf[bufferOffset], chunk);
+                    this->m_ptr += chunk;
+                    done += chunk;
+                }
+            }
+
+            return total < n ? EOF_ERROR : NO_ERROR;
+        }
+
+        /**
+         * @brief       Read whole sectors straight into the caller's memory, bypassing the file's buffer
+         *
+         * Consecutive sectors within a cluster are fetched with a single multi-block read, which is far faster than
+         * reading the same data one character at a time.
+         *
+         * @param[out]  buf[]   Destination - must be at least `count` sectors long
+         * @param[in]   count   Number of sectors to read
+         *
+         * @pre         The file pointer must be aligned to a sector boundary (see `File::seek`), otherwise
+         *              `FatFile::UNALIGNED_POINTER` is returned and nothing is read
+         * @post        The file pointer is advanced by `count` sectors, but never past the end of the file. Bytes of
+         *              the final sector beyond the end of the file are undefined.
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode read_sectors (uint8_t buf[], const uint32_t count) {
+            PropWare::ErrorCode err;
+
+            if (!this->m_open)
+                return FILE_NOT_OPEN;
+            else if (0 == count)
+                return NO_ERROR;
+
+            const uint32_t lastSectorStart = (uint32_t) this->m_ptr +
+                    ((count - 1) << this->m_driver->get_sector_size_shift());
+            if (lastSectorStart >= (uint32_t) this->m_length)
+                return EOF_ERROR;
+
+            this->finish_read_ahead();
+            check_errors(this->transfer_sectors(buf, count, false));
+
+            if (this->m_ptr > this->m_length)
+                this->m_ptr = this->m_length;
+            return NO_ERROR;
+        }
+
+    protected:
+        /**
+         * @brief   Load the sector under the file pointer, taking it from the read-ahead buffer when possible and
+         *          starting the read of the following sector when access is sequential
+         *
+         * @return  Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode load_sector_reading_ahead () {
+            PropWare::ErrorCode err;
+
+            if (NULL == this->m_readAhead)
+                return this->load_sector_under_ptr();
+
+            const uint32_t requiredSector = (uint32_t) this->m_ptr >> this->m_driver->get_sector_size_shift();
+            if (requiredSector == this->m_curTier1 && &this->m_contentMeta == this->m_buf->meta)
+                return NO_ERROR;
+
+            const bool sequential = requiredSector == this->m_curTier1 + 1;
+            if (requiredSector == this->m_readAheadSector) {
+                check_errors(this->use_read_ahead());
+                return this->start_read_ahead();
+            } else {
+                check_errors(this->load_sector_under_ptr());
+                return sequential ? this->start_read_ahead() : NO_ERROR;
+            }
+        }
+
+        /**
+         * @brief   Begin reading the sector that follows the one in the file's buffer into the read-ahead buffer
+         *
+         * Nothing is read beyond the end of the file. An error from the device only means that the sector will be
+         * read again when it is needed, so it is not reported.
+         *
+         * @pre     The file's buffer holds sector `m_curTier1`, described by `m_contentMeta`
+         *
+         * @return  Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode start_read_ahead () {
+            PropWare::ErrorCode err;
+
+            const uint32_t sector = this->m_curTier1 + 1;
+            if (sector == this->m_readAheadSector)
+                return NO_ERROR;
+            else if ((sector << this->m_driver->get_sector_size_shift()) >= (uint32_t) this->m_length)
+                return NO_ERROR;
+
+            check_errors(this->finish_read_ahead());
+            this->m_readAheadSector = (uint32_t) -1;
+
+            const uint32_t tier1Offset = sector & ((1 << this->m_fs->get_tier1s_per_tier2_shift()) - 1);
+            uint32_t       fileTier2   = this->m_curTier2;
+            uint32_t       tier2       = this->m_contentMeta.curTier2;
+            if (0 == tier1Offset) {
+                if (this->m_fs->is_eoc(this->m_contentMeta.nextTier2))
+                    return NO_ERROR;
+                ++fileTier2;
+                tier2 = this->m_contentMeta.nextTier2;
+            }
+
+            const uint32_t address = this->m_fs->compute_tier1_from_tier2(tier2) + tier1Offset;
+            if (NO_ERROR == this->m_driver->start_read_ahead(address, this->m_readAhead)) {
+                this->m_readAheadSector    = sector;
+                this->m_readAheadTier2     = tier2;
+                this->m_readAheadFileTier2 = fileTier2;
+                this->m_readAheadPending   = true;
+            }
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   Wait for the device to finish with the read-ahead buffer, if a read is outstanding
+         *
+         * @return  Returns 0 upon success, error code otherwise. Upon error, the read-ahead buffer is discarded.
+         */
+        PropWare::ErrorCode finish_read_ahead () {
+            if (!this->m_readAheadPending)
+                return NO_ERROR;
+
+            this->m_readAheadPending = false;
+            const PropWare::ErrorCode err = this->m_driver->wait_for_read_ahead(this->m_readAhead);
+            if (err)
+                this->m_readAheadSector = (uint32_t) -1;
+            return err;
+        }
+
+        /**
+         * @brief   Move the sector in the read-ahead buffer into the file's buffer and update the file's position to
+         *          match
+         *
+         * If the read-ahead failed, the sector is read directly instead.
+         *
+         * @return  Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode use_read_ahead () {
+            PropWare::ErrorCode err;
+            bool                claimed;
+
+            if (this->finish_read_ahead())
+                return this->load_sector_under_ptr();
+
+            check_errors(this->claim_buffer(&claimed));
+            memcpy(this->m_buf->buf, this->m_readAhead, this->m_driver->get_sector_size());
+
+            const uint32_t tier1sPerTier2 = (uint32_t) (1 << this->m_fs->get_tier1s_per_tier2_shift());
+            this->m_contentMeta.curTier1Offset = this->m_readAheadSector & (tier1sPerTier2 - 1);
+            if (this->m_readAheadTier2 != this->m_contentMeta.curTier2) {
+                this->m_contentMeta.curTier2     = this->m_readAheadTier2;
+                this->m_contentMeta.curTier2Addr = this->m_fs->compute_tier1_from_tier2(this->m_readAheadTier2);
+                this->m_curTier2                 = this->m_readAheadFileTier2;
+                check_errors(this->load_next_tier2(&this->m_contentMeta));
+                this->record_extent(this->m_curTier2, this->m_readAheadTier2);
+            }
+            this->m_curTier1        = this->m_readAheadSector;
+            this->m_readAheadSector = (uint32_t) -1;
+
+            return NO_ERROR;
+        }
+
+    protected:
+        /** Optional second buffer, filled with the sector following the one in the file's buffer */
+        uint8_t  *m_readAhead;
+        /** Sector of the file (counting from its start) held in, or being read into, `m_readAhead`; -1 if none */
+        uint32_t m_readAheadSector;
+        /** Cluster on the storage device holding `m_readAheadSector` */
+        uint32_t m_readAheadTier2;
+        /** Cluster holding `m_readAheadSector`, counting from the first in the file */
+        uint32_t m_readAheadFileTier2;
+        /** Set while the device may still be writing to `m_readAhead` */
+        bool     m_readAheadPending;
 };
 
+inline PropWare::ErrorCode FatFS::chdir (const char path[], BlockStorage::Buffer &buffer) {
+    PropWare::ErrorCode err;
+    uint32_t            directory;
+
+    // A path that is too long would be left empty by the reader, which means the current directory
+    if (File::MAX_FILENAME_LENGTH <= strlen(path))
+        return File::INVALID_FILENAME;
+
+    const FatFileReader reader(*this, path, buffer);
+    const char          *name = reader.get_name();
+    check_errors(reader.resolve_directory(name, name + strlen(name), &directory));
+
+    this->set_current_directory(directory, reader.m_dirContiguousClusters);
+    return NO_ERROR;
+}
+
 }
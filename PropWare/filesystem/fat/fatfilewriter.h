@@ -36,6 +36,7 @@ extern BlockStorage::Buffer SHARED_BUFFER;
  * @brief   Concrete class for writing or modifying a FAT 16/32 file
  */
 class FatFileWriter : public virtual FatFile, public virtual FileWriter {
+        friend class FatFS;
 
     public:
         /**
@@ -52,7 +53,34 @@ class FatFileWriter : public virtual FatFile, public virtual FileWriter {
                        const Printer &logger = pwOut)
                 : File(fs, name, buffer, logger),
                   FatFile(fs, name, buffer, logger),
-                  FileWriter(fs, name, buffer, logger) {
+                  FileWriter(fs, name, buffer, logger),
+                  m_preallocated(false),
+                  m_journaled(false),
+                  m_committedLength(0),
+                  m_writeBehind(NULL),
+                  m_writeBehindPending(false) {
+            this->set_long_name(name);
+        }
+
+        /**
+         * @brief   Construct a file which uses a buffer from a pool for as long as it exists
+         *
+         * @param[in]   fs          A mounted FAT 16/32 filesystem
+         * @param[in]   name[]      Character array with the file name
+         * @param[in]   pool        Pool from which the file's buffer is acquired
+         * @param[in]   logger      This is only used for printing debug statements. Use of the logger is limited
+         *                          such that all references will be optimized out in normal application code
+         */
+        FatFileWriter (FatFS &fs, const char name[], BufferPool &pool, const Printer &logger = pwOut)
+                : File(fs, name, pool.acquire(), logger),
+                  FatFile(fs, name, *this->m_buf, logger, &pool),
+                  FileWriter(fs, name, *this->m_buf, logger),
+                  m_preallocated(false),
+                  m_journaled(false),
+                  m_committedLength(0),
+                  m_writeBehind(NULL),
+                  m_writeBehindPending(false) {
+            this->set_long_name(name);
         }
 
         /**
@@ -62,16 +90,30 @@ class FatFileWriter : public virtual FatFile, public virtual FileWriter {
             this->close();
         }
 
+        /**
+         * @brief   Open the file, creating it if it does not exist
+         *
+         * A new file is given only a short (8.3) directory entry if its name fits one - lower case is preserved, as
+         * long as the base name and the extension are each entirely upper or entirely lower case. Any other name is
+         * stored as a long (VFAT) name, along with a unique short alias such as `LOGFIL~1.CSV` for use by systems
+         * that do not understand long names.
+         *
+         * exFAT volumes are read-only, and opening a file on one fails with `FatFS::READ_ONLY_FILESYSTEM`.
+         */
         PropWare::ErrorCode open () {
             PropWare::ErrorCode err;
             uint16_t            fileEntryOffset = 0;
 
-            if ((err = this->find(this->get_name(), &fileEntryOffset))) {
+            if (FatFS::EXFAT == this->m_fs->m_filesystem)
+                return FatFS::READ_ONLY_FILESYSTEM;
+
+            // A missing parent directory is an error, but a missing file is created
+            check_errors(this->resolve_parent());
+            if ((err = this->find(leaf_name(this->m_name), &fileEntryOffset))) {
                 switch (err) {
                     case FatFS::EOC_END:
-                        check_errors(this->m_fs->extend_current_directory());
                     case FatFile::FILENAME_NOT_FOUND:
-                        check_errors(this->create_new_file(fileEntryOffset));
+                        check_errors(this->create_new_file(&fileEntryOffset));
                         break;
                     default:
                         return err;
@@ -83,6 +125,156 @@ class FatFileWriter : public virtual FatFile, public virtual FileWriter {
             return NO_ERROR;
         }
 
+        /**
+         * @brief       Provide a second buffer, so that each completed sector is written to the storage device while
+         *              the next one is being filled
+         *
+         * Without a second buffer, `FatFileWriter::safe_put_char` and `FatFileWriter::write` stall for an entire
+         * sector write every time a sector is filled. With one, the finished sector is copied into `buffer` and
+         * handed to `BlockStorage::start_write_behind`. The caller only waits if it fills the next sector before
+         * that write is done, and a new sector at the end of the file is not read from the device before it is
+         * filled. With a device that transfers in the background, such as `PropWare::AsyncSD` (which must have at
+         * least two mailboxes), a producer writing at a steady rate therefore never stalls at a sector boundary.
+         * Other devices write the sector immediately, so there is no gain in speed.
+         *
+         * An error from a sector written behind is returned by the next call that waits for it: the next sector
+         * boundary, `FatFileWriter::flush`, or `FatFileWriter::close`.
+         *
+         * @param[in]   buffer[]    Array of at least one sector, or NULL to write every sector in the foreground.
+         *                          It must remain valid for as long as the file is using it.
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode set_write_behind (uint8_t buffer[]) {
+            const PropWare::ErrorCode err = this->finish_write_behind();
+            this->m_writeBehind = buffer;
+            return err;
+        }
+
+        /**
+         * @brief       Open the file for appending, protected by the filesystem's journal
+         *
+         * Ordinarily, every `FatFileWriter::flush` has to write the file's data, both copies of the FAT and then the
+         * file's directory entry, and losing power part way through leaves the file with the wrong length or with
+         * clusters that belong to nothing. A journaled file instead only writes its data, any modified FAT sector
+         * and a single commit record at each `FatFileWriter::commit` (or `FatFileWriter::flush`); the directory entry
+         * is not updated until the file is closed. If power is lost before then, the next `FatFS::mount` returns the
+         * file to the length of its last commit and frees any clusters appended after it, so commits can be made
+         * as rarely as the application can afford to lose data.
+         *
+         * The file position starts at the end of the file. Data written before the end of the last commit is
+         * written in place, without protection.
+         *
+         * @pre         Only one file at a time can be journaled, and the volume must have a spare reserved sector for
+         *              the commit record (FAT32 volumes normally do; FAT16 volumes normally do not)
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode open_journaled () {
+            PropWare::ErrorCode err;
+
+            if (!this->m_fs->m_journalAddr)
+                return FatFS::JOURNAL_UNAVAILABLE;
+            else if (this->m_fs->m_journalInUse)
+                return FatFS::JOURNAL_BUSY;
+
+            check_errors(this->open());
+            this->m_ptr                = this->m_length;
+            this->m_journaled          = true;
+            this->m_committedLength    = -1;
+            this->m_fs->m_journalInUse = true;
+            return this->commit();
+        }
+
+        /**
+         * @brief   Make everything written so far durable. For a journaled file, this writes the commit record
+         *          instead of the directory entry; otherwise, it is the same as `FatFileWriter::flush`
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode commit () {
+            PropWare::ErrorCode err;
+
+            if (!this->m_journaled)
+                return this->flush();
+
+            check_errors(this->finish_write_behind());
+            if (this->m_buf->meta == &this->m_contentMeta) {
+                check_errors(this->m_driver->flush(this->m_buf));
+            }
+
+            // The FAT is made durable before the record that relies on it
+            if (this->m_committedLength != this->m_length) {
+                check_errors(this->write_journal(FatFS::JOURNAL_OPEN));
+                this->m_committedLength = this->m_length;
+            }
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   Release any clusters reserved by `FatFileWriter::preallocate` but not filled, then close the file
+         */
+        PropWare::ErrorCode close () {
+            PropWare::ErrorCode err;
+
+            if (this->m_open && this->m_journaled) {
+                check_errors(this->commit());
+            }
+            if (this->m_open && this->m_preallocated) {
+                check_errors(this->flush());
+                check_errors(this->release_unused_clusters());
+            }
+            if (this->m_open && this->m_journaled) {
+                // Bring the directory entry up to date, after which the journal has nothing left to recover
+                this->m_journaled = false;
+                check_errors(this->flush());
+                check_errors(this->write_journal(FatFS::JOURNAL_CLOSED));
+                this->m_fs->m_journalInUse = false;
+            }
+            return this->File::close();
+        }
+
+        /**
+         * @brief       Reserve space for the file in a single contiguous run of clusters
+         *
+         * Growing a file one cluster at a time interleaves FAT updates with data writes and scatters the file across
+         * the volume. Reserving the space up front finds one contiguous run in a single pass of the FAT (falling back
+         * to individual clusters only if the volume is too fragmented), after which writes simply stream into the
+         * reserved sectors. The file's length is not changed; any clusters that are still unused when the file is
+         * closed are returned to the filesystem.
+         *
+         * @param[in]   bytes   Total number of bytes the file should be able to hold without further allocation
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode preallocate (const uint32_t bytes) {
+            PropWare::ErrorCode err;
+
+            if (!this->m_open)
+                return FILE_NOT_OPEN;
+
+            // Walk to the end of the chain, starting from wherever the file currently is
+            uint32_t tail          = this->m_contentMeta.curTier2;
+            uint32_t next          = this->m_contentMeta.nextTier2;
+            uint32_t clustersOwned = this->m_curTier2 + 1;
+            while (!this->m_fs->is_eoc(next)) {
+                tail = next;
+                check_errors(this->m_fs->get_fat_value(tail, &next));
+                ++clustersOwned;
+            }
+
+            const uint32_t clustersNeeded = this->m_fs->clusters_for(bytes);
+            if (clustersNeeded > clustersOwned) {
+                uint32_t first;
+                check_errors(this->m_fs->extend_fat_by(tail, clustersNeeded - clustersOwned, &first));
+                if (this->m_contentMeta.curTier2 == tail)
+                    this->m_contentMeta.nextTier2 = first;
+                this->m_preallocated = true;
+            }
+
+            return NO_ERROR;
+        }
+
         /**
          * @brief   Mark a file as delete and free its clusters in the FAT. File content will not be cleared unless
          *          overwritten by another file. File does not have to be opened prior to deleting
@@ -93,7 +285,7 @@ class FatFileWriter : public virtual FatFile, public virtual FileWriter {
             // If the file hasn't been opened yet, open it
             if (0 == this->m_dirTier1Addr) {
                 uint16_t fileEntryOffset = 0;
-                if ((err = this->find(this->m_name, &fileEntryOffset))) {
+                if ((err = this->locate(&fileEntryOffset))) {
                     if (FatFS::EOC_END == err)
                         return FatFile::FILENAME_NOT_FOUND;
                     else
@@ -103,10 +295,13 @@ class FatFileWriter : public virtual FatFile, public virtual FileWriter {
                 }
             }
 
+            check_errors(this->remove_long_name());
             check_errors(this->load_directory_sector());
 
             this->m_buf->buf[this->fileEntryOffset] = DELETED_FILE_MARK;
             this->m_buf->meta->mod = true;
+            check_errors(this->m_driver->flush(this->m_buf));
+            this->m_fs->invalidate_directory_index();
 
             check_errors(this->m_fs->clear_chain(this->firstTier2));
 
@@ -118,7 +313,11 @@ class FatFileWriter : public virtual FatFile, public virtual FileWriter {
         PropWare::ErrorCode flush () {
             PropWare::ErrorCode err;
 
+            if (this->m_journaled)
+                return this->commit();
+
             // Flush the file contents
+            check_errors(this->finish_write_behind());
             if (this->m_buf->meta == &this->m_contentMeta) {
                 check_errors(this->m_driver->flush(this->m_buf));
             }
@@ -147,7 +346,7 @@ class FatFileWriter : public virtual FatFile, public virtual FileWriter {
                     check_errors(this->m_fs->extend_fat(&this->m_contentMeta));
                 }
 
-                check_errors(this->load_sector_under_ptr());
+                check_errors(this->load_sector_for_writing());
 
                 // Get the character
                 const uint16_t bufferOffset = (uint16_t) (this->m_ptr % this->m_driver->get_sector_size());
@@ -169,6 +368,86 @@ class FatFileWriter : public virtual FatFile, public virtual FileWriter {
             }
         }
 
+        /**
+         * @brief       Write a block of bytes to the file
+         *
+         * Partial sectors are copied into the file's buffer in a single `memcpy` each, while any whole,
+         * sector-aligned span in the middle is written directly from `src` (see `FatFileWriter::write_sectors`).
+         *
+         * @see         PropWare::FileWriter::write
+         */
+        PropWare::ErrorCode write (const uint8_t src[], const size_t n) {
+            PropWare::ErrorCode err;
+
+            if (!this->m_open)
+                return FILE_NOT_OPEN;
+
+            const uint16_t sectorSize      = this->m_driver->get_sector_size();
+            const uint8_t  sectorSizeShift = this->m_driver->get_sector_size_shift();
+
+            size_t done = 0;
+            while (done < n) {
+                const uint16_t bufferOffset = (uint16_t) (this->m_ptr & (sectorSize - 1));
+                const size_t   remaining    = n - done;
+
+                if (0 == bufferOffset && sectorSize <= remaining) {
+                    const uint32_t sectors = remaining >> sectorSizeShift;
+                    check_errors(this->write_sectors(&src[done], sectors));
+                    done += sectors << sectorSizeShift;
+                } else {
+                    if (this->need_to_extend_fat()) {
+                        check_errors(this->m_fs->extend_fat(&this->m_contentMeta));
+                    }
+                    check_errors(this->load_sector_for_writing());
+
+                    size_t chunk = sectorSize - bufferOffset;
+                    if (chunk > remaining)
+                        chunk = remaining;
+                    memcpy(&this->m_buf->buf[bufferOffset], &src[done], chunk);
+                    this->m_buf->meta->mod = true;
+                    this->m_ptr += chunk;
+                    done += chunk;
+
+                    if (this->m_ptr > this->m_length) {
+                        this->m_length               = this->m_ptr;
+                        this->m_fileMetadataModified = true;
+                    }
+                }
+            }
+
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Write whole sectors straight from the caller's memory, bypassing the file's buffer
+         *
+         * Consecutive sectors within a cluster are sent with a single multi-block write, and the file is extended as
+         * needed.
+         *
+         * @param[in]   buf[]   Data to be written - must be at least `count` sectors long
+         * @param[in]   count   Number of sectors to write
+         *
+         * @pre         The file pointer must be aligned to a sector boundary (see `File::seek`), otherwise
+         *              `FatFile::UNALIGNED_POINTER` is returned and nothing is written
+         * @post        The file pointer is advanced by `count` sectors
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode write_sectors (const uint8_t buf[], const uint32_t count) {
+            PropWare::ErrorCode err;
+
+            if (!this->m_open)
+                return FILE_NOT_OPEN;
+
+            check_errors(this->transfer_sectors((uint8_t *) buf, count, true));
+
+            if (this->m_ptr > this->m_length) {
+                this->m_length               = this->m_ptr;
+                this->m_fileMetadataModified = true;
+            }
+            return NO_ERROR;
+        }
+
         void print_status (const bool printBlocks = false) const {
             this->File::print_status("FatFileWriter", printBlocks);
             this->FatFile::print_status(printBlocks, false);
@@ -176,8 +455,46 @@ class FatFileWriter : public virtual FatFile, public virtual FileWriter {
         }
 
     protected:
-        static inline bool not_period_or_end (const char c) {
-            return '.' != c && c;
+        /**
+         * @brief   Keep the final component of the path exactly as the user gave it, for the long name entries
+         */
+        void set_long_name (const char name[]) {
+            if (MAX_FILENAME_LENGTH > strlen(name))
+                strcpy(this->m_longName, leaf_name(name));
+            else
+                // The path was rejected by FatFile as well, so the file can never be opened
+                this->m_longName[0] = 0;
+        }
+
+        /**
+         * @brief   Record the file's current length in the journal (see `FatFS::write_journal`)
+         */
+        PropWare::ErrorCode write_journal (const uint32_t state) {
+            const uint32_t dirSector = this->m_dirEntryMeta.curTier2Addr + this->m_dirEntryMeta.curTier1Offset;
+            return this->m_fs->write_journal(state, dirSector, this->fileEntryOffset, this->firstTier2,
+                                             (uint32_t) this->m_length);
+        }
+
+        /**
+         * @brief   Truncate the cluster chain to the length of the file, freeing any reserved clusters
+         */
+        PropWare::ErrorCode release_unused_clusters () {
+            PropWare::ErrorCode err;
+
+            const uint32_t clustersUsed = this->m_fs->clusters_for((uint32_t) this->m_length);
+            check_errors(this->m_fs->truncate_chain(this->firstTier2, clustersUsed));
+
+            // The file's cached cluster may have been released, so rewind to the start of the chain
+            this->m_curTier2                   = 0;
+            this->m_curTier1                   = (uint32_t) -1;
+            this->m_contentMeta.curTier2       = this->firstTier2;
+            this->m_contentMeta.curTier2Addr   = this->m_fs->compute_tier1_from_tier2(this->firstTier2);
+            this->m_contentMeta.curTier1Offset = 0;
+            check_errors(this->m_fs->get_fat_value(this->firstTier2, &this->m_contentMeta.nextTier2));
+            this->reset_extents();
+            this->m_preallocated = false;
+
+            return NO_ERROR;
         }
 
         bool need_to_extend_fat () {
@@ -193,90 +510,458 @@ class FatFileWriter : public virtual FatFile, public virtual FileWriter {
         }
 
     protected:
+        /**
+         * @brief   Load the sector under the file pointer in preparation for modifying it, writing the previous sector
+         *          behind when a second buffer is available (see `FatFileWriter::set_write_behind`)
+         *
+         * @pre     The file's cluster chain must already reach the file pointer
+         *
+         * @return  0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode load_sector_for_writing () {
+            PropWare::ErrorCode err;
+            bool                claimed;
+
+            if (NULL == this->m_writeBehind)
+                return this->load_sector_under_ptr();
+
+            const uint8_t  sectorSizeShift = this->m_driver->get_sector_size_shift();
+            const uint32_t requiredSector  = (uint32_t) this->m_ptr >> sectorSizeShift;
+            if (&this->m_contentMeta == this->m_buf->meta) {
+                if (requiredSector == this->m_curTier1)
+                    return NO_ERROR;
+                else if (this->m_contentMeta.mod) {
+                    check_errors(this->start_write_behind());
+                }
+            }
 
-        PropWare::ErrorCode create_new_file (const uint16_t fileEntryOffset) {
+            // A sector beyond the end of the file holds nothing worth reading - and reading it would mean waiting
+            // for the sector that was just handed off
+            if ((requiredSector << sectorSizeShift) < (uint32_t) this->m_length)
+                return this->load_sector_under_ptr();
+
+            check_errors(this->claim_buffer(&claimed));
+            const uint8_t tier1sPerTier2Shift = this->m_fs->m_tier1sPerTier2Shift;
+            check_errors(this->seek_tier2(requiredSector >> tier1sPerTier2Shift, &this->m_contentMeta));
+            this->m_contentMeta.curTier1Offset = requiredSector & ((1 << tier1sPerTier2Shift) - 1);
+            this->m_curTier1                   = requiredSector;
+            memset(this->m_buf->buf, 0, this->m_driver->get_sector_size());
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   Copy the modified sector in the file's buffer to the write-behind buffer and start writing it,
+         *          first waiting for the previous sector if it is still being written
+         *
+         * @return  0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode start_write_behind () {
             PropWare::ErrorCode err;
 
-            // Write the file fields in order...
+            check_errors(this->finish_write_behind());
+            memcpy(this->m_writeBehind, this->m_buf->buf, this->m_driver->get_sector_size());
+
+            const uint32_t address = this->m_contentMeta.curTier2Addr + this->m_contentMeta.curTier1Offset;
+            check_errors(this->m_driver->start_write_behind(address, this->m_writeBehind));
+            this->m_writeBehindPending = true;
+            this->m_contentMeta.mod    = false;
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   Wait for the device to finish with the write-behind buffer, if a write is outstanding
+         *
+         * @return  0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode finish_write_behind () {
+            if (!this->m_writeBehindPending)
+                return NO_ERROR;
 
-            /* 1) Short file name */
-            check_errors(this->write_filename(fileEntryOffset));
+            this->m_writeBehindPending = false;
+            return this->m_driver->wait_for_write_behind(this->m_writeBehind);
+        }
+
+        /**
+         * @brief       Create the directory entries for a new file
+         *
+         * @param[in,out]   *fileEntryOffset    Offset of the first unused entry in the directory sector held by the
+         *                                      buffer, or the sector size if the directory has no unused entries.
+         *                                      Upon return, offset of the new file's short name entry
+         * @param[in]       attributes          Attribute flags of the new entry
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode create_new_file (uint16_t *fileEntryOffset, const uint8_t attributes = ARCHIVE) {
+            PropWare::ErrorCode err;
+            uint8_t             shortName[FILE_NAME_LEN + FILE_EXTENSION_LEN];
+            uint8_t             caseFlags       = 0;
+            uint8_t             longNameEntries = 0;
+
+            /* 1) Short file name, and a long name if the short one can not represent the file's name */
+            if (!this->fits_short_name(this->m_longName, shortName, &caseFlags)) {
+                const size_t length = strlen(this->m_longName);
+                longNameEntries = (uint8_t) ((length + LONG_NAME_CHARS_PER_ENTRY - 1) / LONG_NAME_CHARS_PER_ENTRY);
+                // Searching for a unique alias leaves the buffer at the end of the directory again
+                check_errors(this->make_unique_alias(shortName, fileEntryOffset));
+            }
+
+            if (this->m_driver->get_sector_size() == *fileEntryOffset) {
+                check_errors(this->next_directory_entry(fileEntryOffset));
+            }
+            this->m_entryStart = this->directory_position(*fileEntryOffset);
+
+            const uint8_t checksum = short_name_checksum(shortName);
+            for (uint8_t ordinal = longNameEntries; ordinal; --ordinal) {
+                this->write_long_name_entry(*fileEntryOffset, ordinal, longNameEntries == ordinal, checksum);
+                check_errors(this->next_directory_entry(fileEntryOffset));
+            }
+
+            uint8_t *entry = &this->m_buf->buf[*fileEntryOffset];
+            memset(entry, 0, FILE_ENTRY_LENGTH);
+            memcpy(entry, shortName, sizeof(shortName));
+            entry[NT_CASE_OFFSET] = caseFlags;
 
             /* 2) Write attribute field... */
-            // TODO: Allow for file attribute flags to be set, such as READ_ONLY, SUB_DIR, etc
-            // Archive flag should be set because the file is new
-            this->m_buf->buf[fileEntryOffset + FILE_ATTRIBUTE_OFFSET] = ARCHIVE;
+            entry[FILE_ATTRIBUTE_OFFSET] = attributes;
 
-            /* 3) Find a spot in the FAT (do not check for a full FAT, assume space is available) */
-            this->get_fat_location(fileEntryOffset);
+            /* 3) Find a spot in the FAT, and make sure the FAT reaches the disk before the entry that refers to it */
+            check_errors(this->get_fat_location(*fileEntryOffset));
+            check_errors(this->m_fs->flush_fat());
 
             /* 4) Write the size of the file (currently 0) */
-            this->m_driver->write_long(fileEntryOffset + FILE_LEN_OFFSET, this->m_buf->buf, 0);
+            this->m_driver->write_long(*fileEntryOffset + FILE_LEN_OFFSET, this->m_buf->buf, 0);
 
             this->m_buf->meta->mod = true;
+            this->m_fs->invalidate_directory_index();
             return NO_ERROR;
         }
 
-        inline PropWare::ErrorCode write_filename (const uint16_t fileEntryOffset) {
+        /**
+         * @brief       Create this path as a new directory, holding only the "." and ".." entries
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode create_directory () {
             PropWare::ErrorCode err;
-            uint8_t             i;
+            uint16_t            fileEntryOffset;
+
+            if (FatFS::EXFAT == this->m_fs->m_filesystem)
+                return FatFS::READ_ONLY_FILESYSTEM;
+
+            check_errors(this->resolve_parent());
+            err = this->find(leaf_name(this->m_name), &fileEntryOffset);
+            if (NO_ERROR == err)
+                return ENTRY_EXISTS;
+            else if (FatFile::FILENAME_NOT_FOUND != err && FatFS::EOC_END != err)
+                return err;
+
+            check_errors(this->create_new_file(&fileEntryOffset, SUB_DIR));
+            const uint32_t cluster = this->get_entry_cluster(fileEntryOffset);
+            check_errors(this->m_driver->flush(this->m_buf));
+
+            // The buffer is about to be filled with the new directory, which no metadata describes
+            this->m_buf->meta = NULL;
+            uint8_t *buf = this->m_buf->buf;
+            memset(buf, 0, this->m_driver->get_sector_size());
+
+            // ".." refers to the root directory as cluster 0
+            const bool     parentIsRoot = this->m_fs->root_directory_cluster() == this->m_dirFirstCluster;
+            const uint32_t parent       = parentIsRoot ? 0 : this->m_dirFirstCluster;
+            this->write_dot_entry(0, 1, cluster);
+            this->write_dot_entry(FILE_ENTRY_LENGTH, 2, parent);
+
+            const uint32_t firstSector    = this->m_fs->compute_tier1_from_tier2(cluster);
+            const uint32_t tier1sPerTier2 = (uint32_t) (1 << this->m_fs->m_tier1sPerTier2Shift);
+            check_errors(this->m_driver->write_data_block(firstSector, buf));
+            memset(buf, 0, 2 * FILE_ENTRY_LENGTH);
+            for (uint32_t i = 1; i < tier1sPerTier2; ++i) {
+                check_errors(this->m_driver->write_data_block(firstSector + i, buf));
+            }
 
-            // Insert the base
-            for (i = 0; not_period_or_end(this->m_name[i]); ++i)
-                this->m_buf->buf[fileEntryOffset + i] = (uint8_t) this->m_name[i];
+            return NO_ERROR;
+        }
 
-            // Check if there is an extension
-            if (this->m_name[i]) {
-                check_errors(this->write_filename_extension(fileEntryOffset, i));
-            } else
-                this->pad_with_spaces(fileEntryOffset, i);
+        /**
+         * @brief       Fill in the "." or ".." entry of a new directory
+         *
+         * @param[in]   fileEntryOffset     Offset of the entry within the buffer
+         * @param[in]   dots                Number of periods in the name
+         * @param[in]   cluster             Cluster that the entry refers to
+         */
+        void write_dot_entry (const uint16_t fileEntryOffset, const uint8_t dots, const uint32_t cluster) {
+            uint8_t *entry = &this->m_buf->buf[fileEntryOffset];
+            memset(entry, ' ', FILE_NAME_LEN + FILE_EXTENSION_LEN);
+            memset(entry, '.', dots);
+            entry[FILE_ATTRIBUTE_OFFSET] = SUB_DIR;
+            this->m_driver->write_short(fileEntryOffset + FILE_START_CLSTR_LOW, this->m_buf->buf, (uint16_t) cluster);
+            if (FatFS::FAT_32 == this->m_fs->get_fs_type())
+                this->m_driver->write_short(fileEntryOffset + FILE_START_CLSTR_HIGH, this->m_buf->buf,
+                                            (uint16_t) (cluster >> 16));
+        }
 
+        /**
+         * @brief       Move to the next entry of the directory, extending the directory if it is full
+         *
+         * @param[in,out]   *fileEntryOffset    Offset of the current entry within the buffer
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode next_directory_entry (uint16_t *fileEntryOffset) {
+            PropWare::ErrorCode err;
+
+            *fileEntryOffset += FILE_ENTRY_LENGTH;
+            if (this->m_driver->get_sector_size() <= *fileEntryOffset) {
+                err = this->load_next_sector(this->m_buf);
+                if (FatFS::EOC_END == err) {
+                    check_errors(this->m_fs->extend_current_directory(this->m_buf));
+                } else if (err)
+                    return err;
+                *fileEntryOffset = 0;
+            }
             return NO_ERROR;
         }
 
-        inline PropWare::ErrorCode write_filename_extension (const uint16_t fileEntryOffset, uint8_t &i) {
-            uint8_t j;
+        /**
+         * @brief       Fill in one of the long name entries for this file
+         *
+         * @param[in]   fileEntryOffset     Offset of the entry within the buffer
+         * @param[in]   ordinal             Position of the entry's piece of the name, starting with 1
+         * @param[in]   last                Set for the entry holding the end of the name (the first one on disk)
+         * @param[in]   checksum            Checksum of the file's short name
+         */
+        void write_long_name_entry (const uint16_t fileEntryOffset, const uint8_t ordinal, const bool last,
+                                    const uint8_t checksum) {
+            uint8_t      *entry = &this->m_buf->buf[fileEntryOffset];
+            const size_t length = strlen(this->m_longName);
+
+            memset(entry, 0, FILE_ENTRY_LENGTH);
+            entry[0]                         = (uint8_t) (last ? (ordinal | LAST_LONG_NAME_ENTRY) : ordinal);
+            entry[FILE_ATTRIBUTE_OFFSET]     = LONG_NAME_ATTRIBUTES;
+            entry[LONG_NAME_CHECKSUM_OFFSET] = checksum;
+
+            size_t position = (ordinal - 1) * LONG_NAME_CHARS_PER_ENTRY;
+            for (uint8_t i = 0; i < LONG_NAME_CHARS_PER_ENTRY; ++i, ++position) {
+                uint16_t c;
+                if (position < length)
+                    c = (uint8_t) this->m_longName[position];
+                else if (position == length)
+                    c = 0;
+                else
+                    c = 0xFFFF;
+                this->m_driver->write_short(long_name_char_offset(i), entry, c);
+            }
+            this->m_buf->meta->mod = true;
+        }
+
+        /**
+         * @brief       Mark this file's long name entries as deleted
+         *
+         * @pre         The file's directory entries must have been found or created
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode remove_long_name () {
+            PropWare::ErrorCode err;
+
+            uint16_t offset = (uint16_t) (this->m_entryStart.entry * FILE_ENTRY_LENGTH);
+            if (this->m_entryStart.tier2 == this->m_dirEntryMeta.curTier2 &&
+                    this->m_entryStart.tier1Offset == this->m_dirEntryMeta.curTier1Offset &&
+                    this->fileEntryOffset == offset)
+                return NO_ERROR;
+
+            check_errors(this->load_directory_position(this->m_entryStart));
 
-            // There might be an extension - pad first name with spaces
-            for (j = i; j < FILE_NAME_LEN; ++j)
-                this->m_buf->buf[fileEntryOffset + j] = ' ';
+            // Long name entries immediately precede the short entry, so stop upon reaching it
+            const uint32_t shortEntrySector = this->m_dirEntryMeta.curTier2Addr + this->m_dirEntryMeta.curTier1Offset;
+            while (LONG_NAME_ATTRIBUTES == this->m_buf->buf[offset + FILE_ATTRIBUTE_OFFSET]) {
+                if (shortEntrySector == this->m_buf->meta->curTier2Addr + this->m_buf->meta->curTier1Offset &&
+                        this->fileEntryOffset == offset)
+                    break;
 
-            // Check if there is a period, as one would expect for a file name with an extension
-            if ('.' == this->m_name[i]) {
-                // Skip the period
-                ++i;
+                this->m_buf->buf[offset] = DELETED_FILE_MARK;
+                this->m_buf->meta->mod   = true;
+                check_errors(this->next_directory_entry(&offset));
+            }
+
+            return NO_ERROR;
+        }
 
-                // Insert extension
-                while (this->m_name[i]) {
-                    this->m_buf->buf[fileEntryOffset + j] = (uint8_t) this->m_name[i];
-                    ++i;
-                    ++j;
+        /**
+         * @brief       Determine whether a name can be stored in a short (8.3) directory entry without loss
+         *
+         * @param[in]   name[]          The name, as given by the user
+         * @param[out]  shortName[]     11 bytes, receiving the base name and extension as stored on disk. If the name
+         *                              does not fit, the basis for a short alias is stored here instead
+         * @param[out]  *caseFlags      Flags to store in the entry so that lower case names are displayed correctly
+         *
+         * @return      True if `name` fits a short entry
+         */
+        static bool fits_short_name (const char name[], uint8_t shortName[], uint8_t *caseFlags) {
+            const char *extension = strrchr(name, '.');
+            const char *baseEnd   = NULL == extension ? name + strlen(name) : extension;
+            if (NULL != extension)
+                ++extension;
+
+            // Build the basis name: upper case, invalid characters replaced, spaces and extra periods removed
+            memset(shortName, ' ', FILE_NAME_LEN + FILE_EXTENSION_LEN);
+            bool    lossless = name != baseEnd && '.' != name[0];
+            uint8_t i        = 0;
+            for (const char *c = name; c < baseEnd; ++c) {
+                if (' ' == *c || '.' == *c)
+                    lossless = false;
+                else if (FILE_NAME_LEN == i)
+                    lossless = false;
+                else if (!to_short_name_char(*c, &shortName[i++]))
+                    lossless = false;
+            }
+            i = FILE_NAME_LEN;
+            if (NULL != extension) {
+                if (!*extension)
+                    lossless = false;
+                for (const char *c = extension; *c; ++c) {
+                    if (' ' == *c)
+                        lossless = false;
+                    else if (FILE_NAME_LEN + FILE_EXTENSION_LEN == i)
+                        lossless = false;
+                    else if (!to_short_name_char(*c, &shortName[i++]))
+                        lossless = false;
                 }
+            }
+
+            // Mixed case within either part can only be preserved by a long name
+            const uint8_t baseCase      = letter_case(name, baseEnd);
+            const uint8_t extensionCase = NULL == extension ? 0 : letter_case(extension, extension + strlen(extension));
+            if (MIXED_CASE == baseCase || MIXED_CASE == extensionCase)
+                lossless = false;
+            if (lossless)
+                *caseFlags = (uint8_t) ((LOWER_CASE == baseCase ? NT_LOWER_CASE_BASE : 0) |
+                        (LOWER_CASE == extensionCase ? NT_LOWER_CASE_EXT : 0));
+            else
+                *caseFlags = 0;
+
+            if (' ' == shortName[0])
+                shortName[0] = '_';
+            return lossless;
+        }
 
-                // Pad extension with spaces
-                while (FILE_NAME_LEN + FILE_EXTENSION_LEN > j) {
-                    this->m_buf->buf[fileEntryOffset + j] = ' ';
-                    ++j;
+        /**
+         * @brief       Give a long name's short alias a numeric tail ("~1", "~2", ...) that is not used by any other
+         *              file in the directory
+         *
+         * The first few tails are tried against the basis name itself. After that, part of the basis is replaced
+         * with a hash of the long name, so that a directory of similarly-named files does not require a search for
+         * each of many tails.
+         *
+         * @param[in,out]   shortName[]         Basis name, as produced by `FatFileWriter::fits_short_name`
+         * @param[out]      *fileEntryOffset    Offset of the first unused entry in the buffer after the final search
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode make_unique_alias (uint8_t shortName[], uint16_t *fileEntryOffset) {
+            PropWare::ErrorCode err;
+            uint8_t             basis[FILE_NAME_LEN];
+            char                alias[FILENAME_STR_LEN];
+
+            memcpy(basis, shortName, FILE_NAME_LEN);
+            for (uint8_t tail = 1; tail <= ALIAS_HASHED_TAILS; ++tail) {
+                memcpy(shortName, basis, FILE_NAME_LEN);
+                if (ALIAS_PLAIN_TAILS < tail) {
+                    const uint16_t hash   = FatFS::hash_name(this->m_longName);
+                    const char     digits[] = "0123456789ABCDEF";
+                    for (uint8_t i = 0; i < 4; ++i)
+                        shortName[2 + i] = (uint8_t) digits[(hash >> (12 - 4 * i)) & 0xF];
                 }
 
-                return NO_ERROR;
-            } else
-                // If it wasn't a period or null terminator, throw an error
-                return INVALID_FILENAME;
+                // The tail goes immediately after the basis, or at the end of the base if the basis is too long
+                uint8_t digit = (uint8_t) ((ALIAS_PLAIN_TAILS < tail) ? tail - ALIAS_PLAIN_TAILS : tail);
+                uint8_t tilde = 0;
+                while (tilde < FILE_NAME_LEN - 2 && ' ' != shortName[tilde])
+                    ++tilde;
+                shortName[tilde]     = '~';
+                shortName[tilde + 1] = (uint8_t) ('0' + digit);
+
+                this->get_filename(shortName, alias);
+                err = this->find(alias, fileEntryOffset);
+                if (FatFile::FILENAME_NOT_FOUND == err || FatFS::EOC_END == err)
+                    return NO_ERROR;
+                else if (err)
+                    return err;
+            }
+
+            return NO_UNIQUE_SHORT_NAME;
+        }
+
+        /**
+         * @brief       Convert a character to its short name equivalent
+         *
+         * @return      False if the character is not allowed in a short name and was replaced with '_'
+         */
+        static bool to_short_name_char (const char c, uint8_t *shortChar) {
+            if ('a' <= c && c <= 'z')
+                *shortChar = (uint8_t) (c - ('a' - 'A'));
+            else if (('A' <= c && c <= 'Z') || ('0' <= c && c <= '9') || strchr("!#$%&'()-@^_`{}~", c))
+                *shortChar = (uint8_t) c;
+            else {
+                *shortChar = '_';
+                return false;
+            }
+            return true;
         }
 
-        inline void pad_with_spaces (uint16_t const fileEntryOffset, uint8_t i) {
-            for (; i < (FILE_NAME_LEN + FILE_EXTENSION_LEN); ++i)
-                this->m_buf->buf[fileEntryOffset + i] = ' ';
+        /**
+         * @brief   Determine whether the letters in a span of characters are upper case, lower case or both
+         */
+        static uint8_t letter_case (const char *begin, const char *end) {
+            uint8_t result = 0;
+            for (; begin < end; ++begin) {
+                if ('a' <= *begin && *begin <= 'z')
+                    result |= LOWER_CASE;
+                else if ('A' <= *begin && *begin <= 'Z')
+                    result |= UPPER_CASE;
+            }
+            return result;
         }
 
-        inline void get_fat_location (const uint16_t fileEntryOffset) {
-            const uint32_t allocUnit = this->m_fs->find_empty_space(0);
+        inline PropWare::ErrorCode get_fat_location (const uint16_t fileEntryOffset) {
+            PropWare::ErrorCode err;
+            uint32_t            allocUnit;
+            check_errors(this->m_fs->find_empty_space(&allocUnit));
             this->m_driver->write_short(fileEntryOffset + FILE_START_CLSTR_LOW, this->m_buf->buf, (uint16_t) allocUnit);
             if (FatFS::FAT_32 == this->m_fs->get_fs_type())
                 this->m_driver->write_short(fileEntryOffset + FILE_START_CLSTR_HIGH, this->m_buf->buf,
                                             (uint16_t) (allocUnit >> 16));
+            return NO_ERROR;
         }
+
+    private:
+        static const uint8_t UPPER_CASE         = BIT_0;
+        static const uint8_t LOWER_CASE         = BIT_1;
+        static const uint8_t MIXED_CASE         = UPPER_CASE | LOWER_CASE;
+        /** Number of aliases tried with a tail appended to the basis name ("LOGFIL~1" through "LOGFIL~4") */
+        static const uint8_t ALIAS_PLAIN_TAILS  = 4;
+        /** Last alias tried, including those where the basis is partially replaced by a hash ("LO1A2B~1" through
+         *  "LO1A2B~5") */
+        static const uint8_t ALIAS_HASHED_TAILS = 9;
+
+    private:
+        /** Set when clusters beyond the end of the file may have been reserved */
+        bool    m_preallocated;
+        /** Set while the file is open with `FatFileWriter::open_journaled` */
+        bool    m_journaled;
+        /** Length of the file recorded by the most recent commit */
+        int32_t m_committedLength;
+        /** Optional second buffer, holding the previous sector while it is written to the device */
+        uint8_t *m_writeBehind;
+        /** Set while the device may still be reading from `m_writeBehind` */
+        bool    m_writeBehindPending;
+        /** File name exactly as given by the user, used for the long name entries */
+        char    m_longName[MAX_FILENAME_LENGTH];
 };
 
+
+inline PropWare::ErrorCode FatFS::mkdir (const char path[], BlockStorage::Buffer &buffer) {
+    FatFileWriter writer(*this, path, buffer);
+    return writer.create_directory();
+}
+
 }
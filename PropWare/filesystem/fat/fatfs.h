@@ -31,14 +31,20 @@
 #include <PropWare/hmi/output/printer.h>
 #include <PropWare/memory/blockstorage.h>
 #include <PropWare/filesystem/filesystem.h>
+#include <PropWare/filesystem/fat/fatentrycodec.h>
 
 namespace PropWare {
 
 extern uint8_t HALF_K_DATA_BUFFER1[];
 extern uint8_t HALF_K_DATA_BUFFER2[];
+extern BlockStorage::Buffer SHARED_BUFFER;
 
 /**
- * FAT 16/32 filesystem driver - can be used with SD cards or any other PropWare::BlockStorage device
+ * FAT 12/16/32 filesystem driver - can be used with SD cards or any other PropWare::BlockStorage device
+ *
+ * exFAT volumes can be mounted as well, but only for reading: files may be opened with `PropWare::FatFileReader`,
+ * while `PropWare::FatFileWriter` and `FatFS::mkdir` fail with `FatFS::READ_ONLY_FILESYSTEM`. Names are matched
+ * without regard to case for 7-bit ASCII characters only, and exFAT directories have no ".." entry to follow.
  */
 class FatFS : public Filesystem {
         friend class FatFile;
@@ -58,9 +64,42 @@ class FatFS : public Filesystem {
             /** FatFS Error 4 */   READING_PAST_EOC,
             /** FatFS Error 5 */   PARTITION_DOES_NOT_EXIST,
             /** FatFS Error 6 */   UNSUPPORTED_FILESYSTEM,
-            /** Last FatFS error */END_ERROR       = UNSUPPORTED_FILESYSTEM
+            /** FatFS Error 7 */   FILESYSTEM_FULL,
+            /** FatFS Error 8 */   JOURNAL_UNAVAILABLE,
+            /** FatFS Error 9 */   JOURNAL_BUSY,
+            /** FatFS Error 10 */  READ_ONLY_FILESYSTEM,
+            /** Last FatFS error */END_ERROR       = READ_ONLY_FILESYSTEM
         }    ErrorCode;
 
+        /**
+         * @brief   One slot of the directory index (see `FatFS::set_directory_index`)
+         */
+        struct DirectoryIndexSlot {
+            /** Cluster holding the first directory entry of the file */
+            uint32_t tier2;
+            /** Sector, counting from the start of `tier2`, holding the first directory entry of the file */
+            uint8_t  tier1Offset;
+            /** Entry number, counting from the start of the sector */
+            uint8_t  entry;
+            /** Hash of the name; 0 marks an unused slot */
+            uint16_t hash;
+        };
+
+        /** Longest directory name, including the null-terminator, that can be held by the path cache */
+        static const uint8_t PATH_CACHE_NAME_LENGTH = 16;
+
+        /**
+         * @brief   One resolved directory in the path cache (see `FatFS::set_path_cache`)
+         */
+        struct PathCacheEntry {
+            /** First cluster of the directory holding the subdirectory */
+            uint32_t parent;
+            /** First cluster of the subdirectory */
+            uint32_t cluster;
+            /** Name of the subdirectory in upper case; empty for an unused entry */
+            char     name[PATH_CACHE_NAME_LENGTH];
+        };
+
     public:
         /**
          * @brief       Constructor
@@ -81,7 +120,22 @@ class FatFS : public Filesystem {
         FatFS (const BlockStorage &driver, uint8_t fatBuffer[] = HALF_K_DATA_BUFFER1, const Printer &logger = pwOut)
                 : Filesystem(driver, logger),
                   m_fat(fatBuffer),
-                  m_fatMod(false) {
+                  m_fatMod(false),
+                  m_codec(NULL),
+                  m_dirContiguousClusters(0),
+                  m_allocSummary(NULL),
+                  m_allocSummarySize(0),
+                  m_mirrorPending(NULL),
+                  m_mirrorPendingSize(0),
+                  m_dirIndex(NULL),
+                  m_dirIndexCapacity(0),
+                  m_dirIndexState(INDEX_INVALID),
+                  m_pathCache(NULL),
+                  m_pathCacheCapacity(0),
+                  m_pathCacheNext(0),
+                  m_dirOwner(NULL),
+                  m_journalAddr(0),
+                  m_journalInUse(false) {
         }
 
         /**
@@ -112,6 +166,11 @@ class FatFS : public Filesystem {
             check_errors(this->m_driver->start());
             this->m_fatMod     = false;
             this->m_nextFileId = 0;
+            this->invalidate_directory_index();
+            this->clear_path_cache();
+            this->m_dirOwner = NULL;
+            if (NULL != this->m_mirrorPending)
+                memset(this->m_mirrorPending, 0, this->m_mirrorPendingSize);
 
             this->m_dirMeta.name = "Current working directory";
 
@@ -119,11 +178,17 @@ class FatFS : public Filesystem {
             // starting with the section "FAT Type Determination"
             // https://staff.washington.edu/dittrich/misc/fatgen103.pdf
             check_errors(this->read_boot_sector(partition, buffer));
-            check_errors(this->common_boot_sector_parser(buffer));
-            this->partition_info_parser(buffer);
-            check_errors(this->determine_fat_type());
-            this->store_root_info(buffer);
+            if (this->is_exfat_volume(buffer)) {
+                check_errors(this->exfat_boot_sector_parser(buffer));
+            } else {
+                check_errors(this->common_boot_sector_parser(buffer));
+                this->partition_info_parser(buffer);
+                check_errors(this->determine_fat_type());
+                this->store_root_info(buffer);
+            }
+            check_errors(this->read_fs_info(buffer));
             check_errors(this->read_fat_and_root_sectors(buffer));
+            check_errors(this->recover_journal(buffer));
 
             this->m_mounted = true;
 
@@ -134,26 +199,193 @@ class FatFS : public Filesystem {
          * @see PropWare::Filesystem::unmount
          */
         PropWare::ErrorCode unmount () {
-            if (this->m_mounted)
-                return this->flush_fat();
-            else
+            if (this->m_mounted) {
+                PropWare::ErrorCode err;
+                check_errors(this->flush_fat());
+                check_errors(this->sync_mirror());
+                check_errors(this->write_fs_info());
+                return this->m_driver->flush_all();
+            } else
                 return NO_ERROR;
         }
 
         /**
-         * @brief   Determine whether the mounted filesystem is FAT16 or FAT32
+         * @brief   Determine whether the mounted filesystem is FAT12, FAT16, FAT32 or exFAT
          *
-         * @return  2 (also known as PropWare::FatFS::FAT16) for FAT16, 4 (also known as PropWare::FatFS::FAT32) for
-         *          FAT32
+         * @return  1 (also known as PropWare::FatFS::FAT_12) for FAT12, 2 (PropWare::FatFS::FAT_16) for FAT16,
+         *          4 (PropWare::FatFS::FAT_32) for FAT32 and 5 (PropWare::FatFS::EXFAT) for exFAT
          */
         uint8_t get_fs_type () {
             return this->m_filesystem;
         }
 
+        /**
+         * @brief   Number of unallocated clusters, as tracked by the FAT32 FSInfo sector
+         *
+         * @return  Free cluster count, or `FatFS::UNKNOWN_FREE_COUNT` if the filesystem is FAT16 or the FSInfo sector
+         *          did not contain a valid count
+         */
+        uint32_t get_free_cluster_count () const {
+            return this->m_freeClusterCount;
+        }
+
+        /**
+         * @brief       Provide a bitmap that remembers which sectors of the FAT have no free entries left
+         *
+         * Each bit of the summary represents one sector of the FAT (128 clusters with FAT32, 256 with FAT16). Once a
+         * sector has been scanned and found to be completely allocated, its bit is set and that sector is never read
+         * again while looking for free space - until a cluster within it is released. This keeps cluster allocation
+         * fast on nearly-full volumes, where the next-free hint alone would still have to walk long stretches of
+         * allocated FAT sectors. FAT sectors beyond the end of the summary are simply scanned as usual.
+         *
+         * @param[in]   summary[]   Buffer to hold the bitmap, or NULL to stop using a summary. It will be cleared
+         * @param[in]   size        Number of bytes in `summary`. A 32 GB card with 32 kB clusters has a FAT of
+         *                          roughly 8,000 sectors and therefore needs 1 kB for a complete summary
+         */
+        void set_allocation_summary (uint8_t summary[], const uint32_t size) {
+            this->m_allocSummary     = summary;
+            this->m_allocSummarySize = NULL == summary ? 0 : size;
+            if (NULL != summary)
+                memset(summary, 0, size);
+        }
+
+        /**
+         * @brief       Provide a bitmap that lets the second copy of the FAT be brought up to date lazily
+         *
+         * Normally, every modified FAT sector is written twice - once to each copy of the FAT. With a bitmap, only
+         * the first copy is written as the FAT changes and the bit for the sector is set instead. The second copy is
+         * brought up to date all at once by `FatFS::sync_mirror` or `FatFS::unmount`, so a sector modified many
+         * times over a long logging session is copied only once. Each bit represents one sector of the FAT; sectors
+         * beyond the end of the bitmap are written to both copies as usual.
+         *
+         * @warning     If power is lost before the mirror is synchronized, the second copy of the FAT is left out of
+         *              date. The first copy, which is the one all common systems (and PropWare) read, is unaffected
+         *
+         * @param[in]   bitmap[]    Buffer to hold the bitmap, or NULL to write both copies immediately again. Any
+         *                          sectors pending in a previous bitmap are synchronized first
+         * @param[in]   size        Number of bytes in `bitmap` (see `FatFS::set_allocation_summary` for sizing)
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode set_mirror_bitmap (uint8_t bitmap[], const uint32_t size) {
+            PropWare::ErrorCode err;
+
+            if (this->m_mounted) {
+                check_errors(this->flush_fat());
+                check_errors(this->sync_mirror());
+            }
+
+            this->m_mirrorPending     = bitmap;
+            this->m_mirrorPendingSize = NULL == bitmap ? 0 : size;
+            if (NULL != bitmap)
+                memset(bitmap, 0, size);
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   Copy every FAT sector that has changed since the last synchronization to the second copy of the
+         *          FAT (see `FatFS::set_mirror_bitmap`)
+         *
+         * @return  0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode sync_mirror () {
+            PropWare::ErrorCode err;
+
+            check_errors(this->flush_fat());
+
+            // The sector already in the FAT buffer can be copied without reading it first
+            if (this->is_mirror_pending(this->m_curFatSector)) {
+                check_errors(this->write_mirror(this->m_curFatSector));
+            }
+
+            for (uint32_t byte = 0; byte < this->m_mirrorPendingSize; ++byte) {
+                for (uint8_t bit = 0; this->m_mirrorPending[byte]; ++bit) {
+                    const uint32_t fatSector = (byte << 3) + bit;
+                    if (this->is_mirror_pending(fatSector)) {
+                        this->m_curFatSector = (uint32_t) -1;
+                        check_errors(this->m_driver->read_data_block(this->m_fatStart + fatSector, this->m_fat));
+                        this->m_curFatSector = fatSector;
+                        check_errors(this->write_mirror(fatSector));
+                    }
+                }
+            }
+
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Provide storage for an index of the current directory's file names
+         *
+         * Without an index, opening a file reads every directory sector up to the file's entry, and creating a file
+         * reads the entire directory. With one, the first complete walk of the directory records a hash of every
+         * name (both the long and the short name of each file) along with the location of its entries. Later
+         * lookups read only the sector holding the matching entry, and a name that is not in the index is known
+         * not to exist without reading the directory at all. The index is discarded whenever the directory is
+         * modified and rebuilt by the next walk. If the directory holds more names than the index can, lookups
+         * of names that were indexed are still fast and all others fall back to walking the directory.
+         *
+         * @param[in]   slots[]     Array used to store the index, or NULL to disable it. For best performance, it
+         *                          should have room for at least twice as many names as the directory holds
+         * @param[in]   capacity    Number of elements in `slots`
+         */
+        void set_directory_index (DirectoryIndexSlot slots[], const uint16_t capacity) {
+            this->m_dirIndex         = slots;
+            this->m_dirIndexCapacity = NULL == slots ? 0 : capacity;
+            this->invalidate_directory_index();
+        }
+
+        /**
+         * @brief       Provide storage for remembering where recently used subdirectories begin
+         *
+         * Each directory named in a path (such as `LOGS` and `2016-03-14` in `/LOGS/2016-03-14/DATA.CSV`) must
+         * otherwise be found by walking its parent directory every time the path is used. With a cache, each
+         * directory is looked up once and later paths through it cost no reads at all. Entries are replaced in
+         * round-robin order once the cache is full, and directories whose names are longer than
+         * `FatFS::PATH_CACHE_NAME_LENGTH - 1` characters are never cached.
+         *
+         * @param[in]   entries[]   Array used to store the cache, or NULL to disable it
+         * @param[in]   capacity    Number of elements in `entries`
+         */
+        void set_path_cache (PathCacheEntry entries[], const uint8_t capacity) {
+            this->m_pathCache         = entries;
+            this->m_pathCacheCapacity = NULL == entries ? 0 : capacity;
+            this->clear_path_cache();
+        }
+
+        /**
+         * @brief       Change the current working directory
+         *
+         * Files opened with a relative path (one that does not begin with '/') are found relative to the current
+         * working directory. Path components are separated by '/', and the special names "." and ".." are supported.
+         *
+         * @note        Defined in PropWare/filesystem/fat/fatfilereader.h, which must be included to use this method
+         *
+         * @param[in]   path[]      Absolute or relative path of the new working directory
+         * @param[in]   buffer      Buffer used while reading directories
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode chdir (const char path[], BlockStorage::Buffer &buffer = SHARED_BUFFER);
+
+        /**
+         * @brief       Create a new, empty directory
+         *
+         * @note        Defined in PropWare/filesystem/fat/fatfilewriter.h, which must be included to use this method
+         *
+         * @param[in]   path[]      Absolute or relative path of the new directory. Every directory leading up to the
+         *                          new one must already exist
+         * @param[in]   buffer      Buffer used while reading and writing directories
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode mkdir (const char path[], BlockStorage::Buffer &buffer = SHARED_BUFFER);
+
     private:
         // Boot sector addresses/values
+        static const uint8_t  FAT_12                 = 1;  // A FAT entry in FAT12 is 1.5 bytes
         static const uint8_t  FAT_16                 = 2;  // A FAT entry in FAT16 is 2-bytes
         static const uint8_t  FAT_32                 = 4;  // A FAT entry in FAT32 is 4-bytes
+        static const uint8_t  EXFAT                  = 5;  // A FAT entry in exFAT is 4-bytes, all 32 bits used
         static const uint8_t  BOOT_SECTOR_ID         = 0xEB;
         static const uint8_t  BOOT_SECTOR_ID_ADDR    = 0;
         static const uint16_t PARTITION_TABLE_START  = 0x1BE;
@@ -170,6 +402,7 @@ class FatFS : public Filesystem {
         static const uint8_t  TOT_SCTR_32_ADDR       = 0x20;
         static const uint8_t  FAT_SIZE_32_ADDR       = 0x24;
         static const uint8_t  ROOT_CLUSTER_ADDR      = 0x2c;
+        static const uint8_t  FS_INFO_SECTOR_ADDR    = 0x30;
         static const uint16_t FAT12_CLSTR_CNT        = 4085;
         static const uint16_t FAT16_CLSTR_CNT        = UINT16_MAX - 10;
 
@@ -180,7 +413,56 @@ class FatFS : public Filesystem {
         static const int8_t   BAD_CLUSTER        = -9;  // Cluster is corrupt
         static const int32_t  EOC_BEG            = -8;  // First marker for end-of-chain (end of file entry within FAT)
         static const int32_t  EOC_END            = -1;  // Last marker for end-of-chain
-        static const uint32_t EOC_MASK           = 0x0fffffff;
+
+        // exFAT boot sector. Every location is given as a number of sectors from the start of the volume
+        static const uint8_t  EXFAT_NAME_ADDR           = 0x03;
+        static const uint8_t  EXFAT_FAT_OFFSET_ADDR     = 0x50;
+        static const uint8_t  EXFAT_FAT_LENGTH_ADDR     = 0x54;
+        static const uint8_t  EXFAT_HEAP_OFFSET_ADDR    = 0x58;
+        static const uint8_t  EXFAT_CLUSTER_COUNT_ADDR  = 0x5C;
+        static const uint8_t  EXFAT_ROOT_CLUSTER_ADDR   = 0x60;
+        static const uint8_t  EXFAT_VOLUME_FLAGS_ADDR   = 0x6A;
+        static const uint8_t  EXFAT_SECTOR_SHIFT_ADDR   = 0x6C;
+        static const uint8_t  EXFAT_CLUSTER_SHIFT_ADDR  = 0x6D;
+        static const uint8_t  EXFAT_NUM_FATS_ADDR       = 0x6E;
+        static const uint8_t  EXFAT_ACTIVE_FAT          = BIT_0;  // Volume flag: the second FAT is the one in use
+
+        // FSInfo sector (FAT32 only)
+        static const uint16_t FS_INFO_LEAD_SIG_ADDR   = 0;
+        static const uint16_t FS_INFO_STRUCT_SIG_ADDR = 484;
+        static const uint16_t FS_INFO_FREE_COUNT_ADDR = 488;
+        static const uint16_t FS_INFO_NEXT_FREE_ADDR  = 492;
+        static const uint32_t FS_INFO_LEAD_SIG        = 0x41615252;
+        static const uint32_t FS_INFO_STRUCT_SIG      = 0x61417272;
+
+        // Journal sector, which holds a single commit record (see `FatFileWriter::open_journaled`). Boot code and the
+        // backup boot sector never reach beyond the first 13 reserved sectors, so the last reserved sector is only
+        // borrowed when there are plenty of them - as there are on any FAT32 volume formatted with the usual tools.
+        static const uint8_t  JOURNAL_MIN_RESERVED_SECTORS = 16;
+        static const uint16_t JOURNAL_SIGNATURE_ADDR       = 0;
+        static const uint16_t JOURNAL_STATE_ADDR           = 4;
+        static const uint16_t JOURNAL_DIR_SECTOR_ADDR      = 8;
+        static const uint16_t JOURNAL_ENTRY_OFFSET_ADDR    = 12;
+        static const uint16_t JOURNAL_FIRST_CLUSTER_ADDR   = 16;
+        static const uint16_t JOURNAL_LENGTH_ADDR          = 20;
+        static const uint16_t JOURNAL_CHECK_ADDR           = 24;
+        static const uint32_t JOURNAL_SIGNATURE            = 0x4C4A5750;  // "PWJL"
+        static const uint32_t JOURNAL_OPEN                 = 1;
+        static const uint32_t JOURNAL_CLOSED               = 0;
+
+        // Directory entry fields needed to recover a journaled file
+        static const uint8_t  DIR_ENTRY_CLSTR_HIGH_OFFSET = 0x14;
+        static const uint8_t  DIR_ENTRY_CLSTR_LOW_OFFSET  = 0x1A;
+        static const uint8_t  DIR_ENTRY_LENGTH_OFFSET     = 0x1C;
+
+        // In FAT32, the first 7 usable clusters seem to be un-officially reserved for the root directory. 9 comes
+        // from the 7 un-officially reserved + 2 for the standard reservation
+        static const uint32_t FIRST_FAT16_FREE_SEARCH = 2;
+        static const uint32_t FIRST_FAT32_FREE_SEARCH = 9;
+
+    public:
+        /** Returned by `FatFS::get_free_cluster_count()` when the number of free clusters is not known */
+        static const uint32_t UNKNOWN_FREE_COUNT = (uint32_t) -1;
 
     private:
         typedef struct {
@@ -195,6 +477,15 @@ class FatFS : public Filesystem {
             uint32_t clusterCount;
         }                     InitFATInfo;
 
+        typedef enum {
+            /** The index must be rebuilt before it can be used */
+            INDEX_INVALID,
+            /** Every name in the directory is indexed */
+            INDEX_COMPLETE,
+            /** The index overflowed; names that are not found must be searched for on disk */
+            INDEX_PARTIAL
+        }                     DirectoryIndexState;
+
     private:
 
         /**
@@ -243,6 +534,57 @@ class FatFS : public Filesystem {
             return UNSUPPORTED_FILESYSTEM;
         }
 
+        bool is_exfat_volume (const uint8_t buffer[]) const {
+            return !memcmp(&buffer[EXFAT_NAME_ADDR], "EXFAT   ", 8);
+        }
+
+        /**
+         * @brief       Parse the boot sector of an exFAT volume, which shares nothing but its first few bytes with the
+         *              boot sector of a FAT volume
+         *
+         * @param[in]   buffer[]    Boot sector of the volume
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        inline PropWare::ErrorCode exfat_boot_sector_parser (const uint8_t buffer[]) {
+            InitFATInfo    *i         = &this->m_initFatInfo;
+            const uint32_t bootSector = i->bootSector;
+
+            if (this->m_driver->get_sector_size_shift() != this->m_driver->get_byte(EXFAT_SECTOR_SHIFT_ADDR, buffer))
+                return UNSUPPORTED_FILESYSTEM;
+            this->m_tier1sPerTier2Shift = this->m_driver->get_byte(EXFAT_CLUSTER_SHIFT_ADDR, buffer);
+
+            i->numFATs         = this->m_driver->get_byte(EXFAT_NUM_FATS_ADDR, buffer);
+            i->rootEntryCount  = 0;
+            i->rootDirSectors  = 0;
+            i->rsvdSectorCount = this->m_driver->get_long(EXFAT_FAT_OFFSET_ADDR, buffer);
+            i->FATSize         = this->m_driver->get_long(EXFAT_FAT_LENGTH_ADDR, buffer);
+            i->clusterCount    = this->m_driver->get_long(EXFAT_CLUSTER_COUNT_ADDR, buffer);
+            i->dataSectors     = i->clusterCount << this->m_tier1sPerTier2Shift;
+            i->totalSectors    = this->m_driver->get_long(EXFAT_HEAP_OFFSET_ADDR, buffer) + i->dataSectors;
+
+            this->m_filesystem                = EXFAT;
+            this->m_codec                     = &ExFatEntryCodec::get_instance();
+            this->m_entriesPerFatSector_Shift = 7;
+            this->m_label[0]                  = '\0';
+
+            // TexFAT volumes carry two FATs, only one of which is current
+            this->m_fatSize  = i->FATSize;
+            this->m_fatStart = bootSector + i->rsvdSectorCount;
+            if (2 == i->numFATs && (EXFAT_ACTIVE_FAT & this->m_driver->get_short(EXFAT_VOLUME_FLAGS_ADDR, buffer)))
+                this->m_fatStart += this->m_fatSize;
+
+            this->m_rootDirSectors = 0;
+            this->m_firstDataAddr  = bootSector + this->m_driver->get_long(EXFAT_HEAP_OFFSET_ADDR, buffer);
+            this->m_rootCluster    = this->m_driver->get_long(EXFAT_ROOT_CLUSTER_ADDR, buffer);
+            this->m_rootAddr       = this->compute_tier1_from_tier2(this->m_rootCluster);
+            this->m_fsInfoAddr     = 0;
+            this->m_journalAddr    = 0;
+            this->m_journalInUse   = false;
+
+            return NO_ERROR;
+        }
+
         inline PropWare::ErrorCode common_boot_sector_parser (uint8_t buffer[]) {
             // This makes the code much easier to read
             InitFATInfo *i = &this->m_initFatInfo;
@@ -325,13 +667,18 @@ class FatFS : public Filesystem {
 
         inline PropWare::ErrorCode determine_fat_type () {
             // Determine and store FAT type
-            if (FAT12_CLSTR_CNT > this->m_initFatInfo.clusterCount)
-                return UNSUPPORTED_FILESYSTEM;
-            else if (FAT16_CLSTR_CNT > this->m_initFatInfo.clusterCount) {
+            if (FAT12_CLSTR_CNT > this->m_initFatInfo.clusterCount) {
+                this->m_filesystem                = FAT_12;
+                this->m_codec                     = &Fat12EntryCodec::get_instance();
+                // FAT sectors contain 341 and one third entries - the allocation summary tracks groups of 256
+                this->m_entriesPerFatSector_Shift = 8;
+            } else if (FAT16_CLSTR_CNT > this->m_initFatInfo.clusterCount) {
                 this->m_filesystem                = FAT_16;
+                this->m_codec                     = &Fat16EntryCodec::get_instance();
                 this->m_entriesPerFatSector_Shift = 8; // FAT sectors contain 256 entries (2 bytes each)
             } else {
                 this->m_filesystem                = FAT_32;
+                this->m_codec                     = &Fat32EntryCodec::get_instance();
                 this->m_entriesPerFatSector_Shift = 7; // FAT sectors contain 128 entries (4 bytes each)
             }
 
@@ -351,6 +698,7 @@ class FatFS : public Filesystem {
             // Find root directory address
             this->m_firstDataAddr = this->m_fatStart + this->m_fatSize * numFATs;
             switch (this->m_filesystem) {
+                case FAT_12:
                 case FAT_16:
                     this->m_rootAddr = this->m_firstDataAddr;
                     this->m_firstDataAddr += this->m_rootDirSectors;
@@ -358,21 +706,85 @@ class FatFS : public Filesystem {
                 case FAT_32:
                     this->m_rootCluster = this->m_driver->get_long(ROOT_CLUSTER_ADDR, buffer);
                     this->m_rootAddr    = this->compute_tier1_from_tier2(this->m_rootCluster);
+                    this->m_fsInfoAddr  = bootSector + this->m_driver->get_short(FS_INFO_SECTOR_ADDR, buffer);
                     break;
             }
+
+            this->m_journalInUse = false;
+            if (JOURNAL_MIN_RESERVED_SECTORS <= reservedSectors)
+                this->m_journalAddr = this->m_fatStart - 1;
+            else
+                this->m_journalAddr = 0;
+        }
+
+        /**
+         * @brief       Load the free cluster count and next-free hint from the FSInfo sector
+         *
+         * Both values are only hints - they are validated against the size of the volume and discarded if they make
+         * no sense. FAT16 volumes have no FSInfo sector and always start searching from the beginning of the FAT.
+         */
+        inline PropWare::ErrorCode read_fs_info (uint8_t buffer[]) {
+            PropWare::ErrorCode err;
+
+            this->m_freeClusterCount = UNKNOWN_FREE_COUNT;
+            this->m_nextFreeHint     = this->first_free_search();
+            this->m_fsInfoMod        = false;
+
+            if (FAT_32 == this->m_filesystem) {
+                check_errors(this->m_driver->read_data_block(this->m_fsInfoAddr, buffer));
+                if (this->is_fs_info(buffer)) {
+                    const uint32_t freeCount = this->m_driver->get_long(FS_INFO_FREE_COUNT_ADDR, buffer);
+                    const uint32_t nextFree  = this->m_driver->get_long(FS_INFO_NEXT_FREE_ADDR, buffer);
+                    if (freeCount <= this->m_initFatInfo.clusterCount)
+                        this->m_freeClusterCount = freeCount;
+                    if (this->first_free_search() <= nextFree && nextFree <= this->last_cluster())
+                        this->m_nextFreeHint = nextFree;
+                } else
+                    this->m_fsInfoAddr = 0;
+            }
+
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   Save the free cluster count and next-free hint back to the FSInfo sector, if either has changed
+         *
+         * The FAT buffer is used as scratch space, so any modifications to it must be flushed beforehand
+         */
+        PropWare::ErrorCode write_fs_info () {
+            PropWare::ErrorCode err;
+
+            if (this->m_fsInfoMod && FAT_32 == this->m_filesystem && this->m_fsInfoAddr) {
+                this->m_curFatSector = (uint32_t) -1;
+                check_errors(this->m_driver->read_data_block(this->m_fsInfoAddr, this->m_fat));
+                if (this->is_fs_info(this->m_fat)) {
+                    this->m_driver->write_long(FS_INFO_FREE_COUNT_ADDR, this->m_fat, this->m_freeClusterCount);
+                    this->m_driver->write_long(FS_INFO_NEXT_FREE_ADDR, this->m_fat, this->m_nextFreeHint);
+                    check_errors(this->m_driver->write_data_block(this->m_fsInfoAddr, this->m_fat));
+                }
+                this->m_fsInfoMod = false;
+            }
+
+            return NO_ERROR;
+        }
+
+        bool is_fs_info (const uint8_t buffer[]) const {
+            return FS_INFO_LEAD_SIG == this->m_driver->get_long(FS_INFO_LEAD_SIG_ADDR, buffer)
+                    && FS_INFO_STRUCT_SIG == this->m_driver->get_long(FS_INFO_STRUCT_SIG_ADDR, buffer);
         }
 
         inline PropWare::ErrorCode read_fat_and_root_sectors (uint8_t buffer[]) {
             PropWare::ErrorCode err;
 
             // Store the first sector of the FAT
-            check_errors(this->m_driver->read_data_block(this->m_fatStart, this->m_fat));
-            this->m_curFatSector = 0;
+            this->m_curFatSector = (uint32_t) -1;
+            check_errors(this->load_fat_sector(0));
 
             // Read in the root directory, set root as current
             check_errors(this->m_driver->read_data_block(this->m_rootAddr, buffer));
             this->m_dirMeta.curTier2Addr = this->m_rootAddr;
-            if (FAT_16 == this->m_filesystem) {
+            this->m_dirContiguousClusters = 0;
+            if (this->has_fixed_root()) {
                 this->m_dir_firstCluster   = (uint32_t) -1;
                 this->m_dirMeta.curTier2 = (uint32_t) -1;
             } else {
@@ -386,15 +798,15 @@ class FatFS : public Filesystem {
         }
 
         bool is_eoc (int32_t value) const {
-            switch (this->m_filesystem) {
-                case FAT_16:
-                    return EOC_END == value;
-                case FAT_32:
-                    value |= 0xf0000000;
-                    return EOC_BEG <= value && EOC_END <= value;
-                default:
-                    return false;
-            }
+            return this->m_codec->is_eoc((uint32_t) value);
+        }
+
+        /**
+         * @brief   Determine whether the root directory is a fixed number of sectors preceding the first cluster, as it
+         *          is on FAT12 and FAT16 volumes, rather than an ordinary cluster chain
+         */
+        bool has_fixed_root () const {
+            return FAT_12 == this->m_filesystem || FAT_16 == this->m_filesystem;
         }
 
         /**
@@ -408,30 +820,101 @@ class FatFS : public Filesystem {
          */
         PropWare::ErrorCode get_fat_value (const uint32_t fatEntry, uint32_t *value) {
             PropWare::ErrorCode err;
-            uint32_t            firstAvailableCluster;
+            uint32_t            raw;
+
+            check_errors(this->read_fat_bytes(this->m_codec->get_offset(fatEntry), &raw));
+            *value = this->m_codec->decode(raw, fatEntry);
 
-            // Do we need to load a new fat sector?
-            if ((fatEntry >> this->m_entriesPerFatSector_Shift) != this->m_curFatSector) {
-                this->flush_fat();
-                this->m_curFatSector = fatEntry >> this->m_entriesPerFatSector_Shift;
-                check_errors(this->m_driver->read_data_block(this->m_curFatSector + this->m_fatStart, this->m_fat));
+            return 0;
+        }
+
+        /**
+         * @brief       Write an entry into the FAT
+         *
+         * @param[in]   fatEntry    Entry number (cluster) to modify
+         * @param[in]   value       New value for the entry (the next cluster)
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode set_fat_value (const uint32_t fatEntry, const uint32_t value) {
+            PropWare::ErrorCode err;
+            const uint32_t      offset = this->m_codec->get_offset(fatEntry);
+            uint32_t            raw;
+
+            check_errors(this->read_fat_bytes(offset, &raw));
+            return this->write_fat_bytes(offset, this->m_codec->encode(raw, fatEntry, value));
+        }
+
+        /**
+         * @brief       Read the bytes of the FAT holding a single entry, as described by the codec
+         *
+         * @param[in]   offset  Offset, in bytes from the start of the FAT, of the entry
+         * @param[out]  *raw    The entry's bytes, little-endian
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode read_fat_bytes (const uint32_t offset, uint32_t *raw) {
+            PropWare::ErrorCode err;
+            const uint32_t      fatSector = offset >> this->m_driver->get_sector_size_shift();
+            const uint16_t      index     = (uint16_t) (offset & (this->m_driver->get_sector_size() - 1));
+
+            check_errors(this->load_fat_sector(fatSector));
+            if (4 == this->m_codec->get_width())
+                *raw = this->m_driver->get_long(index, this->m_fat);
+            else if (index + 1 < this->m_driver->get_sector_size())
+                *raw = this->m_driver->get_short(index, this->m_fat);
+            else {
+                // Only a FAT12 entry can straddle two sectors
+                *raw = this->m_fat[index];
+                check_errors(this->load_fat_sector(fatSector + 1));
+                *raw |= this->m_fat[0] << 8;
             }
-            firstAvailableCluster = this->m_curFatSector << this->m_entriesPerFatSector_Shift;
 
-            // The necessary FAT sector has been loaded and the next cluster is known, proceed with loading
-            // the next data sector and incrementing the cluster variables
+            return NO_ERROR;
+        }
 
-            // Retrieve the next cluster number
-            if (FAT_16 == this->m_filesystem) {
-                *value = this->m_driver->get_short((uint16_t) ((fatEntry - firstAvailableCluster) << 1), this->m_fat);
-                *value &= WORD_0;
-            } else if (FAT_32 == this->m_filesystem) {
-                *value = this->m_driver->get_long((uint16_t) ((fatEntry - firstAvailableCluster) << 2), this->m_fat);
-                // Clear the highest 4 bits - they are always reserved
-                *value &= 0x0FFFFFFF;
+        /**
+         * @brief       Counterpart to `FatFS::read_fat_bytes`
+         */
+        PropWare::ErrorCode write_fat_bytes (const uint32_t offset, const uint32_t raw) {
+            PropWare::ErrorCode err;
+            const uint32_t      fatSector = offset >> this->m_driver->get_sector_size_shift();
+            const uint16_t      index     = (uint16_t) (offset & (this->m_driver->get_sector_size() - 1));
+
+            check_errors(this->load_fat_sector(fatSector));
+            if (4 == this->m_codec->get_width())
+                this->m_driver->write_long(index, this->m_fat, raw);
+            else if (index + 1 < this->m_driver->get_sector_size())
+                this->m_driver->write_short(index, this->m_fat, (uint16_t) raw);
+            else {
+                this->m_fat[index] = (uint8_t) raw;
+                this->m_fatMod     = true;
+                check_errors(this->load_fat_sector(fatSector + 1));
+                this->m_fat[0] = (uint8_t) (raw >> 8);
             }
+            this->m_fatMod = true;
 
-            return 0;
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Ensure the requested sector of the FAT is the one held in the FAT buffer
+         *
+         * @param[in]   fatSector   Sector offset from the start of the FAT
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode load_fat_sector (const uint32_t fatSector) {
+            PropWare::ErrorCode err;
+
+            if (fatSector != this->m_curFatSector) {
+                check_errors(this->flush_fat());
+                this->m_curFatSector = (uint32_t) -1;
+                check_errors(this->m_driver->read_data_block(this->m_fatStart + fatSector, this->m_fat));
+                this->m_curFatSector = fatSector;
+            }
+
+            return NO_ERROR;
         }
 
         /**
@@ -449,10 +932,193 @@ class FatFS : public Filesystem {
         }
 
         /**
-         * @brief   Add more sectors to the directory to allow for new file and directory entries
+         * @brief       Add a cluster to the end of the current directory to allow for new file and directory entries
+         *
+         * The new cluster is filled with zeros, which marks every entry in it as free and the first one as the end
+         * of the directory.
+         *
+         * @param[in]   *buffer     Buffer currently holding the last sector of the directory. Upon return, it holds
+         *                          the first sector of the new cluster
+         *
+         * @return      Returns 0 upon success, error code otherwise
          */
-        PropWare::ErrorCode extend_current_directory () {
-            return this->extend_fat(&this->m_dirMeta);
+        PropWare::ErrorCode extend_current_directory (BlockStorage::Buffer *buffer) {
+            PropWare::ErrorCode err;
+
+            // The root directory of a FAT16 volume has a fixed size
+            if ((uint32_t) -1 == this->m_dirMeta.curTier2)
+                return FILESYSTEM_FULL;
+
+            check_errors(this->m_driver->flush(buffer));
+            check_errors(this->extend_fat(&this->m_dirMeta));
+
+            this->m_dirMeta.curTier2       = this->m_dirMeta.nextTier2;
+            this->m_dirMeta.curTier2Addr   = this->compute_tier1_from_tier2(this->m_dirMeta.curTier2);
+            this->m_dirMeta.curTier1Offset = 0;
+            check_errors(this->get_fat_value(this->m_dirMeta.curTier2, &this->m_dirMeta.nextTier2));
+
+            memset(buffer->buf, 0, this->m_sectorSize);
+            const uint32_t tier1sPerTier2 = (uint32_t) (1 << this->m_tier1sPerTier2Shift);
+            for (uint32_t i = 0; i < tier1sPerTier2; ++i) {
+                check_errors(this->m_driver->write_data_block(this->m_dirMeta.curTier2Addr + i, buffer->buf));
+            }
+            buffer->meta     = &this->m_dirMeta;
+            this->m_dirOwner = buffer;
+
+            this->invalidate_directory_index();
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   First cluster of the root directory, or -1 for the fixed-size root directory of a FAT12 or FAT16
+         *          volume
+         */
+        uint32_t root_directory_cluster () const {
+            return this->has_fixed_root() ? (uint32_t) -1 : this->m_rootCluster;
+        }
+
+        /**
+         * @brief   Sector address at which a directory begins
+         *
+         * @param[in]   firstCluster    First cluster of the directory, as returned by
+         *                              `FatFS::root_directory_cluster` for the root directory
+         */
+        uint32_t directory_start_address (const uint32_t firstCluster) const {
+            if ((uint32_t) -1 == firstCluster)
+                return this->m_rootAddr;
+            else
+                return this->compute_tier1_from_tier2(firstCluster);
+        }
+
+        /**
+         * @brief   Make a directory the current working directory
+         *
+         * @param[in]   firstCluster        First cluster of the directory
+         * @param[in]   contiguousClusters  Length of the directory if it is stored without a FAT chain (exFAT only),
+         *                                  otherwise 0
+         */
+        void set_current_directory (const uint32_t firstCluster, const uint32_t contiguousClusters = 0) {
+            if (firstCluster != this->m_dir_firstCluster) {
+                this->m_dir_firstCluster = firstCluster;
+                this->invalidate_directory_index();
+            }
+            this->m_dirContiguousClusters = contiguousClusters;
+        }
+
+        /**
+         * @brief       Look up a subdirectory in the path cache
+         *
+         * @param[in]   parent      First cluster of the directory holding the subdirectory
+         * @param[in]   name[]      Name of the subdirectory, in upper case
+         * @param[out]  *cluster    First cluster of the subdirectory, if found
+         *
+         * @return      True if the subdirectory was in the cache
+         */
+        bool find_cached_directory (const uint32_t parent, const char name[], uint32_t *cluster) const {
+            for (uint8_t i = 0; i < this->m_pathCacheCapacity; ++i) {
+                const PathCacheEntry *entry = &this->m_pathCache[i];
+                if (entry->name[0] && parent == entry->parent && !strcmp(name, entry->name)) {
+                    *cluster = entry->cluster;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief       Remember where a subdirectory begins
+         *
+         * @param[in]   parent      First cluster of the directory holding the subdirectory
+         * @param[in]   name[]      Name of the subdirectory, in upper case
+         * @param[in]   cluster     First cluster of the subdirectory
+         */
+        void cache_directory (const uint32_t parent, const char name[], const uint32_t cluster) {
+            if (this->m_pathCacheCapacity && PATH_CACHE_NAME_LENGTH > strlen(name)) {
+                PathCacheEntry *entry = &this->m_pathCache[this->m_pathCacheNext];
+                entry->parent  = parent;
+                entry->cluster = cluster;
+                strcpy(entry->name, name);
+                if (++this->m_pathCacheNext == this->m_pathCacheCapacity)
+                    this->m_pathCacheNext = 0;
+            }
+        }
+
+        void clear_path_cache () {
+            for (uint8_t i = 0; i < this->m_pathCacheCapacity; ++i)
+                this->m_pathCache[i].name[0] = 0;
+            this->m_pathCacheNext = 0;
+        }
+
+        /**
+         * @brief   Forget the contents of the directory index, forcing it to be rebuilt by the next directory walk
+         */
+        void invalidate_directory_index () {
+            this->m_dirIndexState = INDEX_INVALID;
+        }
+
+        /**
+         * @brief   Empty the directory index in preparation for a complete walk of the directory
+         */
+        void clear_directory_index () {
+            memset(this->m_dirIndex, 0, this->m_dirIndexCapacity * sizeof(this->m_dirIndex[0]));
+            this->m_dirIndexState = INDEX_COMPLETE;
+        }
+
+        /**
+         * @brief       Record the location of a name's first directory entry
+         *
+         * @param[in]   hash        Hash of the name (see `FatFS::hash_name`)
+         * @param[in]   location    Location of the entry; its hash field is ignored
+         */
+        void index_directory_entry (const uint16_t hash, const DirectoryIndexSlot &location) {
+            uint16_t slot = (uint16_t) (hash % this->m_dirIndexCapacity);
+            for (uint16_t i = 0; i < this->m_dirIndexCapacity; ++i) {
+                if (0 == this->m_dirIndex[slot].hash) {
+                    this->m_dirIndex[slot]      = location;
+                    this->m_dirIndex[slot].hash = hash;
+                    return;
+                }
+                if (++slot == this->m_dirIndexCapacity)
+                    slot = 0;
+            }
+            this->m_dirIndexState = INDEX_PARTIAL;
+        }
+
+        /**
+         * @brief       Find the next slot of the directory index that may hold a name
+         *
+         * @param[in]       hash        Hash of the name (see `FatFS::hash_name`)
+         * @param[in,out]   *probes     Number of slots already inspected; must be 0 for the first call
+         *
+         * @return      A slot with a matching hash, or NULL once every candidate has been returned
+         */
+        const DirectoryIndexSlot *next_index_candidate (const uint16_t hash, uint16_t *probes) const {
+            while (*probes < this->m_dirIndexCapacity) {
+                const DirectoryIndexSlot *slot = &this->m_dirIndex[(hash + *probes) % this->m_dirIndexCapacity];
+                ++*probes;
+                if (0 == slot->hash)
+                    return NULL;
+                else if (hash == slot->hash)
+                    return slot;
+            }
+            return NULL;
+        }
+
+        /**
+         * @brief       Case-insensitive hash of a file name, for use with the directory index
+         *
+         * @return      Hash value, never 0
+         */
+        static uint16_t hash_name (const char name[]) {
+            uint32_t hash = 2166136261U;
+            for (; *name; ++name) {
+                char c = *name;
+                if ('a' <= c && c <= 'z')
+                    c -= 'a' - 'A';
+                hash = (hash ^ (uint8_t) c) * 16777619U;
+            }
+            const uint16_t folded = (uint16_t) (hash ^ (hash >> 16));
+            return folded ? folded : (uint16_t) 1;
         }
 
         /**
@@ -465,37 +1131,18 @@ class FatFS : public Filesystem {
          */
         PropWare::ErrorCode extend_fat (BlockStorage::MetaData *bufferMetadata) {
             PropWare::ErrorCode err;
+            uint32_t            nextTier2;
             uint32_t            newAllocUnit;
 
-            // Do we need to load a different sector of the FAT or is the correct one currently loaded? (Correct means
-            // the sector currently containing the EOC marker)
-            if ((bufferMetadata->curTier2 >> this->m_entriesPerFatSector_Shift) != this->m_curFatSector) {
-                this->flush_fat();
-                this->m_curFatSector = bufferMetadata->curTier2 >> this->m_entriesPerFatSector_Shift;
-                check_errors(this->m_driver->read_data_block(this->m_curFatSector + this->m_fatStart, this->m_fat));
-            }
-
-            // This function should only be called when a file or directory has
-            // reached the end of its cluster chain
-            const uint16_t entriesPerFatSector = (uint16_t) (1 << this->m_entriesPerFatSector_Shift);
-            const uint16_t allocUnitOffset     = (uint16_t) (bufferMetadata->curTier2 % entriesPerFatSector);
-            const uint16_t fatPointerAddress   = allocUnitOffset * this->m_filesystem;
-            const uint32_t nextSector          = this->m_driver->get_long(fatPointerAddress, this->m_fat);
-            if (!this->is_eoc(nextSector))
+            // This function should only be called when a file or directory has reached the end of its cluster chain
+            check_errors(this->get_fat_value(bufferMetadata->curTier2, &nextTier2));
+            if (!this->is_eoc(nextTier2))
                 return INVALID_FAT_APPEND;
 
-            // Find where the next cluster of the file should be stored...
-            newAllocUnit = this->find_empty_space(1);
-
-            // Now that we know the allocation unit, write it to the FAT buffer
-            const uint16_t sectorOffset = (uint16_t) ((bufferMetadata->curTier2 %
-                    (1 << this->m_entriesPerFatSector_Shift)) * this->m_filesystem);
-            if (FAT_16 == this->m_filesystem)
-                this->m_driver->write_short(sectorOffset, this->m_fat, (uint16_t) newAllocUnit);
-            else
-                this->m_driver->write_long(sectorOffset, this->m_fat, newAllocUnit);
+            // Find where the next cluster of the file should be stored and then link it to the end of the chain
+            check_errors(this->find_empty_space(&newAllocUnit));
+            check_errors(this->set_fat_value(bufferMetadata->curTier2, newAllocUnit));
             bufferMetadata->nextTier2 = newAllocUnit;
-            this->m_fatMod            = true;  // And mark the buffer as modified
 
             return 0;
         }
@@ -503,93 +1150,244 @@ class FatFS : public Filesystem {
         /**
          * @brief       Find the first empty allocation unit in the FAT
          *
-         * The value of the first empty allocation unit is returned and its location will contain the end-of-chain
-         * marker, SD_EOC_END.
+         * The search begins at the next-free hint (initialized from the FSInfo sector on FAT32 volumes) rather than
+         * the beginning of the FAT, and skips any FAT sector that the allocation summary knows to be full. The search
+         * wraps around to the beginning of the FAT once, so every cluster is considered before giving up.
+         *
+         * The new allocation unit will contain the end-of-chain marker, EOC_END.
          *
          * NOTE: It is important to realize that, though the new entry now contains an EOC marker, this function
          * does not know what cluster is being extended and therefore the calling function must modify the previous
-         * EOC to contain the return value
-         *
-         * @param[in]   restore     If non-zero, the original fat-sector will be restored to m_fat before returning;
-         *                          if zero, the last-used sector will remain loaded
-         *
-         * @return      Returns the number of the first unused allocation unit
-         */
-        uint32_t find_empty_space (const uint8_t restore) {
-            uint16_t allocOffset   = 0;
-            uint32_t fatSectorAddr = this->m_curFatSector + this->m_fatStart;
-            uint32_t retVal;
-            // NOTE: this->m_curFatSector is not modified until end of function - it is used throughout this function as
-            // the original starting point
-
-            // Find the first empty allocation unit and write the EOC marker
-            if (FAT_16 == this->m_filesystem) {
-                // Loop until we find an empty cluster
-                while (this->m_driver->get_short(allocOffset, this->m_fat)) {
-                    // Stop when we either reach the end of the current block or find an empty cluster
-                    while (this->m_driver->get_short(allocOffset, this->m_fat) && (this->m_sectorSize > allocOffset))
-                        allocOffset += FAT_16;
-                    // If we reached the end of a sector...
-                    if (this->m_sectorSize <= allocOffset) {
-                        // Read the next fat sector
-                        this->flush_fat();
-                        this->m_driver->read_data_block(++fatSectorAddr, this->m_fat);
+         * EOC to contain the new allocation unit
+         *
+         * @param[out]  *allocUnit  Number of the newly allocated unit
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode find_empty_space (uint32_t *allocUnit) {
+            PropWare::ErrorCode err;
+            const uint32_t      firstCluster     = this->first_free_search();
+            const uint32_t      lastCluster      = this->last_cluster();
+            const uint32_t      lastFatSector    = lastCluster >> this->m_entriesPerFatSector_Shift;
+
+            uint32_t candidate = this->m_nextFreeHint;
+            if (candidate < firstCluster || lastCluster < candidate)
+                candidate = firstCluster;
+
+            // One extra pass allows the sector holding the hint to be re-scanned from its beginning after wrapping
+            for (uint32_t sectorsSearched = 0; sectorsSearched <= lastFatSector + 1; ++sectorsSearched) {
+                const uint32_t fatSector = candidate >> this->m_entriesPerFatSector_Shift;
+                uint32_t       sectorEnd = (fatSector + 1) << this->m_entriesPerFatSector_Shift;
+                if (sectorEnd > lastCluster + 1)
+                    sectorEnd = lastCluster + 1;
+
+                if (!this->is_fat_sector_full(fatSector)) {
+                    const bool wholeSector = candidate <= (fatSector << this->m_entriesPerFatSector_Shift)
+                            || candidate == firstCluster;
+
+                    for (uint32_t cluster = candidate; cluster < sectorEnd; ++cluster) {
+                        uint32_t value;
+                        check_errors(this->get_fat_value(cluster, &value));
+                        if (FREE_CLUSTER == value) {
+                            check_errors(this->set_fat_value(cluster, this->m_codec->get_eoc()));
+                            this->mark_allocated(cluster, 1);
+                            *allocUnit = cluster;
+                            return NO_ERROR;
+                        }
                     }
+
+                    if (wholeSector)
+                        this->set_fat_sector_full(fatSector, true);
                 }
-                this->m_driver->write_short(allocOffset, this->m_fat, (uint16_t) EOC_END);
-                this->m_fatMod = true;
-            } else /* Implied: "if (FAT_32 == this->m_filesystem)" */{
-                // In FAT32, the first 7 usable clusters seem to be un-officially reserved for the root directory
-                if (0 == this->m_curFatSector)
-                    // 9 comes from the 7 un-officially reserved + 2 for the standard reservation
-                    allocOffset = (uint16_t) (9 * FAT_32);
-
-                // Loop until we find an empty cluster
-                while (this->m_driver->get_long(allocOffset, this->m_fat) & EOC_MASK) {
-                    // Stop when we either reach the end of the current block or find an empty cluster
-                    while ((this->m_driver->get_long(allocOffset, this->m_fat) & EOC_MASK)
-                            && (this->m_sectorSize > allocOffset))
-                        allocOffset += FAT_32;
-
-                    // If we reached the end of a sector...
-                    if (this->m_sectorSize <= allocOffset) {
-                        // Read the next fat sector
-                        this->flush_fat();
-                        this->m_driver->read_data_block(++fatSectorAddr, this->m_fat);
-                        allocOffset = 0;
-                    }
+
+                candidate = fatSector < lastFatSector ? sectorEnd : firstCluster;
+            }
+
+            return FILESYSTEM_FULL;
+        }
+
+        /**
+         * @brief       Append clusters to the end of a chain, preferring a single contiguous run
+         *
+         * The FAT is scanned once, starting at the next-free hint, for `count` consecutive free clusters. If the
+         * volume is too fragmented for such a run to exist, the clusters are instead allocated one at a time with
+         * `FatFS::find_empty_space()`.
+         *
+         * @param[in]   tail        Last cluster of the chain that should be extended; must contain an EOC marker
+         * @param[in]   count       Number of clusters to append; must be non-zero
+         * @param[out]  *first      First of the newly appended clusters
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode extend_fat_by (const uint32_t tail, const uint32_t count, uint32_t *first) {
+            PropWare::ErrorCode err;
+            uint32_t            value;
+            uint32_t            runStart;
+
+            check_errors(this->get_fat_value(tail, &value));
+            if (!this->is_eoc(value))
+                return INVALID_FAT_APPEND;
+
+            check_errors(this->find_contiguous_space(count, &runStart));
+            if (runStart) {
+                // Link the run together and terminate it before attaching it to the end of the existing chain
+                const uint32_t runEnd = runStart + count - 1;
+                for (uint32_t cluster = runStart; cluster < runEnd; ++cluster) {
+                    check_errors(this->set_fat_value(cluster, cluster + 1));
                 }
+                check_errors(this->set_fat_value(runEnd, this->m_codec->get_eoc()));
+                check_errors(this->set_fat_value(tail, runStart));
+                this->mark_allocated(runStart, count);
+                *first = runStart;
+            } else {
+                uint32_t previous = tail;
+                for (uint32_t i = 0; i < count; ++i) {
+                    uint32_t allocUnit;
+                    check_errors(this->find_empty_space(&allocUnit));
+                    check_errors(this->set_fat_value(previous, allocUnit));
+                    if (0 == i)
+                        *first = allocUnit;
+                    previous = allocUnit;
+                }
+            }
 
-                this->m_driver->write_long(allocOffset, this->m_fat, ((uint32_t) EOC_END) & EOC_MASK);
-                this->m_fatMod = true;
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Search the FAT for a run of consecutive free clusters
+         *
+         * Runs do not wrap around the end of the FAT, and sectors marked as full in the allocation summary are skipped
+         * without being read.
+         *
+         * @param[in]   count       Number of consecutive free clusters required
+         * @param[out]  *runStart   First cluster of the run, or 0 if no such run exists
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode find_contiguous_space (const uint32_t count, uint32_t *runStart) {
+            PropWare::ErrorCode err;
+            const uint32_t      firstCluster = this->first_free_search();
+            const uint32_t      lastCluster  = this->last_cluster();
+
+            uint32_t cluster = this->m_nextFreeHint;
+            if (cluster < firstCluster || lastCluster < cluster)
+                cluster = firstCluster;
+
+            uint32_t remaining = lastCluster - firstCluster + 1;
+            uint32_t start     = 0;
+            uint32_t runLength = 0;
+            *runStart = 0;
+            while (remaining) {
+                const uint32_t fatSector = cluster >> this->m_entriesPerFatSector_Shift;
+
+                if (this->is_fat_sector_full(fatSector)) {
+                    uint32_t sectorEnd = (fatSector + 1) << this->m_entriesPerFatSector_Shift;
+                    if (sectorEnd > lastCluster + 1)
+                        sectorEnd = lastCluster + 1;
+                    remaining -= remaining < sectorEnd - cluster ? remaining : sectorEnd - cluster;
+                    cluster   = sectorEnd;
+                    runLength = 0;
+                } else {
+                    uint32_t value;
+                    check_errors(this->get_fat_value(cluster, &value));
+                    if (FREE_CLUSTER == value) {
+                        if (0 == runLength)
+                            start = cluster;
+                        if (++runLength == count) {
+                            *runStart = start;
+                            return NO_ERROR;
+                        }
+                    } else
+                        runLength = 0;
+                    ++cluster;
+                    --remaining;
+                }
+
+                if (lastCluster < cluster) {
+                    cluster   = firstCluster;
+                    runLength = 0;
+                }
             }
 
-            // If we loaded a new fat sector (and then modified it directly
-            // above), write the sector before re-loading the original
-            if ((fatSectorAddr != (this->m_curFatSector + this->m_fatStart)) && this->m_fatMod) {
-                this->flush_fat();
-                this->m_driver->read_data_block(this->m_curFatSector + this->m_fatStart, this->m_fat);
-            } else
-                this->m_curFatSector = fatSectorAddr - this->m_fatStart;
+            return NO_ERROR;
+        }
 
-            // Return new address to end-of-chain
-            retVal = this->m_curFatSector << this->m_entriesPerFatSector_Shift;
-            retVal += allocOffset / this->m_filesystem;
-            return retVal;
+        /**
+         * @brief   Update the free cluster count and next-free hint after clusters have been claimed
+         */
+        void mark_allocated (const uint32_t firstCluster, const uint32_t count) {
+            // Wrap around once the end of the volume is reached; FSInfo must never point past the last cluster
+            const uint32_t next = firstCluster + count;
+            this->m_nextFreeHint = next <= this->last_cluster() ? next : this->first_free_search();
+            if (UNKNOWN_FREE_COUNT != this->m_freeClusterCount)
+                this->m_freeClusterCount -= count < this->m_freeClusterCount ? count : this->m_freeClusterCount;
+            this->m_fsInfoMod = true;
+        }
+
+        /**
+         * @brief   First cluster that should be considered when searching for free space
+         */
+        uint32_t first_free_search () const {
+            return this->has_fixed_root() ? FIRST_FAT16_FREE_SEARCH : FIRST_FAT32_FREE_SEARCH;
+        }
+
+        /**
+         * @brief   Highest valid cluster number on the volume
+         */
+        uint32_t last_cluster () const {
+            return this->m_initFatInfo.clusterCount + 1;
+        }
+
+        bool is_fat_sector_full (const uint32_t fatSector) const {
+            if ((fatSector >> 3) < this->m_allocSummarySize)
+                return this->m_allocSummary[fatSector >> 3] & (1 << (fatSector & 7));
+            else
+                return false;
+        }
+
+        void set_fat_sector_full (const uint32_t fatSector, const bool full) {
+            if ((fatSector >> 3) < this->m_allocSummarySize) {
+                if (full)
+                    this->m_allocSummary[fatSector >> 3] |= (uint8_t) (1 << (fatSector & 7));
+                else
+                    this->m_allocSummary[fatSector >> 3] &= (uint8_t) ~(1 << (fatSector & 7));
+            }
         }
 
         PropWare::ErrorCode flush_fat () {
             PropWare::ErrorCode err;
             if (m_fatMod) {
                 check_errors(m_driver->write_data_block(this->m_fatStart + this->m_curFatSector, this->m_fat));
-                check_errors(m_driver->write_data_block(this->m_fatStart + this->m_curFatSector + this->m_fatSize,
-                                                        m_fat));
+                if ((this->m_curFatSector >> 3) < this->m_mirrorPendingSize)
+                    this->m_mirrorPending[this->m_curFatSector >> 3] |= (uint8_t) (1 << (this->m_curFatSector & 7));
+                else {
+                    check_errors(m_driver->write_data_block(this->m_fatStart + this->m_curFatSector + this->m_fatSize,
+                                                            m_fat));
+                }
                 m_fatMod = false;
             }
 
             return NO_ERROR;
         }
 
+        bool is_mirror_pending (const uint32_t fatSector) const {
+            if ((fatSector >> 3) < this->m_mirrorPendingSize)
+                return this->m_mirrorPending[fatSector >> 3] & (1 << (fatSector & 7));
+            else
+                return false;
+        }
+
+        /**
+         * @brief   Write the FAT buffer, which must hold `fatSector`, to the second copy of the FAT
+         */
+        PropWare::ErrorCode write_mirror (const uint32_t fatSector) {
+            PropWare::ErrorCode err;
+            check_errors(this->m_driver->write_data_block(this->m_fatStart + fatSector + this->m_fatSize, this->m_fat));
+            this->m_mirrorPending[fatSector >> 3] &= (uint8_t) ~(1 << (fatSector & 7));
+            return NO_ERROR;
+        }
+
         /**
          * @brief       Remove the linked list of allocation units from the FAT (clear space)
          *
@@ -604,21 +1402,138 @@ class FatFS : public Filesystem {
             do {
                 const uint32_t current = next;
                 check_errors(this->get_fat_value(current, &next));
+                check_errors(this->set_fat_value(current, FREE_CLUSTER));
+
+                // Keep the allocation hints honest
+                this->set_fat_sector_full(current >> this->m_entriesPerFatSector_Shift, false);
+                if (current < this->m_nextFreeHint)
+                    this->m_nextFreeHint = current;
+                if (UNKNOWN_FREE_COUNT != this->m_freeClusterCount)
+                    ++this->m_freeClusterCount;
+                this->m_fsInfoMod = true;
+            } while (!this->is_eoc(next));
 
-                const uint32_t firstAvailableAllocUnit = this->m_curFatSector << this->m_entriesPerFatSector_Shift;
-                const uint16_t sectorOffset            = (uint16_t) (current - firstAvailableAllocUnit);
+            return NO_ERROR;
+        }
 
-                if (FAT_16 == this->m_filesystem)
-                    this->m_driver->write_short(sectorOffset << 1, this->m_fat, 0);
-                else if (FAT_32 == this->m_filesystem)
-                    this->m_driver->write_long(sectorOffset << 2, this->m_fat, 0);
-            } while (!this->is_eoc(next));
+        /**
+         * @brief       Shorten a cluster chain, freeing every cluster after the first `clusters`
+         *
+         * @param[in]   head        First cluster of the chain
+         * @param[in]   clusters    Number of clusters to keep (the first cluster is always kept)
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode truncate_chain (const uint32_t head, const uint32_t clusters) {
+            PropWare::ErrorCode err;
 
-            this->m_fatMod = true;
+            uint32_t lastKept = head;
+            uint32_t next;
+            check_errors(this->get_fat_value(lastKept, &next));
+            for (uint32_t i = 1; i < clusters && !this->is_eoc(next); ++i) {
+                lastKept = next;
+                check_errors(this->get_fat_value(lastKept, &next));
+            }
 
+            if (!this->is_eoc(next)) {
+                check_errors(this->set_fat_value(lastKept, this->m_codec->get_eoc()));
+                check_errors(this->clear_chain(next));
+            }
             return NO_ERROR;
         }
 
+        /**
+         * @brief   Number of clusters required to hold `bytes` bytes. Every file owns at least one cluster
+         */
+        uint32_t clusters_for (const uint32_t bytes) const {
+            const uint8_t  clusterShift = this->m_driver->get_sector_size_shift() + this->m_tier1sPerTier2Shift;
+            const uint32_t clusters     = (bytes + (1 << clusterShift) - 1) >> clusterShift;
+            return clusters ? clusters : 1;
+        }
+
+        /**
+         * @brief       Make the FAT durable and then record the committed state of the journaled file
+         *
+         * The FAT buffer is used as scratch space, so it is flushed first and reloaded by its next user.
+         *
+         * @param[in]   state           JOURNAL_OPEN while the file is being appended, JOURNAL_CLOSED once its
+         *                              directory entry is up to date
+         * @param[in]   dirSector       Address of the sector holding the file's directory entry
+         * @param[in]   entryOffset     Offset of the directory entry within `dirSector`
+         * @param[in]   firstCluster    First cluster of the file
+         * @param[in]   length          Committed length of the file
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode write_journal (const uint32_t state, const uint32_t dirSector, const uint16_t entryOffset,
+                                           const uint32_t firstCluster, const uint32_t length) {
+            PropWare::ErrorCode err;
+
+            check_errors(this->flush_fat());
+
+            this->m_curFatSector = (uint32_t) -1;
+            memset(this->m_fat, 0, this->m_sectorSize);
+            this->m_driver->write_long(JOURNAL_SIGNATURE_ADDR, this->m_fat, JOURNAL_SIGNATURE);
+            this->m_driver->write_long(JOURNAL_STATE_ADDR, this->m_fat, state);
+            this->m_driver->write_long(JOURNAL_DIR_SECTOR_ADDR, this->m_fat, dirSector);
+            this->m_driver->write_long(JOURNAL_ENTRY_OFFSET_ADDR, this->m_fat, entryOffset);
+            this->m_driver->write_long(JOURNAL_FIRST_CLUSTER_ADDR, this->m_fat, firstCluster);
+            this->m_driver->write_long(JOURNAL_LENGTH_ADDR, this->m_fat, length);
+            this->m_driver->write_long(JOURNAL_CHECK_ADDR, this->m_fat, this->journal_check(this->m_fat));
+            return this->m_driver->write_data_block(this->m_journalAddr, this->m_fat);
+        }
+
+        uint32_t journal_check (const uint8_t record[]) const {
+            uint32_t check = 0;
+            for (uint16_t offset = 0; offset < JOURNAL_CHECK_ADDR; offset += sizeof(uint32_t))
+                check = ((check << 1) | (check >> 31)) ^ this->m_driver->get_long(offset, record);
+            return ~check;
+        }
+
+        /**
+         * @brief       Bring a journaled file that was still open when power was lost back to its last committed
+         *              length
+         *
+         * Appended clusters beyond the committed length are freed and the directory entry is given the committed
+         * length, after which the record is marked closed. Nothing is done when the record is closed, invalid, or
+         * describes a directory entry that no longer belongs to the same file.
+         *
+         * @param[in]   buffer[]    Scratch space of one sector
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode recover_journal (uint8_t buffer[]) {
+            PropWare::ErrorCode err;
+
+            if (!this->m_journalAddr)
+                return NO_ERROR;
+
+            check_errors(this->m_driver->read_data_block(this->m_journalAddr, buffer));
+            if (JOURNAL_SIGNATURE != this->m_driver->get_long(JOURNAL_SIGNATURE_ADDR, buffer)
+                    || JOURNAL_OPEN != this->m_driver->get_long(JOURNAL_STATE_ADDR, buffer)
+                    || this->journal_check(buffer) != this->m_driver->get_long(JOURNAL_CHECK_ADDR, buffer))
+                return NO_ERROR;
+
+            const uint32_t dirSector    = this->m_driver->get_long(JOURNAL_DIR_SECTOR_ADDR, buffer);
+            const uint16_t entryOffset  = (uint16_t) this->m_driver->get_long(JOURNAL_ENTRY_OFFSET_ADDR, buffer);
+            const uint32_t firstCluster = this->m_driver->get_long(JOURNAL_FIRST_CLUSTER_ADDR, buffer);
+            const uint32_t length       = this->m_driver->get_long(JOURNAL_LENGTH_ADDR, buffer);
+
+            check_errors(this->m_driver->read_data_block(dirSector, buffer));
+            uint32_t entryCluster = this->m_driver->get_short(entryOffset + DIR_ENTRY_CLSTR_LOW_OFFSET, buffer);
+            if (FAT_32 == this->m_filesystem)
+                entryCluster |= ((uint32_t) this->m_driver->get_short(entryOffset + DIR_ENTRY_CLSTR_HIGH_OFFSET,
+                                                                      buffer)) << 16;
+
+            if (firstCluster == entryCluster) {
+                check_errors(this->truncate_chain(firstCluster, this->clusters_for(length)));
+                this->m_driver->write_long(entryOffset + DIR_ENTRY_LENGTH_OFFSET, buffer, length);
+                check_errors(this->m_driver->write_data_block(dirSector, buffer));
+            }
+
+            return this->write_journal(JOURNAL_CLOSED, dirSector, entryOffset, firstCluster, length);
+        }
+
         void print_status (const bool printBlocks = false) const {
             this->m_logger->println("######################################################");
             this->m_logger->printf("# FAT Filesystem Status - PropWare::FatFS@0x%08X #\n", (unsigned int) this);
@@ -668,6 +1583,12 @@ class FatFS : public Filesystem {
                     case FAT_16:
                         this->m_logger->printf("\tFilesystem: FAT 16\n");
                         break;
+                    case FAT_12:
+                        this->m_logger->printf("\tFilesystem: FAT 12\n");
+                        break;
+                    case EXFAT:
+                        this->m_logger->printf("\tFilesystem: exFAT (read-only)\n");
+                        break;
                     default:
                         this->m_logger->printf("\tFilesystem: unknown (%d)\n", this->m_filesystem);
                 }
@@ -678,6 +1599,16 @@ class FatFS : public Filesystem {
                 this->m_logger->printf("\tRoot directory sector: 0x%08X\n", this->m_rootAddr);
                 this->m_logger->printf("\tRoot directory size (in sectors): %u\n", this->m_rootDirSectors);
                 this->m_logger->printf("\tFirst data sector: 0x%08X\n", this->m_firstDataAddr);
+                this->m_logger->printf("\tFree clusters: 0x%08X/%u\n", this->m_freeClusterCount,
+                                       this->m_freeClusterCount);
+                this->m_logger->printf("\tNext free cluster hint: 0x%08X/%u\n", this->m_nextFreeHint,
+                                       this->m_nextFreeHint);
+                this->m_logger->printf("\tCurrent directory cluster: 0x%08X\n", this->m_dir_firstCluster);
+                this->m_logger->printf("\tJournal sector: 0x%08X%s\n", this->m_journalAddr,
+                                       this->m_journalInUse ? " (in use)" : "");
+                this->m_logger->printf("\tDirectory index: %u slots, %s\n", this->m_dirIndexCapacity,
+                                       INDEX_INVALID == this->m_dirIndexState ? "invalid" :
+                                       (INDEX_COMPLETE == this->m_dirIndexState ? "complete" : "partial"));
                 this->m_logger->println();
             } else {
                 this->m_logger->println("\nNot mounted");
@@ -706,7 +1637,7 @@ class FatFS : public Filesystem {
 
     private:
         InitFATInfo            m_initFatInfo;
-        uint8_t                m_filesystem;  // File system type - one of FAT_16 or FAT_32
+        uint8_t                m_filesystem;  // File system type - one of FAT_12, FAT_16, FAT_32 or EXFAT
         char                   m_label[9]; // Filesystem label
         uint32_t               m_fatStart;  // Starting block address of the FAT
         uint32_t               m_rootCluster;  // Cluster of root directory/first data sector (FAT32 only)
@@ -717,9 +1648,36 @@ class FatFS : public Filesystem {
         uint16_t               m_entriesPerFatSector_Shift;  // How many FAT entries are in a single sector of the FAT
         uint8_t                *m_fat;  // Buffer for FAT entries only
         bool                   m_fatMod;
+        const FatEntryCodec    *m_codec;  // Layout of the FAT's entries, chosen to match m_filesystem
 
         uint32_t m_curFatSector;  // Store the current FAT sector loaded into m_fat
         uint32_t m_dir_firstCluster;  // Store the current directory's starting cluster
+        uint32_t m_dirContiguousClusters;  // Length of the current directory when it has no FAT chain (exFAT only)
+
+        uint32_t m_fsInfoAddr;  // Block address of the FSInfo sector (FAT32 only; 0 when not present)
+        uint32_t m_freeClusterCount;  // Number of free clusters, or UNKNOWN_FREE_COUNT
+        uint32_t m_nextFreeHint;  // Cluster at which to begin the next search for free space
+        bool     m_fsInfoMod;  // Free count or next-free hint changed since the FSInfo sector was last written
+        uint8_t  *m_allocSummary;  // Optional bitmap; a set bit marks a FAT sector without any free entries
+        uint32_t m_allocSummarySize;  // Number of bytes in m_allocSummary
+        uint8_t  *m_mirrorPending;  // Optional bitmap; a set bit marks a FAT sector not yet copied to the second FAT
+        uint32_t m_mirrorPendingSize;  // Number of bytes in m_mirrorPending
+
+        DirectoryIndexSlot  *m_dirIndex;  // Optional hash table of names in the current directory
+        uint16_t            m_dirIndexCapacity;  // Number of slots in m_dirIndex
+        DirectoryIndexState m_dirIndexState;
+        DirectoryIndexSlot  m_dirIndexEnd;  // Location of the first unused entry, valid once the index is complete
+
+        PathCacheEntry *m_pathCache;  // Optional cache of subdirectory locations
+        uint8_t        m_pathCacheCapacity;  // Number of elements in m_pathCache
+        uint8_t        m_pathCacheNext;  // Element of m_pathCache to be replaced next
+
+        // Buffer that most recently loaded a directory sector - the only one whose copy of the directory is trusted.
+        // Only ever compared, never dereferenced, so it may outlive the buffer it points to.
+        const BlockStorage::Buffer *m_dirOwner;
+
+        uint32_t m_journalAddr;  // Block address of the journal sector, or 0 when the volume has no room for one
+        bool     m_journalInUse;  // A file is currently open with `FatFileWriter::open_journaled`
 };
 
 }
@@ -50,7 +50,11 @@ class File {
                 /** end of the stream */             END
         };
 
-        static const unsigned int MAX_FILENAME_LENGTH = 32;
+        /**
+         * Size of the buffers holding a file's name or path, including the null terminator. Long (VFAT) names may be
+         * up to 255 characters. Longer names can not be opened and fail with `INVALID_FILENAME`
+         */
+        static const unsigned int MAX_FILENAME_LENGTH = 256;
 
     public:
         /**
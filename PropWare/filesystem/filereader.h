@@ -50,6 +50,33 @@ class FileReader : virtual public File, virtual public ScanCapable {
          */
         virtual PropWare::ErrorCode safe_get_char (char &c) = 0;
 
+        /**
+         * @brief       Read a block of bytes from the file
+         *
+         * The default implementation reads one character at a time; concrete files should override it with something
+         * faster.
+         *
+         * @param[out]  dst[]       Destination for the data - must be at least `n` bytes long
+         * @param[in]   n           Number of bytes to read
+         * @param[out]  *bytesRead  If not NULL, the number of bytes actually read will be stored here. It will be
+         *                          less than `n` only if an error occurs or the end of the file is reached
+         *
+         * @return      0 upon success, EOF_ERROR if the file ended before `n` bytes were read, other error code
+         *              otherwise
+         */
+        virtual PropWare::ErrorCode read (uint8_t dst[], const size_t n, size_t *bytesRead = NULL) {
+            PropWare::ErrorCode err;
+            size_t              ignored;
+            size_t              &done = NULL == bytesRead ? ignored : *bytesRead;
+
+            for (done = 0; done < n; ++done) {
+                if (this->eof())
+                    return EOF_ERROR;
+                check_errors(this->safe_get_char((char &) dst[done]));
+            }
+            return NO_ERROR;
+        }
+
         /**
          * @brief   Read a character from the file
          *
@@ -58,6 +58,25 @@ class FileWriter : virtual public File, public PrintCapable {
             this->safe_put_char(c);
         }
 
+        /**
+         * @brief       Write a block of bytes to the file
+         *
+         * The default implementation writes one character at a time; concrete files should override it with something
+         * faster.
+         *
+         * @param[in]   src[]   Data to be written - must be at least `n` bytes long
+         * @param[in]   n       Number of bytes to write
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        virtual PropWare::ErrorCode write (const uint8_t src[], const size_t n) {
+            PropWare::ErrorCode err;
+
+            for (size_t i = 0; i < n; ++i)
+                check_errors(this->safe_put_char((char) src[i]));
+            return NO_ERROR;
+        }
+
         /**
          * @brief       Write a character array to the file
          *
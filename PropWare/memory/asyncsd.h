@@ -0,0 +1,508 @@
+/**
+ * @file        PropWare/memory/asyncsd.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/PropWare.h>
+#include <PropWare/concurrent/runnable.h>
+#include <PropWare/memory/sd.h>
+
+namespace PropWare {
+
+/**
+ * @brief   SD card driver whose SPI transfers are executed by a dedicated cog
+ *
+ * `PropWare::SD` shifts every bit from the calling cog, so the caller is stalled for the entire duration of a sector
+ * transfer. `AsyncSD` instead starts its own cog (via `PropWare::Runnable`) which owns the SPI bus and the SD card. The
+ * application submits read and write requests into a ring of mailboxes in HUB RAM and is free to continue working
+ * until it needs the result, at which point it can poll `AsyncSD::is_complete()` or block in `AsyncSD::wait()`.
+ *
+ * Requests are serviced strictly in the order they were submitted. A mailbox is only recycled after its result has
+ * been collected with `AsyncSD::wait()`, so at most `ringLength` requests can be outstanding at any time; any idle
+ * mailbox may be claimed, no matter which order earlier results are collected in.
+ *
+ * `AsyncSD` is also a complete `PropWare::BlockStorage` implementation, so it can be handed directly to
+ * `PropWare::FatFS` (or a `PropWare::BlockCache`). Those synchronous methods use a private mailbox outside of the ring
+ * and wait for it, so they never block on (or are blocked by) requests whose results have not yet been collected.
+ *
+ * @code
+ * int main () {
+ *     static uint32_t          stack[128];
+ *     static AsyncSD::Request  ring[4];
+ *     static uint8_t           buffer[512];
+ *     AsyncSD sd(ring, 4, stack);
+ *
+ *     if (sd.start())
+ *         return 1;
+ *
+ *     AsyncSD::Request *request = sd.submit_read(0, buffer);
+ *     while (!sd.is_complete(*request))
+ *         sample_sensors(); // Keep working while the sector is in flight
+ *     return sd.wait(*request);
+ * }
+ * @endcode
+ *
+ * @warning     Only a single cog may submit requests to any one `AsyncSD` instance
+ *
+ * @warning     The buffer attached to a request must not be touched by the caller until the request is complete
+ */
+class AsyncSD : public BlockStorage,
+                public Runnable {
+    public:
+        /**
+         * Error codes - preceded by SD
+         */
+        typedef enum {
+            /** No error */                NO_ERROR          = 0,
+            /** First AsyncSD error code */BEG_ERROR         = SD::END_ERROR + 1,
+            /** AsyncSD Error 0 */         COG_START_FAILURE = BEG_ERROR,
+            /** Last AsyncSD error code */ END_ERROR         = COG_START_FAILURE
+        } ErrorCode;
+
+        /**
+         * Lifecycle of a single mailbox in the request ring
+         */
+        typedef enum {
+            /** Mailbox may be claimed by the submitting cog */  IDLE,
+            /** Waiting to be picked up by the engine */         PENDING,
+            /** Engine is shifting data for this request */      ACTIVE,
+            /** Transfer finished; result is waiting for `wait` */DONE
+        } Status;
+
+        /**
+         * Mailbox shared between the submitting cog and the engine cog
+         */
+        struct Request {
+            /** Current state; written last by whichever side hands the mailbox over */
+            volatile Status              status;
+            /** True for a write, false for a read */
+            bool                         write;
+            /** Address of the first block */
+            uint32_t                     address;
+            /** Number of consecutive blocks */
+            uint32_t                     blockCount;
+            /** Source or destination of the data; must be `blockCount * 512` bytes */
+            uint8_t                      *buffer;
+            /** Result of the transfer, valid once `status` is DONE */
+            volatile PropWare::ErrorCode err;
+            /** Position in submission order; the engine services requests in ascending sequence */
+            uint32_t                     sequence;
+        };
+
+    public:
+        /**
+         * @brief       Construct an engine using the SD card pins defined by the board configuration
+         *
+         * @tparam[in]  N               Number of 32-bit words in the stack. This parameter will be auto-determined by
+         *                              the compiler
+         * @param[in]   ring[]          Mailboxes used for queuing requests
+         * @param[in]   ringLength      Number of mailboxes in `ring`
+         * @param[in]   stack[]         Stack for the engine cog. Should be at least 128 32-bit words
+         */
+        template<size_t N>
+        AsyncSD (Request ring[], const uint8_t ringLength, const uint32_t (&stack)[N])
+                : Runnable(stack),
+                  m_ring(ring),
+                  m_ringLength(ringLength) {
+            Pin::Mask pins[4];
+            SD::unpack_sd_pins((uint32_t *) pins);
+            this->init(pins[0], pins[1], pins[2], pins[3]);
+        }
+
+        /**
+         * @brief       Construct an engine on the given pins
+         *
+         * @tparam[in]  N               Number of 32-bit words in the stack. This parameter will be auto-determined by
+         *                              the compiler
+         * @param[in]   ring[]          Mailboxes used for queuing requests
+         * @param[in]   ringLength      Number of mailboxes in `ring`
+         * @param[in]   stack[]         Stack for the engine cog. Should be at least 128 32-bit words
+         * @param[in]   mosi            Pin mask for data line leaving the Propeller
+         * @param[in]   miso            Pin mask for data line going in to the Propeller
+         * @param[in]   sclk            Pin mask for clock line
+         * @param[in]   cs              Pin mask for chip select
+         */
+        template<size_t N>
+        AsyncSD (Request ring[], const uint8_t ringLength, const uint32_t (&stack)[N], const Port::Mask mosi,
+                 const Port::Mask miso, const Port::Mask sclk, const Port::Mask cs)
+                : Runnable(stack),
+                  m_ring(ring),
+                  m_ringLength(ringLength) {
+            this->init(mosi, miso, sclk, cs);
+        }
+
+        /**
+         * @brief   Stop the engine cog
+         */
+        ~AsyncSD () {
+            this->stop();
+        }
+
+        /**
+         * @brief       Start the engine cog and initialize the SD card from within it
+         *
+         * The pins are only ever driven by the engine cog. Calling this more than once has no effect other than
+         * returning the result of the first initialization.
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode start () const {
+            if (0 > this->m_cog) {
+                // Runnable::invoke requires a mutable reference; the engine is the only state that changes
+                AsyncSD *engine = const_cast<AsyncSD *>(this);
+                this->m_cog = Runnable::invoke(*engine);
+                if (0 > this->m_cog)
+                    return COG_START_FAILURE;
+            }
+
+            while (!this->m_ready);
+            return this->m_startError;
+        }
+
+        /**
+         * @brief       Protect every transfer with CRCs
+         *
+         * @param[in]   enabled     True to enable CRC checking
+         *
+         * @pre         Must be invoked before `AsyncSD::start()`
+         *
+         * @see         PropWare::SD::set_crc_checking
+         */
+        void set_crc_checking (const bool enabled) {
+            this->m_crcEnabled = enabled;
+        }
+
+        /**
+         * @brief   Stop the engine cog, abandoning any outstanding requests
+         *
+         * The SD card is left in whatever state the transfer was in and must be restarted with `AsyncSD::start()`
+         */
+        void stop () const {
+            if (-1 != this->m_cog) {
+                cogstop(this->m_cog);
+                this->m_cog                = -1;
+                this->m_ready              = false;
+                this->m_submitted          = 0;
+                this->m_synchronous.status = IDLE;
+                for (uint8_t i = 0; i < this->m_ringLength; ++i)
+                    this->m_ring[i].status = IDLE;
+            }
+        }
+
+        /**
+         * @brief       Queue a read of one or more consecutive blocks
+         *
+         * @param[in]   address     Address of the first block
+         * @param[out]  buf         Destination for the data; must be at least `count * 512` bytes
+         * @param[in]   count       Number of consecutive blocks to read
+         *
+         * @return      Mailbox that must later be passed to `AsyncSD::wait()`, or NULL if every mailbox is in use
+         */
+        Request *submit_read (const uint32_t address, uint8_t buf[], const uint32_t count = 1) const {
+            return this->submit(false, address, count, buf);
+        }
+
+        /**
+         * @brief       Queue a write of one or more consecutive blocks
+         *
+         * @param[in]   address     Address of the first block
+         * @param[in]   dat         Source of the data; must be at least `count * 512` bytes
+         * @param[in]   count       Number of consecutive blocks to write
+         *
+         * @return      Mailbox that must later be passed to `AsyncSD::wait()`, or NULL if every mailbox is in use
+         */
+        Request *submit_write (const uint32_t address, const uint8_t dat[], const uint32_t count = 1) const {
+            return this->submit(true, address, count, const_cast<uint8_t *>(dat));
+        }
+
+        /**
+         * @brief       Determine whether the engine has finished with a request, without blocking
+         *
+         * @param[in]   request     Mailbox returned by one of the submit methods
+         *
+         * @return      True once the transfer has completed (successfully or otherwise)
+         */
+        bool is_complete (const Request &request) const {
+            return DONE == request.status;
+        }
+
+        /**
+         * @brief       Block until a request completes and release its mailbox for reuse
+         *
+         * @param[in]   request     Mailbox returned by one of the submit methods
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode wait (Request &request) const {
+            while (DONE != request.status);
+            const PropWare::ErrorCode err = request.err;
+            request.status = IDLE;
+            return err;
+        }
+
+        /**
+         * @brief       Number of requests that have been submitted but not yet collected with `AsyncSD::wait()`
+         */
+        uint8_t get_outstanding () const {
+            uint8_t outstanding = 0;
+            for (uint8_t i = 0; i < this->m_ringLength; ++i)
+                if (IDLE != this->m_ring[i].status)
+                    ++outstanding;
+            return outstanding;
+        }
+
+        /**
+         * @brief       Cog running the engine, or -1 if it has not been started
+         */
+        int8_t get_cog_id () const {
+            return this->m_cog;
+        }
+
+        PropWare::ErrorCode read_data_block (const uint32_t address, uint8_t buf[]) const {
+            return this->read_data_blocks(address, 1, buf);
+        }
+
+        PropWare::ErrorCode read_data_blocks (const uint32_t address, const uint32_t count, uint8_t buf[]) const {
+            return this->transfer(false, address, count, buf);
+        }
+
+        /**
+         * @brief       Queue a read without waiting for it
+         *
+         * Falls back to an ordinary (blocking) read if every mailbox is in use
+         *
+         * @see         PropWare::BlockStorage::start_read_ahead
+         */
+        PropWare::ErrorCode start_read_ahead (const uint32_t address, uint8_t buf[]) const {
+            if (NULL == this->submit_read(address, buf))
+                return this->read_data_block(address, buf);
+            else
+                return NO_ERROR;
+        }
+
+        /**
+         * @see         PropWare::BlockStorage::wait_for_read_ahead
+         */
+        PropWare::ErrorCode wait_for_read_ahead (const uint8_t buf[]) const {
+            return this->wait_for_buffer(false, buf);
+        }
+
+        /**
+         * @brief       Queue a write without waiting for it
+         *
+         * Falls back to an ordinary (blocking) write if every mailbox is in use
+         *
+         * @see         PropWare::BlockStorage::start_write_behind
+         */
+        PropWare::ErrorCode start_write_behind (const uint32_t address, const uint8_t dat[]) const {
+            if (NULL == this->submit_write(address, dat))
+                return this->write_data_block(address, dat);
+            else
+                return NO_ERROR;
+        }
+
+        /**
+         * @see         PropWare::BlockStorage::wait_for_write_behind
+         */
+        PropWare::ErrorCode wait_for_write_behind (const uint8_t dat[]) const {
+            return this->wait_for_buffer(true, dat);
+        }
+
+        PropWare::ErrorCode write_data_block (const uint32_t address, const uint8_t dat[]) const {
+            return this->write_data_blocks(address, 1, dat);
+        }
+
+        PropWare::ErrorCode write_data_blocks (const uint32_t address, const uint32_t count,
+                                               const uint8_t dat[]) const {
+            return this->transfer(true, address, count, const_cast<uint8_t *>(dat));
+        }
+
+        uint16_t get_short (const uint16_t offset, const uint8_t buf[]) const {
+            return (buf[offset + 1] << 8) + buf[offset];
+        }
+
+        uint32_t get_long (const uint16_t offset, const uint8_t buf[]) const {
+            return (buf[offset + 3] << 24) + (buf[offset + 2] << 16) + (buf[offset + 1] << 8) + buf[offset];
+        }
+
+        void write_short (const uint16_t offset, uint8_t buf[], const uint16_t value) const {
+            buf[offset + 1] = value >> 8;
+            buf[offset]     = value;
+        }
+
+        void write_long (const uint16_t offset, uint8_t buf[], const uint32_t value) const {
+            buf[offset + 3] = (uint8_t) (value >> 24);
+            buf[offset + 2] = (uint8_t) (value >> 16);
+            buf[offset + 1] = (uint8_t) (value >> 8);
+            buf[offset]     = (uint8_t) value;
+        }
+
+        uint16_t get_sector_size () const {
+            return SD::SECTOR_SIZE;
+        }
+
+        uint8_t get_sector_size_shift () const {
+            return SD::SECTOR_SIZE_SHIFT;
+        }
+
+        /**
+         * @brief   Engine loop; invoked in the new cog by `AsyncSD::start()`
+         */
+        void run () {
+            // The SPI bus and SD card are constructed here so that only this cog ever sets the pins as outputs
+            SPI spi(this->m_mosi, this->m_miso, this->m_sclk);
+            SD  sd(spi, this->m_mosi, this->m_miso, this->m_sclk, this->m_cs);
+            sd.set_crc_checking(this->m_crcEnabled);
+
+            this->m_startError = sd.start();
+            this->m_ready      = true;
+
+            uint32_t next = 0;
+            while (1) {
+                Request *request = this->find_pending(next);
+                if (NULL != request) {
+                    request->status = ACTIVE;
+
+                    if (this->m_startError)
+                        request->err = this->m_startError;
+                    else if (request->write)
+                        request->err = sd.write_data_blocks(request->address, request->blockCount, request->buffer);
+                    else
+                        request->err = sd.read_data_blocks(request->address, request->blockCount, request->buffer);
+
+                    // Hand the mailbox back only after the result is in place
+                    request->status = DONE;
+                    ++next;
+                }
+            }
+        }
+
+        /**
+         * @brief   Create a human-readable error string
+         *
+         * @param[in]   printer     Printer used for logging the message
+         * @param[in]   err         Error number used to determine error string
+         */
+        static void print_error_str (const Printer &printer, const ErrorCode err) {
+            const uint8_t relativeError = err - BEG_ERROR;
+
+            switch (err) {
+                case COG_START_FAILURE:
+                    printer << "AsyncSD Error " << relativeError << ": Unable to start the engine cog\n";
+                    break;
+                default:
+                    SD::print_error_str(printer, (SD::ErrorCode) err);
+            }
+        }
+
+    private:
+        void init (const Port::Mask mosi, const Port::Mask miso, const Port::Mask sclk, const Port::Mask cs) {
+            this->m_mosi       = mosi;
+            this->m_miso       = miso;
+            this->m_sclk       = sclk;
+            this->m_cs         = cs;
+            this->m_crcEnabled         = false;
+            this->m_submitted          = 0;
+            this->m_cog                = -1;
+            this->m_ready              = false;
+            this->m_startError         = NO_ERROR;
+            this->m_synchronous.status = IDLE;
+
+            for (uint8_t i = 0; i < this->m_ringLength; ++i)
+                this->m_ring[i].status = IDLE;
+        }
+
+        Request *submit (const bool write, const uint32_t address, const uint32_t count, uint8_t buf[]) const {
+            for (uint8_t i = 0; i < this->m_ringLength; ++i) {
+                Request &request = this->m_ring[i];
+                if (IDLE == request.status) {
+                    this->publish(request, write, address, count, buf);
+                    return &request;
+                }
+            }
+            return NULL;
+        }
+
+        void publish (Request &request, const bool write, const uint32_t address, const uint32_t count,
+                      uint8_t buf[]) const {
+            request.write      = write;
+            request.address    = address;
+            request.blockCount = count;
+            request.buffer     = buf;
+            request.err        = NO_ERROR;
+            request.sequence   = this->m_submitted++;
+            // Publishing the status must come last - the engine may pick the request up immediately
+            request.status     = PENDING;
+        }
+
+        /**
+         * @brief   Find the pending mailbox, in the ring or the synchronous one, holding the given request
+         */
+        Request *find_pending (const uint32_t sequence) const {
+            if (PENDING == this->m_synchronous.status && sequence == this->m_synchronous.sequence)
+                return &this->m_synchronous;
+            for (uint8_t i = 0; i < this->m_ringLength; ++i) {
+                Request &request = this->m_ring[i];
+                if (PENDING == request.status && sequence == request.sequence)
+                    return &request;
+            }
+            return NULL;
+        }
+
+        /**
+         * @brief   Wait for the outstanding request (if any) that transfers `buf` in the given direction
+         */
+        PropWare::ErrorCode wait_for_buffer (const bool write, const uint8_t buf[]) const {
+            for (uint8_t i = 0; i < this->m_ringLength; ++i) {
+                Request &request = this->m_ring[i];
+                if (IDLE != request.status && write == request.write && buf == request.buffer)
+                    return this->wait(request);
+            }
+            return NO_ERROR;
+        }
+
+        PropWare::ErrorCode transfer (const bool write, const uint32_t address, const uint32_t count,
+                                      uint8_t buf[]) const {
+            // Only the submitting cog uses this mailbox and it always collects the result, so it is idle here
+            this->publish(this->m_synchronous, write, address, count, buf);
+            return this->wait(this->m_synchronous);
+        }
+
+    private:
+        Request                      *m_ring;
+        const uint8_t                m_ringLength;
+        Port::Mask                   m_mosi;
+        Port::Mask                   m_miso;
+        Port::Mask                   m_sclk;
+        Port::Mask                   m_cs;
+        bool                         m_crcEnabled;
+        mutable uint32_t             m_submitted;
+        mutable Request              m_synchronous;
+        mutable int8_t               m_cog;
+        mutable volatile bool        m_ready;
+        volatile PropWare::ErrorCode m_startError;
+};
+
+}
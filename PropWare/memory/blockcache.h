@@ -0,0 +1,327 @@
+/**
+ * @file        PropWare/memory/blockcache.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/PropWare.h>
+#include <PropWare/memory/blockstorage.h>
+#include <string.h>
+
+namespace PropWare {
+
+/**
+ * @brief   Write-back, least-recently-used block cache that can be placed in front of any other BlockStorage device
+ *
+ * The FAT classes reload the same handful of sectors (FAT, directory and file content) over and over. Wrapping the
+ * physical driver with a cache keeps the most recently used blocks in HUB memory so that those sectors only need to
+ * cross the bus once. Writes are held in the cache until the line is evicted or `BlockCache::flush_all()` is invoked.
+ *
+ * @code
+ * int main () {
+ *     const SD driver;
+ *
+ *     static uint8_t               pool[4 * 512];
+ *     static BlockCache::CacheLine lines[4];
+ *     BlockCache cache(driver, pool, lines, 4);
+ *
+ *     FatFS filesystem(cache);
+ *     filesystem.mount();
+ *
+ *     // ... work with files ...
+ *
+ *     filesystem.unmount(); // Flushes the FAT and then every dirty line in the cache
+ *     return 0;
+ * }
+ * @endcode
+ *
+ * @warning     Any dirty line will be lost if power is removed before `BlockCache::flush_all()` is invoked (either
+ *              directly or via `FatFS::unmount()`)
+ */
+class BlockCache : public BlockStorage {
+    public:
+        /**
+         * @brief   Bookkeeping for a single block held by the cache
+         */
+        struct CacheLine {
+            /** Address of the block on the backing device */
+            uint32_t address;
+            /** Value of the cache's access counter the last time this line was touched */
+            uint32_t lastUsed;
+            /** Set when the line holds a valid copy of a block */
+            bool     valid;
+            /** Set when the line has been modified since it was read from or written to the backing device */
+            bool     dirty;
+        };
+
+    public:
+        /**
+         * @brief       Construct a cache in front of an existing device
+         *
+         * @param[in]   driver      Backing device, such as an instance of PropWare::SD
+         * @param[in]   pool[]      Memory for cached blocks - must be at least `lineCount * driver.get_sector_size()`
+         *                          bytes
+         * @param[in]   lines[]     Bookkeeping array with one entry per block in the pool
+         * @param[in]   lineCount   Number of blocks that fit in `pool`
+         */
+        BlockCache (const BlockStorage &driver, uint8_t pool[], CacheLine lines[], const uint8_t lineCount)
+                : m_driver(&driver),
+                  m_pool(pool),
+                  m_lines(lines),
+                  m_lineCount(lineCount),
+                  m_clock(0),
+                  m_hits(0),
+                  m_misses(0) {
+            this->invalidate_all();
+        }
+
+        /**
+         * @brief   Start the backing device. All lines are invalidated, so no stale data survives a restart
+         */
+        PropWare::ErrorCode start () const {
+            this->invalidate_all();
+            return this->m_driver->start();
+        }
+
+        PropWare::ErrorCode read_data_block (uint32_t address, uint8_t buf[]) const {
+            PropWare::ErrorCode err;
+            const uint16_t      sectorSize = this->get_sector_size();
+
+            CacheLine *line = this->find(address);
+            if (NULL == line) {
+                ++this->m_misses;
+                check_errors(this->allocate(address, line));
+                check_errors(this->m_driver->read_data_block(address, this->get_data(line)));
+                line->valid = true;
+            } else
+                ++this->m_hits;
+
+            this->touch(line);
+            memcpy(buf, this->get_data(line), sectorSize);
+            return 0;
+        }
+
+        PropWare::ErrorCode write_data_block (uint32_t address, const uint8_t dat[]) const {
+            PropWare::ErrorCode err;
+
+            // A full block is being overwritten, so there's no need to read the old contents on a miss
+            CacheLine *line = this->find(address);
+            if (NULL == line) {
+                ++this->m_misses;
+                check_errors(this->allocate(address, line));
+                line->valid = true;
+            } else
+                ++this->m_hits;
+
+            this->touch(line);
+            memcpy(this->get_data(line), dat, this->get_sector_size());
+            line->dirty = true;
+            return 0;
+        }
+
+        /**
+         * @brief   Multi-block reads bypass the cache so that long sequential transfers keep the backing device's
+         *          native multi-block command and do not evict hot lines. Any cached copy in the requested range is
+         *          newer than what the device holds, so it is copied over the freshly read data.
+         */
+        PropWare::ErrorCode read_data_blocks (uint32_t address, uint32_t count, uint8_t buf[]) const {
+            PropWare::ErrorCode err;
+            check_errors(this->m_driver->read_data_blocks(address, count, buf));
+
+            const uint8_t sectorSizeShift = this->get_sector_size_shift();
+            for (uint_fast8_t i = 0; i < this->m_lineCount; ++i) {
+                const CacheLine *line = &this->m_lines[i];
+                if (line->valid && address <= line->address && line->address - address < count)
+                    memcpy(&buf[(line->address - address) << sectorSizeShift], this->get_data(line),
+                           this->get_sector_size());
+            }
+            return 0;
+        }
+
+        /**
+         * @brief   Multi-block writes go straight to the backing device. Cached copies of any block in the range are
+         *          updated and marked clean so that they are never written back over the new data.
+         */
+        PropWare::ErrorCode write_data_blocks (uint32_t address, uint32_t count, const uint8_t dat[]) const {
+            PropWare::ErrorCode err;
+            check_errors(this->m_driver->write_data_blocks(address, count, dat));
+
+            const uint8_t sectorSizeShift = this->get_sector_size_shift();
+            for (uint_fast8_t i = 0; i < this->m_lineCount; ++i) {
+                CacheLine *line = &this->m_lines[i];
+                if (line->valid && address <= line->address && line->address - address < count) {
+                    memcpy(this->get_data(line), &dat[(line->address - address) << sectorSizeShift],
+                           this->get_sector_size());
+                    line->dirty = false;
+                }
+            }
+            return 0;
+        }
+
+        /**
+         * @brief   Write every modified line back to the backing device
+         *
+         * Lines are written in ascending address order to keep the backing device's access pattern as sequential as
+         * possible. Lines remain valid (and therefore cached) after being flushed.
+         *
+         * @return  0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode flush_all () const {
+            PropWare::ErrorCode err;
+
+            CacheLine *next;
+            while (NULL != (next = this->lowest_dirty_line())) {
+                check_errors(this->write_back(next));
+            }
+            return 0;
+        }
+
+        /**
+         * @brief   Drop every line without writing it back to the backing device
+         *
+         * @warning Modified lines will be lost. Call `BlockCache::flush_all()` first unless that is the intent.
+         */
+        void invalidate_all () const {
+            for (uint_fast8_t i = 0; i < this->m_lineCount; ++i) {
+                this->m_lines[i].valid = false;
+                this->m_lines[i].dirty = false;
+            }
+        }
+
+        /**
+         * @brief   Number of reads and writes that were serviced by a line already present in the cache
+         */
+        uint32_t get_hits () const {
+            return this->m_hits;
+        }
+
+        /**
+         * @brief   Number of reads and writes that required a new line to be allocated
+         */
+        uint32_t get_misses () const {
+            return this->m_misses;
+        }
+
+        uint16_t get_short (const uint16_t offset, const uint8_t buf[]) const {
+            return this->m_driver->get_short(offset, buf);
+        }
+
+        uint32_t get_long (const uint16_t offset, const uint8_t buf[]) const {
+            return this->m_driver->get_long(offset, buf);
+        }
+
+        void write_short (const uint16_t offset, uint8_t buf[], const uint16_t value) const {
+            this->m_driver->write_short(offset, buf, value);
+        }
+
+        void write_long (const uint16_t offset, uint8_t buf[], const uint32_t value) const {
+            this->m_driver->write_long(offset, buf, value);
+        }
+
+        uint16_t get_sector_size () const {
+            return this->m_driver->get_sector_size();
+        }
+
+        uint8_t get_sector_size_shift () const {
+            return this->m_driver->get_sector_size_shift();
+        }
+
+    protected:
+        uint8_t *get_data (const CacheLine *line) const {
+            const unsigned int index = (unsigned int) (line - this->m_lines);
+            return &this->m_pool[index << this->get_sector_size_shift()];
+        }
+
+        CacheLine *find (const uint32_t address) const {
+            for (uint_fast8_t i = 0; i < this->m_lineCount; ++i)
+                if (this->m_lines[i].valid && address == this->m_lines[i].address)
+                    return &this->m_lines[i];
+            return NULL;
+        }
+
+        void touch (CacheLine *line) const {
+            line->lastUsed = ++this->m_clock;
+        }
+
+        /**
+         * @brief       Claim a line for a new address, evicting (and writing back, if necessary) the least recently
+         *              used line when no free line is available
+         *
+         * @param[in]   address     Address that the line will hold
+         * @param[out]  line        Claimed line. Its `valid` flag is cleared; the caller is responsible for filling it
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode allocate (const uint32_t address, CacheLine *&line) const {
+            PropWare::ErrorCode err;
+
+            line = &this->m_lines[0];
+            for (uint_fast8_t i = 0; i < this->m_lineCount; ++i) {
+                CacheLine *candidate = &this->m_lines[i];
+                if (!candidate->valid) {
+                    line = candidate;
+                    break;
+                } else if ((this->m_clock - candidate->lastUsed) > (this->m_clock - line->lastUsed))
+                    line = candidate;
+            }
+
+            if (line->valid && line->dirty) {
+                check_errors(this->write_back(line));
+            }
+
+            line->address = address;
+            line->valid   = false;
+            line->dirty   = false;
+            return 0;
+        }
+
+        PropWare::ErrorCode write_back (CacheLine *line) const {
+            PropWare::ErrorCode err;
+            check_errors(this->m_driver->write_data_block(line->address, this->get_data(line)));
+            line->dirty = false;
+            return 0;
+        }
+
+        CacheLine *lowest_dirty_line () const {
+            CacheLine *lowest = NULL;
+            for (uint_fast8_t i = 0; i < this->m_lineCount; ++i) {
+                CacheLine *candidate = &this->m_lines[i];
+                if (candidate->valid && candidate->dirty && (NULL == lowest || candidate->address < lowest->address))
+                    lowest = candidate;
+            }
+            return lowest;
+        }
+
+    protected:
+        const BlockStorage *m_driver;
+        uint8_t            *m_pool;
+        CacheLine          *m_lines;
+        const uint8_t      m_lineCount;
+        /** Incremented on every access; used to find the least recently used line */
+        mutable uint32_t   m_clock;
+        mutable uint32_t   m_hits;
+        mutable uint32_t   m_misses;
+};
+
+}
@@ -27,6 +27,7 @@
 
 #include <PropWare/PropWare.h>
 #include <PropWare/hmi/output/printer.h>
+#include <string.h>
 
 namespace PropWare {
 
@@ -73,6 +74,20 @@ class BlockStorage {
             MetaData *meta;
         };
 
+        /**
+         * @brief   One piece of a scatter/gather transfer: a run of bytes on the device and where it goes in memory
+         */
+        struct Segment {
+            /** Address of the block containing the first byte */
+            uint32_t address;
+            /** Offset of the first byte within block `address`; must be less than the sector size */
+            uint16_t offset;
+            /** Number of consecutive bytes, which may cross any number of block boundaries */
+            size_t   length;
+            /** Destination of the data; must be at least `length` bytes long */
+            uint8_t  *buf;
+        };
+
     public:
         /**
          * @brief   Print the formatted contents of a buffer
@@ -170,6 +185,104 @@ class BlockStorage {
             return this->read_data_block(address, buffer->buf);
         }
 
+        /**
+         * @brief       Read multiple consecutive blocks of data from the device into RAM
+         *
+         * The default implementation simply invokes `BlockStorage::read_data_block` once per block. Devices with a
+         * native multi-block command (such as CMD18 on SD cards) should override this to avoid paying per-block
+         * command overhead.
+         *
+         * @param[in]   address     Address of the first block on the storage device
+         * @param[in]   count       Number of consecutive blocks to read
+         * @param[out]  buf[]       Location in memory to store the blocks - must be at least `count` sectors long
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        virtual ErrorCode read_data_blocks (uint32_t address, uint32_t count, uint8_t buf[]) const {
+            ErrorCode err;
+            while (count--) {
+                check_errors(this->read_data_block(address++, buf));
+                buf += this->get_sector_size();
+            }
+            return 0;
+        }
+
+        /**
+         * @brief       Read any number of byte ranges from the device straight into disjoint buffers
+         *
+         * The default implementation reads each whole block with `BlockStorage::read_data_blocks` directly into the
+         * segment's buffer and bounces partial blocks through `scratch`. Devices able to discard unwanted bytes
+         * on the fly (such as `PropWare::SD`) should override this so that no byte is ever copied, and should stream
+         * a segment that starts exactly where the previous one ended as part of the same transfer.
+         *
+         * @param[in]   segments[]  Ranges to read, in order
+         * @param[in]   count       Number of segments
+         * @param[in]   scratch[]   One block of memory which the device may overwrite
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        virtual ErrorCode read_data_segments (const Segment segments[], size_t count, uint8_t scratch[]) const {
+            ErrorCode      err;
+            const uint16_t sectorSize      = this->get_sector_size();
+            const uint8_t  sectorSizeShift = this->get_sector_size_shift();
+
+            while (count--) {
+                uint32_t address = segments->address;
+                uint16_t offset  = segments->offset;
+                size_t   length  = segments->length;
+                uint8_t  *buf    = segments->buf;
+
+                while (length) {
+                    if (offset || length < sectorSize) {
+                        size_t chunk = sectorSize - offset;
+                        if (chunk > length)
+                            chunk = length;
+                        check_errors(this->read_data_block(address++, scratch));
+                        memcpy(buf, &scratch[offset], chunk);
+                        buf += chunk;
+                        length -= chunk;
+                        offset = 0;
+                    } else {
+                        const uint32_t blocks = length >> sectorSizeShift;
+                        check_errors(this->read_data_blocks(address, blocks, buf));
+                        address += blocks;
+                        buf += blocks << sectorSizeShift;
+                        length -= blocks << sectorSizeShift;
+                    }
+                }
+
+                ++segments;
+            }
+            return 0;
+        }
+
+        /**
+         * @brief       Begin reading a block which will be needed soon
+         *
+         * Devices able to transfer data in the background (such as `PropWare::AsyncSD`) should override this to start
+         * the transfer and return immediately. The default implementation reads the block before returning.
+         *
+         * @param[in]   address     Address of the block on the storage device
+         * @param[out]  buf[]       Location in memory to store the block. It must not be touched until
+         *                          `BlockStorage::wait_for_read_ahead` has returned
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        virtual ErrorCode start_read_ahead (uint32_t address, uint8_t buf[]) const {
+            return this->read_data_block(address, buf);
+        }
+
+        /**
+         * @brief       Block until a read started with `BlockStorage::start_read_ahead` has filled `buf`
+         *
+         * @param[in]   buf[]   Buffer that was passed to `BlockStorage::start_read_ahead`
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        virtual ErrorCode wait_for_read_ahead (const uint8_t buf[]) const {
+            return 0;
+        }
+
         /**
          * @brief       Use a buffer's metadata to determine the address and read data from the storage device into
          *              memory
@@ -207,6 +320,55 @@ class BlockStorage {
             return this->write_data_block(address, buffer->buf);
         }
 
+        /**
+         * @brief       Write multiple consecutive blocks of data to a storage device
+         *
+         * The default implementation simply invokes `BlockStorage::write_data_block` once per block. Devices with a
+         * native multi-block command (such as CMD25 on SD cards) should override this to avoid paying per-block
+         * command overhead.
+         *
+         * @param[in]   address     Address of the first block on the storage device
+         * @param[in]   count       Number of consecutive blocks to write
+         * @param[in]   dat[]       Array of data to be written - must be at least `count` sectors long
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        virtual ErrorCode write_data_blocks (uint32_t address, uint32_t count, const uint8_t dat[]) const {
+            ErrorCode err;
+            while (count--) {
+                check_errors(this->write_data_block(address++, dat));
+                dat += this->get_sector_size();
+            }
+            return 0;
+        }
+
+        /**
+         * @brief       Begin writing a block without waiting for the write to finish
+         *
+         * Devices able to transfer data in the background (such as `PropWare::AsyncSD`) should override this to start
+         * the transfer and return immediately. The default implementation writes the block before returning.
+         *
+         * @param[in]   address     Block address on the storage device
+         * @param[in]   dat[]       Data to be written. It must not be modified until
+         *                          `BlockStorage::wait_for_write_behind` has returned
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        virtual ErrorCode start_write_behind (uint32_t address, const uint8_t dat[]) const {
+            return this->write_data_block(address, dat);
+        }
+
+        /**
+         * @brief       Block until a write started with `BlockStorage::start_write_behind` has finished with `dat`
+         *
+         * @param[in]   dat[]   Data that was passed to `BlockStorage::start_write_behind`
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        virtual ErrorCode wait_for_write_behind (const uint8_t dat[]) const {
+            return 0;
+        }
+
         /**
          * @brief       Flush the contents of a buffer and mark as unmodified
          *
@@ -224,6 +386,18 @@ class BlockStorage {
             return 0;
         }
 
+        /**
+         * @brief       Write any blocks held internally by the device (such as in a PropWare::BlockCache) back to the
+         *              physical media
+         *
+         * Devices without an internal cache have nothing to do and return immediately.
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        virtual ErrorCode flush_all () const {
+            return 0;
+        }
+
         /**
          * @brief       Read a byte from a buffer
          *
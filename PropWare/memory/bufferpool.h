@@ -0,0 +1,185 @@
+/**
+ * @file        PropWare/memory/bufferpool.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/PropWare.h>
+#include <PropWare/memory/blockstorage.h>
+
+namespace PropWare {
+
+/**
+ * @brief   Fixed set of block buffers handed out to files, so that files open at the same time do not evict each
+ *          other's sectors
+ *
+ * Every file that shares a buffer (such as the default, `SHARED_BUFFER`) must flush and reload its sector each time
+ * another file has used the buffer in the meantime. A file constructed with a pool is instead given a buffer of its
+ * own for as long as it exists. Once every buffer in the pool is in use, new files share the buffer with the fewest
+ * users (the one handed out longest ago when there is a tie), and a sharing file moves back to a buffer of its own as
+ * soon as one is released.
+ *
+ * @code
+ * int main () {
+ *     const SD driver;
+ *     FatFS    filesystem(driver);
+ *     filesystem.mount();
+ *
+ *     static uint8_t          pool[3 * 512];
+ *     static BufferPool::Slot slots[3];
+ *     BufferPool buffers(pool, slots, 3);
+ *
+ *     FatFileReader config(filesystem, "config.txt", buffers);
+ *     FatFileWriter events(filesystem, "events.log", buffers);
+ *     FatFileWriter data(filesystem, "data.csv", buffers);
+ *
+ *     // ... none of the three files will reload a sector because of the other two ...
+ *
+ *     return 0;
+ * }
+ * @endcode
+ */
+class BufferPool {
+    public:
+        /**
+         * @brief   Bookkeeping for a single buffer of the pool
+         */
+        struct Slot {
+            /** The buffer itself, as given to files */
+            BlockStorage::Buffer buffer;
+            /** Number of files currently using the buffer */
+            uint8_t              users;
+            /** Value of the pool's counter when the buffer was last handed out */
+            uint32_t             lastAcquired;
+        };
+
+    public:
+        /**
+         * @brief       Construct a pool from caller-provided memory
+         *
+         * @param[in]   pool[]      Memory for the buffers - must be at least `slotCount * sectorSize` bytes
+         * @param[in]   slots[]     Bookkeeping array with one entry per buffer in the pool
+         * @param[in]   slotCount   Number of buffers that fit in `pool`
+         * @param[in]   sectorSize  Size of each buffer, in bytes. Must match the storage device's sector size
+         */
+        BufferPool (uint8_t pool[], Slot slots[], const uint8_t slotCount, const uint16_t sectorSize = 512)
+                : m_slots(slots),
+                  m_slotCount(slotCount),
+                  m_clock(0) {
+            for (uint8_t i = 0; i < slotCount; ++i) {
+                slots[i].buffer.buf  = &pool[i * sectorSize];
+                slots[i].buffer.meta = NULL;
+                slots[i].users        = 0;
+                slots[i].lastAcquired = 0;
+            }
+        }
+
+        /**
+         * @brief   Hand out an unused buffer or, if every buffer is in use, the one that is best shared
+         *
+         * @return  A buffer that the caller must later give back with `BufferPool::release`
+         */
+        BlockStorage::Buffer &acquire () {
+            Slot *choice = &this->m_slots[0];
+            for (uint8_t i = 1; i < this->m_slotCount; ++i) {
+                Slot *candidate = &this->m_slots[i];
+                if (candidate->users < choice->users ||
+                        (candidate->users == choice->users && candidate->lastAcquired < choice->lastAcquired))
+                    choice = candidate;
+            }
+
+            ++choice->users;
+            choice->lastAcquired = ++this->m_clock;
+            return choice->buffer;
+        }
+
+        /**
+         * @brief       Give back a buffer obtained from `BufferPool::acquire`
+         *
+         * @pre         The caller has flushed the buffer and no longer references it through any of its own metadata
+         *
+         * @param[in]   buffer  Buffer that is no longer needed
+         */
+        void release (const BlockStorage::Buffer &buffer) {
+            Slot *slot = this->find(buffer);
+            if (NULL != slot && slot->users)
+                --slot->users;
+        }
+
+        /**
+         * @brief       Trade a shared buffer for one that nobody else is using, if there is such a buffer
+         *
+         * Intended for a file that has just found its sector evicted from a shared buffer: rather than fight over the
+         * same buffer again, it moves to a buffer of its own.
+         *
+         * @pre         Same as `BufferPool::release`, for the buffer being traded away
+         *
+         * @param[in]   buffer  Buffer currently held by the caller
+         *
+         * @return      The buffer the caller should now use, which is `buffer` if it is not shared or no unused
+         *              buffer is available
+         */
+        BlockStorage::Buffer &exchange (BlockStorage::Buffer &buffer) {
+            Slot *current = this->find(buffer);
+            if (NULL == current || 1 >= current->users)
+                return buffer;
+
+            for (uint8_t i = 0; i < this->m_slotCount; ++i) {
+                Slot *candidate = &this->m_slots[i];
+                if (0 == candidate->users) {
+                    --current->users;
+                    ++candidate->users;
+                    candidate->lastAcquired = ++this->m_clock;
+                    return candidate->buffer;
+                }
+            }
+            return buffer;
+        }
+
+        /**
+         * @brief   Number of files using the buffer that is used by the most files
+         */
+        uint8_t get_max_users () const {
+            uint8_t maxUsers = 0;
+            for (uint8_t i = 0; i < this->m_slotCount; ++i)
+                if (maxUsers < this->m_slots[i].users)
+                    maxUsers = this->m_slots[i].users;
+            return maxUsers;
+        }
+
+    protected:
+        Slot *find (const BlockStorage::Buffer &buffer) const {
+            for (uint8_t i = 0; i < this->m_slotCount; ++i)
+                if (&this->m_slots[i].buffer == &buffer)
+                    return &this->m_slots[i];
+            return NULL;
+        }
+
+    protected:
+        Slot          *m_slots;
+        const uint8_t m_slotCount;
+        uint32_t      m_clock;
+};
+
+}
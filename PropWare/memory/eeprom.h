@@ -29,6 +29,12 @@ namespace PropWare {
 
 /**
  * @brief   EEPROM reader/writer
+ *
+ * Writes are split at page boundaries so that long arrays do not wrap around inside the EEPROM's page buffer.
+ * Characters written through the PrintCapable interface (`put_char` and `puts`) are collected in a one-page
+ * write-combining buffer and committed as a single page write once the page fills, a write lands outside of the
+ * buffered run, data is read back, or `flush()` is invoked. Only the commit waits for the previous write cycle to
+ * finish, so printing a string costs one 5 ms write cycle per page rather than one per character.
  */
 class Eeprom: public PrintCapable,
               public ScanCapable {
@@ -37,6 +43,11 @@ class Eeprom: public PrintCapable,
         static const uint16_t DEFAULT_INITIAL_MEMORY_ADDRESS = 32 * 1024;
         /** Standard EEPROM I2C address used for Propeller microcontrollers */
         static const uint8_t  DEFAULT_DEVICE_ADDRESS         = 0x50 << 1;
+        /**
+         * Page size of the 24LC256; the 128-byte pages of the 24LC512 are aligned to it as well, so writes split at
+         * this size never wrap on either part
+         */
+        static const uint8_t  PAGE_SIZE                      = 64;
 
     public:
         /**
@@ -58,7 +69,16 @@ class Eeprom: public PrintCapable,
             : m_driver(&driver),
               m_memoryAddress(initialMemoryAddress),
               m_deviceAddress(deviceAddress),
-              m_autoIncrement(autoIncrement) { }
+              m_autoIncrement(autoIncrement),
+              m_pendingAddress(0),
+              m_pendingLength(0) { }
+
+        /**
+         * @brief   Commit any buffered characters before the object goes away
+         */
+        ~Eeprom () {
+            this->commit();
+        }
 
         /**
          * @brief       Check that the EEPROM is responding
@@ -78,6 +98,8 @@ class Eeprom: public PrintCapable,
          * @returns     True if the data was successfully written, false otherwise
          */
         bool put(const uint16_t address, const uint8_t byte) const {
+            this->commit();
+
             // Wait for any current operation to finish
             while (!this->ping());
 
@@ -87,6 +109,8 @@ class Eeprom: public PrintCapable,
         /**
          * @brief       Place multiple bytes of data into sequential memory locations in EEPROM
          *
+         * The data is written with one I2C transaction per EEPROM page that it touches.
+         *
          * @param[in]   startAddress    Address to store the first byte of data
          * @param[in]   bytes[]         Array of data - no null-terminator necessary
          * @param[in]   length          Number of bytes in the array that should be sent
@@ -94,19 +118,36 @@ class Eeprom: public PrintCapable,
          * @returns     True if the data was successfully written, false otherwise
          */
         bool put(const uint16_t startAddress, const uint8_t bytes[], const size_t length) const {
-            // Wait for any current operation to finish
-            while (!this->ping());
+            this->commit();
+
+            uint16_t address   = startAddress;
+            size_t   remaining = length;
+            while (remaining) {
+                size_t chunk = PAGE_SIZE - (address & (PAGE_SIZE - 1));
+                if (chunk > remaining)
+                    chunk = remaining;
+
+                // Wait for any current operation to finish
+                while (!this->ping());
+
+                if (!this->m_driver->put(this->m_deviceAddress, address, bytes, chunk))
+                    return false;
 
-            return this->m_driver->put(this->m_deviceAddress, startAddress, bytes, length);
+                address += chunk;
+                bytes += chunk;
+                remaining -= chunk;
+            }
+            return true;
         }
 
         /**
          * @see PropWare::PrintCapable::put_char
          *
          * @post    Internal memory address pointer will be incremented
+         * @post    The character may be held in the write-combining buffer until the next commit
          */
         virtual void put_char(const char c) {
-            this->put(this->m_memoryAddress, (uint8_t) c);
+            this->combine(this->m_memoryAddress, (uint8_t) c);
             if (this->m_autoIncrement)
                 ++this->m_memoryAddress;
         }
@@ -115,12 +156,23 @@ class Eeprom: public PrintCapable,
          * @see PropWare::PrintCapable::puts
          *
          * @post    Internal memory address pointer will be incremented by the length of the string
+         * @post    The tail of the string may be held in the write-combining buffer until the next commit
          */
         virtual void puts(const char *string) {
-            const size_t stringLength = strlen(string);
-            this->put(this->m_memoryAddress, (const uint8_t *) string, stringLength);
+            uint16_t address = this->m_memoryAddress;
+            while (*string)
+                this->combine(address++, (uint8_t) *string++);
             if (this->m_autoIncrement)
-                this->m_memoryAddress += stringLength;
+                this->m_memoryAddress = address;
+        }
+
+        /**
+         * @brief       Write any characters held in the write-combining buffer to the EEPROM
+         *
+         * @returns     True if the buffer was empty or successfully written, false otherwise
+         */
+        bool flush() {
+            return this->commit();
         }
 
         /**
@@ -131,6 +183,8 @@ class Eeprom: public PrintCapable,
          * @returns     Data in EEPROM
          */
         uint8_t get(const uint16_t address) const {
+            this->commit();
+
             // Wait for any current operation to finish
             while (!this->ping());
 
@@ -147,6 +201,8 @@ class Eeprom: public PrintCapable,
          * @returns     True if successful, false otherwise
          */
         bool get(const uint16_t address, uint8_t *buffer, const size_t length) const {
+            this->commit();
+
             // Wait for any current operation to finish
             while (!this->ping());
 
@@ -202,10 +258,48 @@ class Eeprom: public PrintCapable,
         }
 
     private:
-        const I2CMaster     *m_driver;
-        uint16_t      m_memoryAddress;
-        const uint8_t m_deviceAddress;
-        bool          m_autoIncrement;
+        /**
+         * @brief   Add a byte to the write-combining buffer, committing the buffer first if the byte is neither inside
+         *          of nor directly following the buffered run within the same page
+         */
+        void combine(const uint16_t address, const uint8_t byte) const {
+            const uint16_t end = this->m_pendingAddress + this->m_pendingLength;
+
+            if (this->m_pendingLength && address >= this->m_pendingAddress && address < end)
+                this->m_pending[address - this->m_pendingAddress] = byte;
+            else {
+                if (!this->m_pendingLength || address != end || !(address & (PAGE_SIZE - 1))) {
+                    this->commit();
+                    this->m_pendingAddress = address;
+                }
+                this->m_pending[this->m_pendingLength++] = byte;
+            }
+        }
+
+        /**
+         * @brief   Write the write-combining buffer to the EEPROM as a single page write
+         */
+        bool commit() const {
+            if (!this->m_pendingLength)
+                return true;
+
+            // Wait for any current operation to finish
+            while (!this->ping());
+
+            const bool result = this->m_driver->put(this->m_deviceAddress, this->m_pendingAddress, this->m_pending,
+                                                    this->m_pendingLength);
+            this->m_pendingLength = 0;
+            return result;
+        }
+
+    private:
+        const I2CMaster  *m_driver;
+        uint16_t         m_memoryAddress;
+        const uint8_t    m_deviceAddress;
+        bool             m_autoIncrement;
+        mutable uint8_t  m_pending[PAGE_SIZE];
+        mutable uint16_t m_pendingAddress;
+        mutable uint8_t  m_pendingLength;
 };
 
 }
@@ -0,0 +1,208 @@
+/**
+ * @file        PropWare/memory/eepromblockstorage.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/PropWare.h>
+#include <PropWare/memory/blockstorage.h>
+#include <PropWare/memory/eeprom.h>
+#include <PropWare/hmi/output/printer.h>
+#include <string.h>
+
+#define EEPROM_BLOCK_STORAGE_ERRORS_BASE 36
+
+namespace PropWare {
+
+/**
+ * @brief   Block storage device backed by the part of an I2C EEPROM which the Propeller does not boot from
+ *
+ * With the standard 64 kB EEPROM, the 32 kB above the boot image hold 64 blocks: enough for a small FAT12 volume of
+ * configuration files that should survive without an SD card. Blocks are written one EEPROM page at a time and pages
+ * whose contents have not changed are skipped, which saves both the 5 ms write cycle and wear on the cells.
+ *
+ * The EEPROM must already contain a formatted volume before it can be mounted.
+ *
+ * @code
+ * int main () {
+ *     const Eeprom       eeprom;
+ *     EepromBlockStorage eepromDisk(eeprom);
+ *
+ *     FatFS filesystem(eepromDisk);
+ *     filesystem.mount();
+ *
+ *     // ... work with files ...
+ *
+ *     filesystem.unmount();
+ *     return 0;
+ * }
+ * @endcode
+ */
+class EepromBlockStorage : public BlockStorage {
+    public:
+        /**
+         * Error codes
+         */
+        typedef enum {
+            /** No error */                        NO_ERROR        = 0,
+            /** First EepromBlockStorage error */  BEG_ERROR       = EEPROM_BLOCK_STORAGE_ERRORS_BASE,
+            /** EepromBlockStorage Error 0 */      INVALID_ADDRESS = BEG_ERROR,
+            /** EepromBlockStorage Error 1 */      READ_FAILED,
+            /** EepromBlockStorage Error 2 */      WRITE_FAILED,
+            /** Last EepromBlockStorage error */   END_ERROR       = WRITE_FAILED
+        } ErrorCode;
+
+        static const uint16_t SECTOR_SIZE         = 512;
+        static const uint8_t  SECTOR_SIZE_SHIFT   = 9;
+        /** Granularity at which unchanged data is skipped */
+        static const uint8_t  DEFAULT_PAGE_SIZE   = Eeprom::PAGE_SIZE;
+        /** Blocks between `Eeprom::DEFAULT_INITIAL_MEMORY_ADDRESS` and the end of a 64 kB EEPROM */
+        static const uint16_t DEFAULT_BLOCK_COUNT = (0x10000 - Eeprom::DEFAULT_INITIAL_MEMORY_ADDRESS) >>
+                SECTOR_SIZE_SHIFT;
+
+    public:
+        /**
+         * @brief       Create a device on a region of EEPROM
+         *
+         * @param[in]   eeprom          EEPROM chip to use
+         * @param[in]   firstAddress    EEPROM address of block 0; must be a multiple of `pageSize`
+         * @param[in]   blockCount      Number of blocks; `firstAddress + blockCount * 512` must not exceed 64 kB
+         * @param[in]   pageSize        Write page size of the EEPROM chip, no larger than `DEFAULT_PAGE_SIZE`
+         */
+        EepromBlockStorage (const Eeprom &eeprom,
+                            const uint16_t firstAddress = Eeprom::DEFAULT_INITIAL_MEMORY_ADDRESS,
+                            const uint16_t blockCount = DEFAULT_BLOCK_COUNT,
+                            const uint8_t pageSize = DEFAULT_PAGE_SIZE)
+                : m_eeprom(&eeprom),
+                  m_firstAddress(firstAddress),
+                  m_blockCount(blockCount),
+                  m_pageSize(pageSize) {
+        }
+
+        /**
+         * @brief   Number of blocks on the device
+         */
+        uint16_t get_block_count () const {
+            return this->m_blockCount;
+        }
+
+        PropWare::ErrorCode start () const {
+            return this->m_eeprom->ping() ? NO_ERROR : READ_FAILED;
+        }
+
+        PropWare::ErrorCode read_data_block (uint32_t address, uint8_t buf[]) const {
+            if (address >= this->m_blockCount)
+                return INVALID_ADDRESS;
+
+            return this->m_eeprom->get(this->eeprom_address(address), buf, SECTOR_SIZE) ? NO_ERROR : READ_FAILED;
+        }
+
+        /**
+         * @brief   Write a block one page at a time, skipping any page which already holds the new data
+         *
+         * @see     PropWare::BlockStorage::write_data_block
+         */
+        PropWare::ErrorCode write_data_block (uint32_t address, const uint8_t dat[]) const {
+            uint8_t current[DEFAULT_PAGE_SIZE];
+
+            if (address >= this->m_blockCount)
+                return INVALID_ADDRESS;
+
+            const uint16_t blockAddress = this->eeprom_address(address);
+            for (uint16_t offset = 0; offset < SECTOR_SIZE; offset += this->m_pageSize) {
+                if (!this->m_eeprom->get(blockAddress + offset, current, this->m_pageSize))
+                    return READ_FAILED;
+                if (memcmp(current, &dat[offset], this->m_pageSize))
+                    if (!this->m_eeprom->put(blockAddress + offset, &dat[offset], this->m_pageSize))
+                        return WRITE_FAILED;
+            }
+
+            return NO_ERROR;
+        }
+
+        uint16_t get_short (const uint16_t offset, const uint8_t buf[]) const {
+            return (buf[offset + 1] << 8) + buf[offset];
+        }
+
+        uint32_t get_long (const uint16_t offset, const uint8_t buf[]) const {
+            return (buf[offset + 3] << 24) + (buf[offset + 2] << 16) + (buf[offset + 1] << 8) + buf[offset];
+        }
+
+        void write_short (const uint16_t offset, uint8_t buf[], const uint16_t value) const {
+            buf[offset + 1] = value >> 8;
+            buf[offset]     = value;
+        }
+
+        void write_long (const uint16_t offset, uint8_t buf[], const uint32_t value) const {
+            buf[offset + 3] = (uint8_t) (value >> 24);
+            buf[offset + 2] = (uint8_t) (value >> 16);
+            buf[offset + 1] = (uint8_t) (value >> 8);
+            buf[offset]     = (uint8_t) value;
+        }
+
+        uint16_t get_sector_size () const {
+            return SECTOR_SIZE;
+        }
+
+        uint8_t get_sector_size_shift () const {
+            return SECTOR_SIZE_SHIFT;
+        }
+
+        /**
+         * @brief   Create a human-readable error string
+         *
+         * @param[in]   printer     Printer used for logging the message
+         * @param[in]   err         Error number used to determine error string
+         */
+        static void print_error_str (const Printer &printer, const ErrorCode err) {
+            const uint8_t relativeError = err - BEG_ERROR;
+
+            switch (err) {
+                case INVALID_ADDRESS:
+                    printer << "EepromBlockStorage Error " << relativeError << ": Address beyond end of device\n";
+                    break;
+                case READ_FAILED:
+                    printer << "EepromBlockStorage Error " << relativeError << ": EEPROM did not acknowledge a read\n";
+                    break;
+                case WRITE_FAILED:
+                    printer << "EepromBlockStorage Error " << relativeError << ": EEPROM did not acknowledge a write\n";
+                    break;
+                default:
+                    return;
+            }
+        }
+
+    private:
+        uint16_t eeprom_address (const uint32_t address) const {
+            return (uint16_t) (this->m_firstAddress + (address << SECTOR_SIZE_SHIFT));
+        }
+
+    private:
+        const Eeprom   *m_eeprom;
+        const uint16_t m_firstAddress;
+        const uint16_t m_blockCount;
+        const uint8_t  m_pageSize;
+};
+
+}
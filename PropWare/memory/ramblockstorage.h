@@ -0,0 +1,204 @@
+/**
+ * @file        PropWare/memory/ramblockstorage.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/PropWare.h>
+#include <PropWare/memory/blockstorage.h>
+#include <PropWare/hmi/output/printer.h>
+#include <string.h>
+
+#define RAM_BLOCK_STORAGE_ERRORS_BASE 32
+
+namespace PropWare {
+
+/**
+ * @brief   Block storage device backed by an array in memory
+ *
+ * Every access is a `memcpy`, so a small, frequently rewritten filesystem (such as one holding configuration files)
+ * costs no bus time at all. The array lives wherever the compiler places it: HUB memory for the LMM and CMM models,
+ * or external memory for the XMM models. It also makes a convenient stand-in for an SD card when testing or
+ * benchmarking the filesystem code.
+ *
+ * The array must already contain a formatted volume before it can be mounted, such as an image copied from an SD
+ * card or compiled into the program.
+ *
+ * @code
+ * int main () {
+ *     static uint8_t  image[64 * 512];
+ *     RamBlockStorage ramDisk(image, 64);
+ *
+ *     // ... fill `image` with a FAT volume ...
+ *
+ *     FatFS filesystem(ramDisk);
+ *     filesystem.mount();
+ *
+ *     // ... work with files ...
+ *
+ *     filesystem.unmount();
+ *     return 0;
+ * }
+ * @endcode
+ */
+class RamBlockStorage : public BlockStorage {
+    public:
+        /**
+         * Error codes
+         */
+        typedef enum {
+            /** No error */                      NO_ERROR        = 0,
+            /** First RamBlockStorage error */   BEG_ERROR       = RAM_BLOCK_STORAGE_ERRORS_BASE,
+            /** RamBlockStorage Error 0 */       INVALID_ADDRESS = BEG_ERROR,
+            /** Last RamBlockStorage error */    END_ERROR       = INVALID_ADDRESS
+        } ErrorCode;
+
+        static const uint16_t SECTOR_SIZE       = 512;
+        static const uint8_t  SECTOR_SIZE_SHIFT = 9;
+
+    public:
+        /**
+         * @brief       Create a device from an existing array
+         *
+         * @param[in]   image[]     Contents of the device - must be at least `blockCount * 512` bytes
+         * @param[in]   blockCount  Number of blocks in `image`
+         */
+        RamBlockStorage (uint8_t image[], const uint32_t blockCount)
+                : m_image(image),
+                  m_blockCount(blockCount) {
+        }
+
+        /**
+         * @brief   Number of blocks on the device
+         */
+        uint32_t get_block_count () const {
+            return this->m_blockCount;
+        }
+
+        PropWare::ErrorCode start () const {
+            return NO_ERROR;
+        }
+
+        PropWare::ErrorCode read_data_block (uint32_t address, uint8_t buf[]) const {
+            return this->read_data_blocks(address, 1, buf);
+        }
+
+        PropWare::ErrorCode read_data_blocks (uint32_t address, uint32_t count, uint8_t buf[]) const {
+            if (!this->contains(address, count))
+                return INVALID_ADDRESS;
+
+            memcpy(buf, this->block(address), count << SECTOR_SIZE_SHIFT);
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   Copy each segment directly out of the array; `scratch` is never used
+         *
+         * @see     PropWare::BlockStorage::read_data_segments
+         */
+        PropWare::ErrorCode read_data_segments (const Segment segments[], size_t count, uint8_t scratch[]) const {
+            while (count--) {
+                const uint32_t blocks = (segments->offset + segments->length + SECTOR_SIZE - 1) >> SECTOR_SIZE_SHIFT;
+                if (!this->contains(segments->address, blocks))
+                    return INVALID_ADDRESS;
+
+                memcpy(segments->buf, this->block(segments->address) + segments->offset, segments->length);
+                ++segments;
+            }
+            return NO_ERROR;
+        }
+
+        PropWare::ErrorCode write_data_block (uint32_t address, const uint8_t dat[]) const {
+            return this->write_data_blocks(address, 1, dat);
+        }
+
+        PropWare::ErrorCode write_data_blocks (uint32_t address, uint32_t count, const uint8_t dat[]) const {
+            if (!this->contains(address, count))
+                return INVALID_ADDRESS;
+
+            memcpy(this->block(address), dat, count << SECTOR_SIZE_SHIFT);
+            return NO_ERROR;
+        }
+
+        uint16_t get_short (const uint16_t offset, const uint8_t buf[]) const {
+            return (buf[offset + 1] << 8) + buf[offset];
+        }
+
+        uint32_t get_long (const uint16_t offset, const uint8_t buf[]) const {
+            return (buf[offset + 3] << 24) + (buf[offset + 2] << 16) + (buf[offset + 1] << 8) + buf[offset];
+        }
+
+        void write_short (const uint16_t offset, uint8_t buf[], const uint16_t value) const {
+            buf[offset + 1] = value >> 8;
+            buf[offset]     = value;
+        }
+
+        void write_long (const uint16_t offset, uint8_t buf[], const uint32_t value) const {
+            buf[offset + 3] = (uint8_t) (value >> 24);
+            buf[offset + 2] = (uint8_t) (value >> 16);
+            buf[offset + 1] = (uint8_t) (value >> 8);
+            buf[offset]     = (uint8_t) value;
+        }
+
+        uint16_t get_sector_size () const {
+            return SECTOR_SIZE;
+        }
+
+        uint8_t get_sector_size_shift () const {
+            return SECTOR_SIZE_SHIFT;
+        }
+
+        /**
+         * @brief   Create a human-readable error string
+         *
+         * @param[in]   printer     Printer used for logging the message
+         * @param[in]   err         Error number used to determine error string
+         */
+        static void print_error_str (const Printer &printer, const ErrorCode err) {
+            const uint8_t relativeError = err - BEG_ERROR;
+
+            switch (err) {
+                case INVALID_ADDRESS:
+                    printer << "RamBlockStorage Error " << relativeError << ": Address beyond the end of the device\n";
+                    break;
+                default:
+                    return;
+            }
+        }
+
+    private:
+        bool contains (const uint32_t address, const uint32_t count) const {
+            return address < this->m_blockCount && count <= this->m_blockCount - address;
+        }
+
+        uint8_t *block (const uint32_t address) const {
+            return &this->m_image[address << SECTOR_SIZE_SHIFT];
+        }
+
+    private:
+        uint8_t        *m_image;
+        const uint32_t m_blockCount;
+};
+
+}
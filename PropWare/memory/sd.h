@@ -30,6 +30,7 @@
 #include <PropWare/serial/spi/spi.h>
 #include <PropWare/gpio/pin.h>
 #include <PropWare/hmi/output/printer.h>
+#include <string.h>
 
 /**
  * @brief   Value is injected by `propeller-load` if set in the configuration file
@@ -54,6 +55,8 @@ extern unsigned char _sd_firstByteResponse;
  * When using PropWare's default SPI class, this allows the entire SPI/SD card/FAT functionality to run in a single cog.
  */
 class SD : public BlockStorage {
+        friend class AsyncSD;
+
     public:
         /**
          * Error codes - preceded by SPI
@@ -68,7 +71,8 @@ class SD : public BlockStorage {
             /** SD Error 4 */         INVALID_INIT,
             /** SD Error 5 */         INVALID_DAT_START_ID,
             /** SD Error 6 */         CMD8_FAILURE,
-            /** Last SD error code */ END_ERROR   = CMD8_FAILURE
+            /** SD Error 7 */         INVALID_CRC,
+            /** Last SD error code */ END_ERROR   = INVALID_CRC
         } ErrorCode;
 
     public:
@@ -83,7 +87,8 @@ class SD : public BlockStorage {
          * card's needs
          */
         SD (SPI &spi = SPI::get_instance())
-                : m_spi(&spi) {
+                : m_spi(&spi),
+                  m_crcEnabled(false) {
             Pin::Mask pins[4];
             unpack_sd_pins((uint32_t *) pins);
 
@@ -108,7 +113,8 @@ class SD : public BlockStorage {
          * @param[in]   cs      Pin mask for chip select
          */
         SD (SPI &spi, const Port::Mask mosi, const Port::Mask miso, const Port::Mask sclk, const Port::Mask cs)
-                : m_spi(&spi) {
+                : m_spi(&spi),
+                  m_crcEnabled(false) {
             this->m_spi->set_mosi(mosi);
             this->m_spi->set_miso(miso);
             this->m_spi->set_sclk(sclk);
@@ -119,6 +125,22 @@ class SD : public BlockStorage {
             this->m_cs.set_dir_out();
         }
 
+        /**
+         * @brief       Protect every transfer with CRCs
+         *
+         * When enabled, `SD::start()` turns on the card's own CRC checking with CMD59. Each command then carries its
+         * CRC7, each data block written carries its CRC16 and each data block read is checked against the CRC16 sent
+         * by the card. A transfer that fails a CRC check at either end is retried up to `CRC_RETRIES` times before
+         * `INVALID_CRC` is returned.
+         *
+         * @param[in]   enabled     True to enable CRC checking
+         *
+         * @pre         Must be invoked before `SD::start()`
+         */
+        void set_crc_checking (const bool enabled) {
+            this->m_crcEnabled = enabled;
+        }
+
         /**
          * @brief       Initialize SD card communication over SPI for 3.3V configuration
          *
@@ -137,6 +159,9 @@ class SD : public BlockStorage {
 
             check_errors(this->activate(response));
 
+            if (this->m_crcEnabled)
+                check_errors(this->enable_crc(response));
+
             check_errors(this->increase_throttle());
 
             // We're finally done initializing everything. Set chip select high again to release the SPI port
@@ -154,43 +179,242 @@ class SD : public BlockStorage {
             return SECTOR_SIZE_SHIFT;
         }
 
+        /**
+         * @brief       Read the card's "Card Specific Data" register
+         *
+         * @param[out]  csd[]   Location in memory with enough space for the 16-byte register
+         *
+         * @return      Returns 0 upon success, error code otherwise (including `INVALID_CRC` if the register was
+         *              corrupted on the way in)
+         */
+        PropWare::ErrorCode read_csd (uint8_t csd[]) const {
+            return this->read_register(CMD_RD_CSD, 0, CSD_LENGTH, csd);
+        }
+
+        /**
+         * @brief       Decode the TRAN_SPEED byte of a CSD register
+         *
+         * @param[in]   tranSpeed   Byte 3 of the CSD register
+         *
+         * @return      Maximum clock frequency, in Hz, that the card supports
+         */
+        static uint32_t decode_tran_speed (const uint8_t tranSpeed) {
+            // Time values are in tenths, units are in tens of Hz; units 4-7 are reserved
+            static const uint8_t  TIME_VALUES[] = {0, 10, 12, 13, 15, 20, 25, 30, 35, 40, 45, 50, 55, 60, 70, 80};
+            static const uint32_t UNITS[]       = {10000, 100000, 1000000, 10000000};
+
+            uint8_t unit = tranSpeed & 0x07;
+            if (3 < unit)
+                unit = 3;
+            return TIME_VALUES[(tranSpeed >> 3) & 0x0f] * UNITS[unit];
+        }
+
+        /**
+         * @brief       CRC-16-CCITT (polynomial 0x1021, initial value 0) which protects each SD data block
+         *
+         * A byte at a time from a 512-byte lookup table, rather than bit by bit, so that checking a sector costs one
+         * table lookup per byte
+         *
+         * @param[in]   dat[]   Data that was transferred
+         * @param[in]   length  Number of bytes in `dat`
+         * @param[in]   crc     CRC of any data preceding `dat` in the same block
+         *
+         * @return      The CRC that the card sent (or expects to receive) with `dat`
+         */
+        static uint16_t crc16 (const uint8_t dat[], size_t length, uint16_t crc = 0) {
+            while (length--)
+                crc = (uint16_t) ((crc << 8) ^ CRC16_TABLE[(crc >> 8) ^ *dat++]);
+            return crc;
+        }
+
+        /**
+         * @brief       CRC7 (polynomial 0x09) which protects each command
+         *
+         * Computed bit by bit: a command is only five bytes long
+         *
+         * @param[in]   cmd     Command byte, including the start and transmission bits
+         * @param[in]   arg     Argument for the command
+         *
+         * @return      7-bit CRC, to be sent shifted left by one with the end bit set
+         */
+        static uint8_t crc7 (const uint8_t cmd, const uint32_t arg) {
+            const uint8_t bytes[] = {cmd, (uint8_t) (arg >> 24), (uint8_t) (arg >> 16), (uint8_t) (arg >> 8),
+                                     (uint8_t) arg};
+            uint8_t       crc     = 0;
+            for (uint8_t i = 0; i < sizeof(bytes); ++i) {
+                uint8_t byte = bytes[i];
+                for (uint8_t bit = 0; bit < 8; ++bit) {
+                    crc <<= 1;
+                    if ((byte ^ crc) & BIT_7)
+                        crc ^= CRC7_POLYNOMIAL;
+                    byte <<= 1;
+                }
+            }
+            return (uint8_t) (crc & 0x7f);
+        }
+
         PropWare::ErrorCode read_data_block (const uint32_t address, uint8_t buf[]) const {
             PropWare::ErrorCode err;
-            uint8_t             temp = 0;
+            uint8_t             retries = CRC_RETRIES;
 
-            // Wait until the SD card is no longer busy
-            while (!temp)
-                temp = (uint8_t) this->m_spi->shift_in(8);
-
-            /**
-             * Special error handling is needed to ensure that, if an error is thrown, chip select is set high again
-             * before returning the error
-             */
-            this->m_cs.clear();
-            this->send_command(CMD_RD_BLOCK, address, CRC_OTHER);
-            err = this->read_block(SECTOR_SIZE, buf);
-            this->m_cs.set();
+            do {
+                // Wait until the SD card is no longer busy
+                this->wait_while_busy();
+
+                /**
+                 * Special error handling is needed to ensure that, if an error is thrown, chip select is set high
+                 * again before returning the error
+                 */
+                this->m_cs.clear();
+                this->send_command(CMD_RD_BLOCK, address, CRC_OTHER);
+                err = this->read_block(SECTOR_SIZE, buf, this->m_crcEnabled);
+                this->m_cs.set();
+            } while (INVALID_CRC == err && retries--);
 
             return err;
         }
 
         PropWare::ErrorCode write_data_block (uint32_t address, const uint8_t dat[]) const {
             PropWare::ErrorCode err;
-            uint8_t             temp = 0;
+            uint8_t             retries = CRC_RETRIES;
 
-            // Wait until the SD card is no longer busy
-            while (!temp)
-                temp = (uint8_t) this->m_spi->shift_in(8);
+            do {
+                // Wait until the SD card is no longer busy
+                this->wait_while_busy();
 
-            this->m_cs.clear();
-            this->send_command(CMD_WR_BLOCK, address, CRC_OTHER);
+                this->m_cs.clear();
+                this->send_command(CMD_WR_BLOCK, address, CRC_OTHER);
+                err = this->write_block(SECTOR_SIZE, dat);
+                this->m_cs.set();
+            } while (INVALID_CRC == err && retries--);
 
-            check_errors(this->write_block(SECTOR_SIZE, dat));
-            this->m_cs.set();
+            return err;
+        }
+
+        /**
+         * @brief   Read consecutive blocks with a single CMD18 (READ_MULTIPLE_BLOCK) transaction
+         *
+         * @see     PropWare::BlockStorage::read_data_blocks
+         */
+        PropWare::ErrorCode read_data_blocks (const uint32_t address, const uint32_t count, uint8_t buf[]) const {
+            if (0 == count)
+                return NO_ERROR;
+            else if (1 == count)
+                return this->read_data_block(address, buf);
+
+            PropWare::ErrorCode err;
+            uint8_t             retries = CRC_RETRIES;
+
+            do {
+                this->wait_while_busy();
+
+                this->m_cs.clear();
+                this->send_command(CMD_RD_MULTI_BLOCK, address, CRC_OTHER);
+                err = this->read_blocks(count, buf);
+
+                // The card must always be told to stop streaming, even if an error occurred mid-transfer
+                const PropWare::ErrorCode stopErr = this->stop_transmission();
+                this->m_cs.set();
+
+                if (!err)
+                    err = stopErr;
+            } while (INVALID_CRC == err && retries--);
+
+            return err;
+        }
+
+        /**
+         * @brief   Stream each segment with a CMD18 (READ_MULTIPLE_BLOCK) transaction, straight into its buffer
+         *
+         * Bytes before a segment's offset and after its end are clocked in and discarded rather than stored, so
+         * `scratch` is never used. A segment which starts exactly where the previous one ended continues the previous
+         * segment's transaction.
+         *
+         * @see     PropWare::BlockStorage::read_data_segments
+         */
+        PropWare::ErrorCode read_data_segments (const Segment segments[], const size_t count, uint8_t scratch[]) const {
+            size_t first = 0;
+            while (first < count) {
+                size_t last = first;
+                while (last + 1 < count && continues(segments[last], segments[last + 1]))
+                    ++last;
+
+                PropWare::ErrorCode err;
+                uint8_t             retries = CRC_RETRIES;
+                do {
+                    this->wait_while_busy();
+
+                    this->m_cs.clear();
+                    this->send_command(CMD_RD_MULTI_BLOCK, segments[first].address, CRC_OTHER);
+                    err = this->read_segments(&segments[first], last - first + 1);
+
+                    // The card must always be told to stop streaming, even if an error occurred mid-transfer
+                    const PropWare::ErrorCode stopErr = this->stop_transmission();
+                    this->m_cs.set();
+
+                    if (!err)
+                        err = stopErr;
+                } while (INVALID_CRC == err && retries--);
+                if (err)
+                    return err;
+
+                first = last + 1;
+            }
 
             return NO_ERROR;
         }
 
+        /**
+         * @brief   Write consecutive blocks with a single CMD25 (WRITE_MULTIPLE_BLOCK) transaction
+         *
+         * The number of blocks is announced beforehand with ACMD23 (SET_WR_BLK_ERASE_COUNT) so that the card can
+         * pre-erase the entire range instead of erasing block by block.
+         *
+         * @see     PropWare::BlockStorage::write_data_blocks
+         */
+        PropWare::ErrorCode write_data_blocks (const uint32_t address, const uint32_t count,
+                                               const uint8_t dat[]) const {
+            if (0 == count)
+                return NO_ERROR;
+            else if (1 == count)
+                return this->write_data_block(address, dat);
+
+            PropWare::ErrorCode err;
+            uint8_t             response[RESPONSE_LEN_R1];
+            uint8_t             firstByte;
+            uint8_t             retries = CRC_RETRIES;
+
+            do {
+                this->wait_while_busy();
+
+                this->m_cs.clear();
+
+                // Pre-erase hint - failure is not fatal, but the card must still respond
+                this->send_command(CMD_APP, 0, CRC_OTHER);
+                if ((err = this->get_response(RESPONSE_LEN_R1, firstByte, response))) {
+                    this->m_cs.set();
+                    return err;
+                }
+                this->send_command(CMD_WR_BLK_ERASE, count, CRC_OTHER);
+                if ((err = this->get_response(RESPONSE_LEN_R1, firstByte, response))) {
+                    this->m_cs.set();
+                    return err;
+                }
+
+                this->send_command(CMD_WR_MULTI_BLOCK, address, CRC_OTHER);
+                err = this->write_blocks(count, dat);
+
+                // Send the stop token regardless of errors so the card leaves the receive-data state
+                const PropWare::ErrorCode stopErr = this->stop_multi_block_write();
+                this->m_cs.set();
+
+                if (!err)
+                    err = stopErr;
+            } while (INVALID_CRC == err && retries--);
+
+            return err;
+        }
+
         uint16_t get_short (const uint16_t offset, const uint8_t buf[]) const {
             return (buf[offset + 1] << 8) + buf[offset];
         }
@@ -243,6 +467,9 @@ class SD : public BlockStorage {
                     printer << "SD Error " << relativeError << ": Invalid data-start ID\n";
                     printer << "\tReceived: " << _sd_firstByteResponse << '\n';
                     break;
+                case INVALID_CRC:
+                    printer << "SD Error " << relativeError << ": Data block failed its CRC check\n";
+                    break;
                 default:
                     return;
             }
@@ -354,20 +581,111 @@ class SD : public BlockStorage {
             return READ_TIMEOUT;
         }
 
+        /**
+         * @brief       Turn on the card's CRC checking with CMD59
+         *
+         * @param[out]  response[]  Scratch space for the response
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        inline PropWare::ErrorCode enable_crc (uint8_t response[]) const {
+            PropWare::ErrorCode err;
+            uint8_t             firstByte;
+
+            this->send_command(CMD_CRC_ON_OFF, ARG_CRC_ON, CRC_OTHER);
+            check_errors(this->get_response(RESPONSE_LEN_R1, firstByte, response));
+            if (RESPONSE_ACTIVE != firstByte)
+                return r1_error(firstByte);
+
+            return NO_ERROR;
+        }
+
         /**
          * @brief   Initialization nearly complete, increase clock speed
+         *
+         * The CSD is read at `FULL_SPEED_SPI` to learn the card's limit (TRAN_SPEED). If the bus could run faster than
+         * that and the card implements the switch command class, high-speed mode is requested with CMD6 and the CSD
+         * is read again. The clock is then raised to the lower of the card's and the bus's limits and verified by
+         * reading the CSD once more: it must pass its CRC check and match the copy read at `FULL_SPEED_SPI`. Each
+         * failure halves the clock, and `FULL_SPEED_SPI` is the final fallback.
          */
         inline PropWare::ErrorCode increase_throttle () const {
+            PropWare::ErrorCode err;
+            uint8_t             csd[CSD_LENGTH];
+            uint8_t             verify[CSD_LENGTH];
+
+            check_errors(this->m_spi->set_clock(FULL_SPEED_SPI));
+            check_errors(this->read_csd(csd));
+
+            const uint32_t busLimit  = SPI::get_max_clock();
+            uint32_t       cardLimit = decode_tran_speed(csd[CSD_TRAN_SPEED]);
+            if (busLimit > cardLimit && (csd[CSD_CCC_HIGH] & CCC_HIGH_SWITCH) && this->switch_to_high_speed()) {
+                check_errors(this->read_csd(csd));
+                cardLimit = decode_tran_speed(csd[CSD_TRAN_SPEED]);
+            }
+
+            uint32_t frequency = busLimit < cardLimit ? busLimit : cardLimit;
+            while (FULL_SPEED_SPI < frequency) {
+                check_errors(this->m_spi->set_clock(frequency));
+                if (NO_ERROR == this->read_csd(verify) && 0 == memcmp(csd, verify, CSD_LENGTH))
+                    return NO_ERROR;
+                frequency >>= 1;
+            }
+
             return this->m_spi->set_clock(FULL_SPEED_SPI);
         }
 
+        /**
+         * @brief   Ask the card to switch to high-speed mode (up to 50 MHz)
+         *
+         * @return  True if the card supports high-speed mode and reported a successful switch
+         */
+        bool switch_to_high_speed () const {
+            uint8_t status[SWITCH_STATUS_LENGTH];
+
+            // Mode 0 only checks whether the function is supported
+            if (this->read_register(CMD_SWITCH_FUNC, ARG_CHECK_HIGH_SPEED, SWITCH_STATUS_LENGTH, status)
+                    || !(status[SWITCH_GROUP1_SUPPORT] & BIT_1))
+                return false;
+
+            if (this->read_register(CMD_SWITCH_FUNC, ARG_SWITCH_HIGH_SPEED, SWITCH_STATUS_LENGTH, status))
+                return false;
+            return HIGH_SPEED_FUNCTION == (status[SWITCH_GROUP1_RESULT] & 0x0f);
+        }
+
+        /**
+         * @brief       Send a command whose response is a data block, such as CMD9 or CMD6, and check its CRC
+         *
+         * @param[in]   cmd     Command to send
+         * @param[in]   arg     Argument for the command
+         * @param[in]   bytes   Length of the data block
+         * @param[out]  dat[]   Location in memory with enough space to store `bytes` bytes of data
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode read_register (const uint8_t cmd, const uint32_t arg, const uint16_t bytes,
+                                           uint8_t dat[]) const {
+            PropWare::ErrorCode err;
+
+            // Wait until the SD card is no longer busy
+            this->wait_while_busy();
+
+            this->m_cs.clear();
+            this->send_command(cmd, arg, CRC_OTHER);
+            err = this->read_block(bytes, dat, true);
+            this->m_cs.set();
+
+            return err;
+        }
+
         /**
          * @brief       Send a command and argument over SPI to the SD card
          *
          * @param[in]   cmd     6-bit value representing the command sent to the
          *                      SD card
          * @param[in]   arg     Any argument applicable to the command
-         * @param[in]   crc     CRC for the command and argument
+         * @param[in]   crc     CRC for the command and argument; Replaced by one computed with `SD::crc7` when CRC
+         *                      checking is enabled
          *
          * @return      Returns 0 for success, else error code
          */
@@ -380,7 +698,10 @@ class SD : public BlockStorage {
             this->m_spi->shift_out(16, arg & WORD_0);
 
             // Send sixth byte - CRC
-            this->m_spi->shift_out(8, crc);
+            if (this->m_crcEnabled)
+                this->m_spi->shift_out(8, (uint32_t) (crc7(cmd, arg) << 1) | 1);
+            else
+                this->m_spi->shift_out(8, crc);
         }
 
         /**
@@ -439,15 +760,17 @@ class SD : public BlockStorage {
          *
          * @param[in]   bytes   Number of bytes to receive
          * @param[out]  dat[]   Location in memory with enough space to store `bytes` bytes of data
+         * @param[in]   verify  Check the data against the CRC16 sent by the card
          *
          * @pre         Chip select must be activated prior to invocation
          *
          * @return      Returns 0 for success, else error code
          */
-        PropWare::ErrorCode read_block (uint16_t bytes, uint8_t dat[]) const {
-            uint8_t  checksum;
-            uint32_t timeout;
-            uint8_t  firstByte;
+        PropWare::ErrorCode read_block (uint16_t bytes, uint8_t dat[], const bool verify = false) const {
+            const uint8_t  *start = dat;
+            const uint16_t length = bytes;
+            uint32_t       timeout;
+            uint8_t        firstByte;
 
             // Read first byte - the R1 response
             timeout = RESPONSE_TIMEOUT + CNT;
@@ -485,26 +808,16 @@ class SD : public BlockStorage {
                             *dat++ = (uint8_t) this->m_spi->shift_in(8);
                         }
 
-                    // Continue reading bytes until you get something that isn't 0xff - it should be the checksum.
-                    timeout = RESPONSE_TIMEOUT + CNT;
-                    do {
-                        checksum = (uint8_t) this->m_spi->shift_in(8);
-
-                        // Check for timeout
-                        if ((timeout - CNT) < SINGLE_BYTE_WIGGLE_ROOM)
-                            return READ_TIMEOUT;
-
-                        // wait for transmission end
-                    } while (0xff == checksum);
-
-                    // The checksum is actually 2 bytes, not 1, so sending a total of 16 high bits takes care of the
-                    // second checksum byte as well as an extra byte for good measure
-                    this->m_spi->shift_out(16, 0xffff);
+                    // The 2-byte checksum immediately follows the data, and an extra byte is sent for good measure
+                    const uint16_t checksum = (uint16_t) this->m_spi->shift_in(16);
+                    this->m_spi->shift_out(8, 0xff);
+                    if (verify && crc16(start, length) != checksum)
+                        return INVALID_CRC;
                 } else {
                     return INVALID_DAT_START_ID;
                 }
             } else
-                return INVALID_RESPONSE;
+                return r1_error(firstByte);
 
             return NO_ERROR;
         }
@@ -518,8 +831,10 @@ class SD : public BlockStorage {
          * @return      Returns 0 upon success, error code otherwise
          */
         PropWare::ErrorCode write_block (uint16_t bytes, const uint8_t dat[]) const {
-            uint32_t timeout;
-            uint8_t  firstByte;
+            // Dummy CRC - ignored by the card unless CRC checking has been enabled
+            const uint16_t crc = this->m_crcEnabled ? crc16(dat, bytes) : (uint16_t) 0xffff;
+            uint32_t       timeout;
+            uint8_t        firstByte;
 
             // Read first byte - the R1 response
             timeout = RESPONSE_TIMEOUT + CNT;
@@ -547,6 +862,7 @@ class SD : public BlockStorage {
                     while (bytes--) {
                         this->m_spi->shift_out(8, *(dat++));
                     }
+                this->m_spi->shift_out(16, crc);
 
                 // Receive and digest response token
                 timeout = RESPONSE_TIMEOUT + CNT;
@@ -559,9 +875,12 @@ class SD : public BlockStorage {
 
                     // wait for transmission end
                 } while (0xff == firstByte);
-                if (RSPNS_TKN_ACCPT != (firstByte & (uint8_t) RSPNS_TKN_BITS))
+                if (RSPNS_TKN_CRC == (firstByte & (uint8_t) RSPNS_TKN_BITS))
+                    return INVALID_CRC;
+                else if (RSPNS_TKN_ACCPT != (firstByte & (uint8_t) RSPNS_TKN_BITS))
                     return INVALID_RESPONSE;
-            }
+            } else
+                return r1_error(firstByte);
 
             // After sending the data, provide the device with clocks signals until it has finished writing data
             // internally
@@ -580,6 +899,302 @@ class SD : public BlockStorage {
             return NO_ERROR;
         }
 
+        /**
+         * @brief   Provide clocks to the card until it releases MISO (no longer busy)
+         */
+        void wait_while_busy () const {
+            uint8_t temp = 0;
+            while (!temp)
+                temp = (uint8_t) this->m_spi->shift_in(8);
+        }
+
+        /**
+         * @brief       Wait for the first non-idle byte from the card
+         *
+         * @param[out]  firstByte   First byte received that was not 0xff
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode wait_for_token (uint8_t &firstByte) const {
+            const uint32_t timeout = RESPONSE_TIMEOUT + CNT;
+            do {
+                firstByte = (uint8_t) this->m_spi->shift_in(8);
+
+                // Check for timeout
+                if (abs(timeout - CNT) < SINGLE_BYTE_WIGGLE_ROOM)
+                    return READ_TIMEOUT;
+
+                // wait for transmission end
+            } while (0xff == firstByte);
+
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Wait for an R1 response, recognized by its most significant bit being clear
+         *
+         * Unlike `wait_for_token()`, bytes other than 0xff are skipped too, so that leftover data from an interrupted
+         * transfer is not mistaken for the response.
+         *
+         * @param[out]  response    First byte with bit 7 clear
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode wait_for_r1 (uint8_t &response) const {
+            const uint32_t timeout = RESPONSE_TIMEOUT + CNT;
+            do {
+                response = (uint8_t) this->m_spi->shift_in(8);
+
+                if (abs(timeout - CNT) < SINGLE_BYTE_WIGGLE_ROOM)
+                    return READ_TIMEOUT;
+            } while (BIT_7 & response);
+
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   Provide clocks to the card until it has finished programming (MISO returns high)
+         *
+         * @return  Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode wait_for_write_complete () const {
+            const uint32_t timeout = RESPONSE_TIMEOUT + CNT;
+            while (0xff != this->m_spi->shift_in(8)) {
+                if (abs(timeout - CNT) < SINGLE_BYTE_WIGGLE_ROOM)
+                    return READ_TIMEOUT;
+            }
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Receive the R1 response to CMD18 followed by `count` data packets
+         *
+         * @param[in]   count   Number of sectors to receive
+         * @param[out]  dat[]   Location in memory with enough space to store `count` sectors
+         *
+         * @pre         Chip select must be activated and CMD18 sent prior to invocation
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode read_blocks (uint32_t count, uint8_t dat[]) const {
+            PropWare::ErrorCode err;
+            uint8_t             token;
+
+            check_errors(this->wait_for_token(token));
+            if (RESPONSE_ACTIVE != token)
+                return r1_error(token);
+
+            while (count--) {
+                check_errors(this->wait_for_token(token));
+                if (DATA_START_ID != token) {
+                    _sd_firstByteResponse = token;
+                    return INVALID_DAT_START_ID;
+                }
+
+                this->m_spi->shift_in_block_mode0_msb_first_fast(dat, SECTOR_SIZE);
+
+                const uint16_t crc = (uint16_t) this->m_spi->shift_in(16);
+                if (this->m_crcEnabled && crc16(dat, SECTOR_SIZE) != crc)
+                    return INVALID_CRC;
+                dat += SECTOR_SIZE;
+            }
+
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Receive the R1 response to CMD18 followed by as many data packets as `segments` need
+         *
+         * @param[in]   segments[]  Segments to fill; each must continue where the previous one ended
+         * @param[in]   count       Number of segments
+         *
+         * @pre         Chip select must be activated and CMD18 sent for the first segment's address prior to
+         *              invocation
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode read_segments (const Segment segments[], size_t count) const {
+            PropWare::ErrorCode err;
+            uint8_t             token;
+            uint16_t            position = SECTOR_SIZE;  // Bytes of the current packet received; none is open yet
+            uint16_t            crc      = 0;
+
+            check_errors(this->wait_for_token(token));
+            if (RESPONSE_ACTIVE != token)
+                return r1_error(token);
+
+            uint16_t skip = segments->offset;
+            while (count--) {
+                uint8_t *buf   = segments->buf;
+                size_t  length = segments->length;
+                ++segments;
+
+                while (length) {
+                    if (SECTOR_SIZE == position) {
+                        check_errors(this->wait_for_token(token));
+                        if (DATA_START_ID != token) {
+                            _sd_firstByteResponse = token;
+                            return INVALID_DAT_START_ID;
+                        }
+                        position = 0;
+                        crc      = 0;
+                    }
+
+                    if (skip) {
+                        crc = this->discard(skip, crc);
+                        position += skip;
+                        skip = 0;
+                    }
+
+                    uint16_t chunk = (uint16_t) (SECTOR_SIZE - position);
+                    if (chunk > length)
+                        chunk = (uint16_t) length;
+                    this->m_spi->shift_in_block_mode0_msb_first_fast(buf, chunk);
+                    if (this->m_crcEnabled)
+                        crc = crc16(buf, chunk, crc);
+                    buf += chunk;
+                    length -= chunk;
+                    position += chunk;
+
+                    if (SECTOR_SIZE == position)
+                        check_errors(this->finish_packet(crc));
+                }
+            }
+
+            // Clock out the rest of a partially used packet so its CRC can still be checked
+            if (SECTOR_SIZE != position) {
+                crc = this->discard(SECTOR_SIZE - position, crc);
+                check_errors(this->finish_packet(crc));
+            }
+
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Clock in and throw away bytes of a data packet
+         *
+         * @param[in]   bytes   Number of bytes to discard
+         * @param[in]   crc     CRC of the packet so far
+         *
+         * @return      CRC of the packet including the discarded bytes (unchanged when CRC checking is disabled)
+         */
+        uint16_t discard (uint16_t bytes, uint16_t crc) const {
+            while (bytes--) {
+                const uint8_t byte = (uint8_t) this->m_spi->shift_in(8);
+                if (this->m_crcEnabled)
+                    crc = crc16(&byte, 1, crc);
+            }
+            return crc;
+        }
+
+        /**
+         * @brief       Receive the CRC which ends a data packet and, if CRC checking is enabled, compare it with the
+         *              CRC of the data received
+         *
+         * @param[in]   crc     CRC of the packet's data
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode finish_packet (const uint16_t crc) const {
+            const uint16_t received = (uint16_t) this->m_spi->shift_in(16);
+            if (this->m_crcEnabled && crc != received)
+                return INVALID_CRC;
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Determine whether a segment starts exactly where the previous one ended
+         *
+         * @param[in]   previous    Segment read first
+         * @param[in]   next        Segment read second
+         *
+         * @return      True if `next` can be streamed as part of the same transaction as `previous`
+         */
+        static bool continues (const Segment &previous, const Segment &next) {
+            const size_t end = previous.offset + previous.length;
+            return 0 == (end & (SECTOR_SIZE - 1)) && 0 == next.offset &&
+                    next.address == previous.address + (end >> SECTOR_SIZE_SHIFT);
+        }
+
+        /**
+         * @brief   Send CMD12 (STOP_TRANSMISSION) and wait for the card to go idle
+         *
+         * @return  Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode stop_transmission () const {
+            PropWare::ErrorCode err;
+            uint8_t             response;
+
+            this->send_command(CMD_STOP_TRANS, 0, CRC_OTHER);
+
+            // A stuff byte always follows CMD12, and data the card was already sending may precede the R1b response
+            this->m_spi->shift_in(8);
+            check_errors(this->wait_for_r1(response));
+            if (RESPONSE_ACTIVE != response) {
+                _sd_firstByteResponse = response;
+                return INVALID_RESPONSE;
+            }
+
+            return this->wait_for_write_complete();
+        }
+
+        /**
+         * @brief       Receive the R1 response to CMD25 and then send `count` data packets
+         *
+         * @param[in]   count   Number of sectors to send
+         * @param[in]   dat[]   Location in memory where data resides
+         *
+         * @pre         Chip select must be activated and CMD25 sent prior to invocation
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode write_blocks (uint32_t count, const uint8_t dat[]) const {
+            PropWare::ErrorCode err;
+            uint8_t             token;
+
+            check_errors(this->wait_for_token(token));
+            if (RESPONSE_ACTIVE != token)
+                return r1_error(token);
+
+            while (count--) {
+                // Dummy CRC - ignored by the card unless CRC checking has been enabled
+                const uint16_t crc = this->m_crcEnabled ? crc16(dat, SECTOR_SIZE) : (uint16_t) 0xffff;
+
+                // One byte gap before each data packet
+                this->m_spi->shift_out(8, 0xff);
+                this->m_spi->shift_out(8, DATA_START_ID_MULTI);
+                this->m_spi->shift_out_block_msb_first_fast(dat, SECTOR_SIZE);
+                dat += SECTOR_SIZE;
+                this->m_spi->shift_out(16, crc);
+
+                check_errors(this->wait_for_token(token));
+                if (RSPNS_TKN_CRC == (token & (uint8_t) RSPNS_TKN_BITS))
+                    return INVALID_CRC;
+                else if (RSPNS_TKN_ACCPT != (token & (uint8_t) RSPNS_TKN_BITS)) {
+                    _sd_firstByteResponse = token;
+                    return INVALID_RESPONSE;
+                }
+
+                check_errors(this->wait_for_write_complete());
+            }
+
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   Send the stop-transmission token that ends a CMD25 transaction and wait for the card to finish
+         *          programming
+         *
+         * @return  Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode stop_multi_block_write () const {
+            this->m_spi->shift_out(8, STOP_TRAN_TOKEN);
+
+            // The card needs one byte before it starts signalling busy
+            this->m_spi->shift_in(8);
+            return this->wait_for_write_complete();
+        }
+
         static void first_byte_expansion (const Printer &printer) {
             if (BIT_0 & _sd_firstByteResponse)
                 printer.puts("\t0: Idle\n");
@@ -600,6 +1215,17 @@ class SD : public BlockStorage {
         }
 
     private:
+        /**
+         * @brief       Record an unexpected R1 response and classify it
+         *
+         * @param[in]   firstByte   R1 response received from the card
+         *
+         * @return      `INVALID_CRC` if the card rejected the command's CRC, otherwise `INVALID_RESPONSE`
+         */
+        static PropWare::ErrorCode r1_error (const uint8_t firstByte) {
+            _sd_firstByteResponse = firstByte;
+            return (R1_COM_CRC_ERROR & firstByte) ? INVALID_CRC : INVALID_RESPONSE;
+        }
 
         static void unpack_sd_pins (uint32_t pins[]) {
             __asm__ volatile (
@@ -633,7 +1259,7 @@ class SD : public BlockStorage {
 
         /** Run SD initialization at 200 kHz */
         static const uint32_t     SPI_INIT_FREQ  = 200000;
-        /** Default frequency to run the SPI module */
+        /** Safe frequency to run the SPI module, and the floor when negotiating a faster one */
         static const uint32_t     FULL_SPEED_SPI = 900000;
         static const SPI::Mode    SPI_MODE       = SPI::Mode::MODE_0;
         static const SPI::BitMode SPI_BITMODE    = SPI::BitMode::MSB_FIRST;
@@ -645,20 +1271,40 @@ class SD : public BlockStorage {
 
         // SD Commands
         static const uint8_t CMD_IDLE           = 0x40 + 0;   // Send card into idle state
+        static const uint8_t CMD_SWITCH_FUNC    = 0x40 + 6;   // Check or switch a card function, such as high speed
         static const uint8_t CMD_INTERFACE_COND = 0x40 + 8;   // Send interface condition and host voltage range
         static const uint8_t CMD_RD_CSD         = 0x40 + 9;   // Request "Card Specific Data" block contents
         static const uint8_t CMD_RD_CID         = 0x40 + 10;  // Request "Card Identification" block contents
+        static const uint8_t CMD_STOP_TRANS     = 0x40 + 12;  // Stop a multi-block read transaction
         static const uint8_t CMD_RD_BLOCK       = 0x40 + 17;  // Request data block
+        static const uint8_t CMD_RD_MULTI_BLOCK = 0x40 + 18;  // Request consecutive data blocks until CMD12
+        static const uint8_t CMD_WR_BLK_ERASE   = 0x40 + 23;  // (ACMD) Number of blocks to pre-erase
         static const uint8_t CMD_WR_BLOCK       = 0x40 + 24;  // Write data block
+        static const uint8_t CMD_WR_MULTI_BLOCK = 0x40 + 25;  // Write consecutive data blocks until stop token
         static const uint8_t CMD_WR_OP          = 0x40 + 41;  // Send operating conditions for SDC
         static const uint8_t CMD_APP            = 0x40 + 55;  // Inform card that following instruction is app specific
         static const uint8_t CMD_READ_OCR       = 0x40 + 58;  // Request "Operating Conditions Register" contents
+        static const uint8_t CMD_CRC_ON_OFF     = 0x40 + 59;  // Turn the card's CRC checking on or off
 
         // SD Arguments
         static const uint32_t HOST_VOLTAGE_3V3 = 0x01;
         static const uint32_t R7_CHECK_PATTERN = 0xAA;
         static const uint32_t ARG_CMD8         = ((HOST_VOLTAGE_3V3 << 8U) | R7_CHECK_PATTERN);
         static const uint32_t ARG_LEN          = 5;
+        static const uint32_t ARG_CRC_ON       = 1;
+        // CMD6 arguments: leave groups 6-2 unchanged and select function 1 (high speed) of group 1
+        static const uint32_t ARG_CHECK_HIGH_SPEED  = 0x00FFFFF1;
+        static const uint32_t ARG_SWITCH_HIGH_SPEED = 0x80FFFFF1;
+
+        // SD registers
+        static const uint8_t CSD_LENGTH            = 16;
+        static const uint8_t CSD_TRAN_SPEED        = 3;
+        static const uint8_t CSD_CCC_HIGH          = 4;       // Command classes 11-4
+        static const uint8_t CCC_HIGH_SWITCH       = BIT_6;   // Command class 10 (switch) within CSD_CCC_HIGH
+        static const uint8_t SWITCH_STATUS_LENGTH  = 64;
+        static const uint8_t SWITCH_GROUP1_SUPPORT = 13;      // Functions 7-0 of group 1 supported
+        static const uint8_t SWITCH_GROUP1_RESULT  = 16;      // Low nibble: function selected for group 1
+        static const uint8_t HIGH_SPEED_FUNCTION   = 1;
 
         // SD CRCs
         static const uint8_t CRC_IDLE      = 0x95;
@@ -667,28 +1313,71 @@ class SD : public BlockStorage {
         static const uint8_t CRC_ACMD      = 0x77;
         static const uint8_t CRC_OTHER     = 0x01;
 
+        static const uint8_t  CRC7_POLYNOMIAL = 0x09;
+        static const uint16_t CRC16_TABLE[256];       // CRC-16-CCITT (polynomial 0x1021) of each byte value
+        static const uint8_t  CRC_RETRIES     = 3;    // Attempts made after the first failed CRC check
+
         // SD Responses
-        static const uint8_t RESPONSE_IDLE   = 0x01;
-        static const uint8_t RESPONSE_ACTIVE = 0x00;
-        static const uint8_t DATA_START_ID   = 0xFE;
-        static const uint8_t RESPONSE_LEN_R1 = 1;
-        static const uint8_t RESPONSE_LEN_R3 = 5;
-        static const uint8_t RESPONSE_LEN_R7 = 5;
-        static const uint8_t RSPNS_TKN_BITS  = 0x0f;
-        static const uint8_t RSPNS_TKN_ACCPT = (0x02U << 1U) | 1U;
-        static const uint8_t RSPNS_TKN_CRC   = (0x05U << 1U) | 1U;
-        static const uint8_t RSPNS_TKN_WR    = (0x06U << 1U) | 1U;
+        static const uint8_t RESPONSE_IDLE       = 0x01;
+        static const uint8_t RESPONSE_ACTIVE     = 0x00;
+        static const uint8_t DATA_START_ID       = 0xFE;
+        static const uint8_t DATA_START_ID_MULTI = 0xFC;  // Data token for each block of a CMD25 transaction
+        static const uint8_t STOP_TRAN_TOKEN     = 0xFD;  // Ends a CMD25 transaction
+        static const uint8_t RESPONSE_LEN_R1     = 1;
+        static const uint8_t RESPONSE_LEN_R3     = 5;
+        static const uint8_t RESPONSE_LEN_R7     = 5;
+        static const uint8_t RSPNS_TKN_BITS      = 0x0f;
+        static const uint8_t RSPNS_TKN_ACCPT     = (0x02U << 1U) | 1U;
+        static const uint8_t RSPNS_TKN_CRC       = (0x05U << 1U) | 1U;
+        static const uint8_t RSPNS_TKN_WR        = (0x06U << 1U) | 1U;
+        static const uint8_t R1_COM_CRC_ERROR    = BIT_3;
 
     private:
         /*******************************
          *** Private Member Variable ***
          *******************************/
-        SPI *m_spi;
-        Pin m_cs;  // Chip select pin
+        SPI  *m_spi;
+        Pin  m_cs;  // Chip select pin
+        bool m_crcEnabled;
 };
 
 const uint32_t SD::RESPONSE_TIMEOUT        = 100 * MILLISECOND;
 const uint32_t SD::SEND_ACTIVE_TIMEOUT     = 500 * MILLISECOND;
 const uint32_t SD::SINGLE_BYTE_WIGGLE_ROOM = 150 * MICROSECOND;
 
+const uint16_t SD::CRC16_TABLE[256] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+        0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+        0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+        0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+        0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+        0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+        0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+        0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+        0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+        0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+        0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+        0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+        0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+        0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+        0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+        0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+        0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+        0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+        0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+        0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+        0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+        0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+        0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+        0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+        0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+        0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+        0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+        0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+        0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+        0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+        0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
 }
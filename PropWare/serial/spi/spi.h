@@ -92,6 +92,13 @@ class SPI : public PrintCapable,
 
     public:
         static const int32_t DEFAULT_FREQUENCY = 100000;
+        /** System clock cycles per bit for the fixed-cycle kernels (five 4-cycle instructions) */
+        static const uint8_t FIXED_CYCLE_DIVISOR = 20;
+        /**
+         * Shortest half-period, in system clock cycles, that the `waitcnt` kernels can keep up with. Any shorter and
+         * `waitcnt` would miss its target and stall for a full rollover of the system counter
+         */
+        static const uint8_t MIN_TIMED_DELAY     = 20;
 
     public:
         /**
@@ -119,7 +126,8 @@ class SPI : public PrintCapable,
         SPI (const Pin::Mask mosi = Pin::Mask::NULL_PIN, const Pin::Mask miso = Pin::Mask::NULL_PIN,
              const Pin::Mask sclk = Pin::Mask::NULL_PIN, const uint32_t frequency = DEFAULT_FREQUENCY,
              const Mode mode = Mode::MODE_0, const BitMode bitmode = BitMode::MSB_FIRST)
-                : m_mode(mode),
+                : m_fixedCycle(false),
+                  m_mode(mode),
                   m_bitmode(bitmode) {
             this->set_mosi(mosi);
             this->set_miso(miso);
@@ -182,20 +190,37 @@ class SPI : public PrintCapable,
             this->m_bitmode = bitmode;
         }
 
+        /**
+         * @brief   Fastest clock the bus can run at: the rate of the fixed-cycle kernels, which toggle the clock as
+         *          fast as the instructions allow rather than timing it with `waitcnt`
+         *
+         * Block transfers (such as `SPI::shift_in_block_mode0_msb_first_fast`) always run at this rate.
+         */
+        static uint32_t get_max_clock () {
+            return CLKFREQ / FIXED_CYCLE_DIVISOR;
+        }
+
         /**
          * @brief       Change the SPI module's clock frequency
          *
-         * @param[in]   frequency   Frequency, in Hz, to run the SPI clock; Must be less than CLKFREQ/20 (for 80 MHz,
-         *                          900 kHz is the fastest I've tested successfully)
+         * Exactly `SPI::get_max_clock()` selects the fixed-cycle kernels for MSB-first transfers (and mode 0 or 2 for
+         * `SPI::shift_in`). Every other transfer is timed with `waitcnt`, which can not run faster than
+         * CLKFREQ / (2 * `MIN_TIMED_DELAY`), so any frequency between that and the maximum is rounded down to it.
+         *
+         * @param[in]   frequency   Frequency, in Hz, to run the SPI clock; Must not be more than
+         *                          `SPI::get_max_clock()`
          *
          * @return      Returns 0 upon success, otherwise error code
          */
         PropWare::ErrorCode set_clock (const uint32_t frequency) {
-            const uint32_t MAX_CLOCK = CLKFREQ / 20;
-            if (MAX_CLOCK < frequency)
+            const uint32_t maxClock = get_max_clock();
+            if (maxClock < frequency)
                 return INVALID_FREQ;
             else {
-                this->m_clkDelay = (CLKFREQ / frequency) >> 1U;
+                this->m_fixedCycle = maxClock == frequency;
+                this->m_clkDelay   = (CLKFREQ / frequency) >> 1U;
+                if (MIN_TIMED_DELAY > this->m_clkDelay)
+                    this->m_clkDelay = MIN_TIMED_DELAY;
                 return NO_ERROR;
             }
         }
@@ -203,10 +228,14 @@ class SPI : public PrintCapable,
         /**
          * @brief       Retrieve the SPI module's clock frequency
          *
-         * @return      Returns 0 upon success, otherwise error code
+         * @return      Clock frequency used for timed transfers, or `SPI::get_max_clock()` if the fixed-cycle
+         *              kernels are selected
          */
         int32_t get_clock () const {
-            return CLKFREQ / (this->m_clkDelay << 1U);
+            if (this->m_fixedCycle)
+                return get_max_clock();
+            else
+                return CLKFREQ / (this->m_clkDelay << 1U);
         }
 
         /**
@@ -224,7 +253,10 @@ class SPI : public PrintCapable,
         void shift_out (uint8_t bits, uint32_t value) const {
             switch (this->m_bitmode) {
                 case BitMode::MSB_FIRST:
-                    this->shift_out_msb_first(bits, value);
+                    if (this->m_fixedCycle)
+                        this->shift_out_msb_first_fast(bits, value);
+                    else
+                        this->shift_out_msb_first(bits, value);
                     break;
                 case BitMode::LSB_FIRST:
                     this->shift_out_lsb_first(bits, value);
@@ -251,7 +283,10 @@ class SPI : public PrintCapable,
             } else {
                 switch (this->m_bitmode) {
                     case BitMode::MSB_FIRST:
-                        return this->shift_in_msb_phs0(bits);
+                        if (this->m_fixedCycle)
+                            return this->shift_in_msb_phs0_fast(bits);
+                        else
+                            return this->shift_in_msb_phs0(bits);
                     case BitMode::LSB_FIRST:
                         return this->shift_in_lsb_phs0(bits);
                 }
@@ -423,6 +458,30 @@ class SPI : public PrintCapable,
 #pragma GCC diagnostic pop
         }
 
+        /**
+         * @brief   Fixed-cycle equivalent of `SPI::shift_out_msb_first`, clocking at `SPI::get_max_clock()`
+         */
+        void shift_out_msb_first_fast (uint32_t bits, uint32_t data) const {
+            __asm__ volatile (
+            FC_START("SpiSendMsbFirstFastStart%=", "SpiSendMsbFirstFastEnd%=")
+                    "       ror %[_data], %[_bitCount]                                                  \n\t"
+
+                    "loop%=:                                                                            \n\t"
+                    "       rol %[_data], #1 wc                                                         \n\t"
+                    "       muxc outa, %[_mosi]                                                         \n\t"
+                    "       xor outa, %[_sclk]                                                          \n\t"
+                    "       xor outa, %[_sclk]                                                          \n\t"
+                    "       djnz %[_bitCount], #" FC_ADDR("loop%=", "SpiSendMsbFirstFastStart%=") "     \n\t"
+
+                    "       or outa, %[_mosi]                                                           \n\t"
+                    FC_END("SpiSendMsbFirstFastEnd%=")
+            : [_bitCount] "+r"(bits),
+            [_data] "+r"(data)
+            : [_mosi] "r"(this->m_mosi.get_mask()),
+            [_sclk] "r"(this->m_sclk.get_mask())
+            );
+        }
+
         void shift_out_lsb_first (uint32_t bits, uint32_t data) const {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wuninitialized"
@@ -485,6 +544,28 @@ class SPI : public PrintCapable,
             return tempData;
         }
 
+        /**
+         * @brief   Fixed-cycle equivalent of `SPI::shift_in_msb_phs0`, clocking at `SPI::get_max_clock()`
+         */
+        uint32_t shift_in_msb_phs0_fast (unsigned int bits) const {
+            unsigned int tempData = 0;
+            __asm__ volatile (
+            FC_START("SpiReadMsbPhs0FastStart%=", "SpiReadMsbPhs0FastEnd%=")
+                    "loop%=:                                                                                \n\t"
+                    "       test %[_miso], ina wc                                                           \n\t"
+                    "       xor outa, %[_sclk]                                                              \n\t"
+                    "       rcl %[_data], #1                                                                \n\t"
+                    "       xor outa, %[_sclk]                                                              \n\t"
+                    "       djnz %[_bitCount], #" FC_ADDR("loop%=", "SpiReadMsbPhs0FastStart%=") "          \n\t"
+                    FC_END("SpiReadMsbPhs0FastEnd%=")
+            : [_bitCount] "+r"(bits),
+            [_data] "+r"(tempData)
+            :[_miso] "r"(this->m_miso.get_mask()),
+            [_sclk] "r"(this->m_sclk.get_mask())
+            );
+            return tempData;
+        }
+
         uint32_t shift_in_lsb_phs0 (const unsigned int bits) const {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wuninitialized"
@@ -593,6 +674,7 @@ class SPI : public PrintCapable,
         PropWare::Pin m_miso;
         PropWare::Pin m_sclk;
         unsigned int  m_clkDelay;
+        bool          m_fixedCycle;
         Mode          m_mode;
         BitMode       m_bitmode;
 };
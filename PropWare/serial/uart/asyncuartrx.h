@@ -0,0 +1,435 @@
+/**
+ * @file        PropWare/serial/uart/asyncuartrx.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/PropWare.h>
+#include <PropWare/concurrent/runnable.h>
+#include <PropWare/serial/uart/uartrx.h>
+#include <PropWare/hmi/input/scancapable.h>
+#include <string.h>
+
+namespace PropWare {
+
+/**
+ * @brief   UART receiver whose bit timing is handled by a dedicated cog
+ *
+ * `PropWare::UARTRX` shifts every bit in from the calling cog, so the caller can do nothing else while it waits for
+ * data. `AsyncUARTRX` starts its own cog (via `PropWare::Runnable`) which calls `UARTRX::receive()` in a loop and
+ * deposits each byte into a ring buffer in HUB RAM. The `UARTRX` instance handed to the constructor supplies the pin,
+ * baud rate, data width and parity, exactly as it would for blocking reception.
+ *
+ * With `RAW` framing, bytes are made available one at a time through `get_char()`, so the object can back a
+ * `PropWare::Scanner`. Every other framing mode assembles complete frames inside the receiver cog and publishes them
+ * to a queue, so the application only needs to wake up for whole messages:
+ *
+ * - `DELIMITED`: a frame ends with the delimiter byte, which is not stored
+ * - `LENGTH_PREFIXED`: a single length byte is followed by that many bytes of payload
+ * - `SLIP`: RFC 1055 framing; escape sequences are decoded in the receiver cog
+ * - `COBS`: Consistent Overhead Byte Stuffing with a zero delimiter; frames are stored decoded
+ *
+ * Empty frames are discarded. A frame is dropped (and counted, see `get_dropped_frames()`) when it does not fit in
+ * the ring buffer, when the frame queue is full, when a parity error occurs or when its encoding is malformed.
+ *
+ * @code
+ * int main () {
+ *     static uint32_t             stack[64];
+ *     static uint8_t              buffer[256];
+ *     static AsyncUARTRX::Frame   frames[8];
+ *     static uint8_t              message[64];
+ *
+ *     const UARTRX receiver(Port::P12);
+ *     AsyncUARTRX  packets(receiver, buffer, frames, stack, AsyncUARTRX::COBS);
+ *     packets.start();
+ *
+ *     while (1) {
+ *         const size_t length = packets.get_frame(message, sizeof(message));
+ *         handle_message(message, length);
+ *     }
+ * }
+ * @endcode
+ *
+ * @note    The receiver cog must finish its per-byte work within the stop bit. In the CMM memory model that limits
+ *          reliable reception to roughly 57,600 baud; LMM comfortably reaches 115,200 baud.
+ *
+ * @warning Only a single cog may consume bytes or frames from any one `AsyncUARTRX` instance
+ */
+class AsyncUARTRX : public Runnable,
+                    public ScanCapable {
+    public:
+        /**
+         * How the received byte stream is split into messages
+         */
+        typedef enum {
+            /** No framing; bytes are read individually */               RAW,
+            /** Frames end with a delimiter byte */                      DELIMITED,
+            /** Frames begin with a one-byte payload length */           LENGTH_PREFIXED,
+            /** RFC 1055 Serial Line Internet Protocol framing */        SLIP,
+            /** Consistent Overhead Byte Stuffing, delimited by zero */  COBS
+        } Framing;
+
+        /**
+         * Location of one complete frame in the ring buffer
+         */
+        struct Frame {
+            /** Free-running index of the frame's first byte */
+            uint32_t start;
+            /** Number of payload bytes */
+            uint32_t length;
+        };
+
+        static const uint8_t SLIP_END     = 0xC0;
+        static const uint8_t SLIP_ESC     = 0xDB;
+        static const uint8_t SLIP_ESC_END = 0xDC;
+        static const uint8_t SLIP_ESC_ESC = 0xDD;
+
+    public:
+        /**
+         * @brief       Construct a receiver which passes individual bytes through to `get_char()`
+         *
+         * @tparam[in]  BUFFER_SIZE     Size of the ring buffer; must be a power of two
+         * @tparam[in]  STACK_SIZE      Number of 32-bit words in the stack
+         * @param[in]   uart            Configured receiver; must outlive this object
+         * @param[in]   buffer          Ring buffer for received bytes
+         * @param[in]   stack           Stack for the receiver cog. Should be at least 64 32-bit words
+         */
+        template<size_t BUFFER_SIZE, size_t STACK_SIZE>
+        AsyncUARTRX (const UARTRX &uart, uint8_t (&buffer)[BUFFER_SIZE], const uint32_t (&stack)[STACK_SIZE])
+                : Runnable(stack),
+                  m_uart(&uart),
+                  m_framing(RAW),
+                  m_delimiter(0),
+                  m_buffer(buffer),
+                  m_bufferMask(BUFFER_SIZE - 1),
+                  m_frames(NULL),
+                  m_frameMask(0) {
+            static_assert(!(BUFFER_SIZE & (BUFFER_SIZE - 1)), "AsyncUARTRX buffer size must be a power of two");
+            this->init();
+        }
+
+        /**
+         * @brief       Construct a receiver which assembles frames
+         *
+         * @tparam[in]  BUFFER_SIZE     Size of the ring buffer; must be a power of two
+         * @tparam[in]  FRAME_COUNT     Length of the frame queue; must be a power of two
+         * @tparam[in]  STACK_SIZE      Number of 32-bit words in the stack
+         * @param[in]   uart            Configured receiver; must outlive this object
+         * @param[in]   buffer          Ring buffer holding the payload of frames that have not yet been read
+         * @param[in]   frames          Queue of complete frames
+         * @param[in]   stack           Stack for the receiver cog. Should be at least 64 32-bit words
+         * @param[in]   framing         Framing mode
+         * @param[in]   delimiter       Byte which ends a frame; only used with `DELIMITED` framing
+         */
+        template<size_t BUFFER_SIZE, size_t FRAME_COUNT, size_t STACK_SIZE>
+        AsyncUARTRX (const UARTRX &uart, uint8_t (&buffer)[BUFFER_SIZE], Frame (&frames)[FRAME_COUNT],
+                     const uint32_t (&stack)[STACK_SIZE], const Framing framing, const uint8_t delimiter = '\n')
+                : Runnable(stack),
+                  m_uart(&uart),
+                  m_framing(framing),
+                  m_delimiter(delimiter),
+                  m_buffer(buffer),
+                  m_bufferMask(BUFFER_SIZE - 1),
+                  m_frames(frames),
+                  m_frameMask(FRAME_COUNT - 1) {
+            static_assert(!(BUFFER_SIZE & (BUFFER_SIZE - 1)), "AsyncUARTRX buffer size must be a power of two");
+            static_assert(!(FRAME_COUNT & (FRAME_COUNT - 1)), "AsyncUARTRX frame count must be a power of two");
+            this->init();
+        }
+
+        /**
+         * @brief   Stop the receiver cog
+         */
+        ~AsyncUARTRX () {
+            this->stop();
+        }
+
+        /**
+         * @brief   Start the receiver cog
+         *
+         * @return  Cog ID of the receiver cog. -1 for failure
+         */
+        int8_t start () {
+            if (0 > this->m_cog)
+                this->m_cog = Runnable::invoke(*this);
+            return this->m_cog;
+        }
+
+        /**
+         * @brief   Stop the receiver cog. Any partially received frame is lost
+         */
+        void stop () {
+            if (-1 != this->m_cog) {
+                cogstop(this->m_cog);
+                this->m_cog = -1;
+            }
+        }
+
+        /**
+         * @brief   Invoked in the receiver cog
+         */
+        void run () {
+            while (1) {
+                const uint32_t word = this->m_uart->receive();
+                if (static_cast<uint32_t>(-1) == word)
+                    this->parity_error();
+                else
+                    this->process((uint8_t) word);
+            }
+        }
+
+        /**
+         * @brief   Find out if a byte is waiting in the ring buffer (`RAW` framing only)
+         */
+        bool receive_ready () const {
+            return this->m_read != this->m_write;
+        }
+
+        /**
+         * @brief   Wait for and return the next byte (`RAW` framing only)
+         *
+         * @see     PropWare::ScanCapable::get_char
+         */
+        virtual char get_char () {
+            while (!this->receive_ready());
+            const char c = this->m_buffer[this->m_read & this->m_bufferMask];
+            ++this->m_read;
+            return c;
+        }
+
+        /**
+         * @brief   Find out if a complete frame is waiting in the queue
+         */
+        bool frame_ready () const {
+            return this->m_frameHead != this->m_frameTail;
+        }
+
+        /**
+         * @brief       Wait for the next complete frame and copy it out of the ring buffer
+         *
+         * @param[out]  buffer      Destination for the frame's payload
+         * @param[in]   size        Size of `buffer`; any longer frame is truncated
+         *
+         * @return      Number of bytes stored in `buffer`
+         */
+        size_t get_frame (uint8_t buffer[], const size_t size) {
+            while (!this->frame_ready());
+
+            const Frame    &frame  = this->m_frames[this->m_frameTail & this->m_frameMask];
+            const uint32_t start   = frame.start & this->m_bufferMask;
+            const size_t   length  = frame.length < size ? frame.length : size;
+            const size_t   toEnd   = this->m_bufferMask + 1 - start;
+            const size_t   first   = length < toEnd ? length : toEnd;
+            memcpy(buffer, &this->m_buffer[start], first);
+            memcpy(&buffer[first], this->m_buffer, length - first);
+
+            this->m_read = frame.start + frame.length;
+            ++this->m_frameTail;
+            return length;
+        }
+
+        /**
+         * @brief   Number of frames which were discarded because they did not fit, arrived with a parity error, or
+         *          were malformed
+         */
+        uint32_t get_dropped_frames () const {
+            return this->m_droppedFrames;
+        }
+
+        /**
+         * @brief   Number of bytes which were discarded because the ring buffer was full or because they arrived with
+         *          a parity error (`RAW` framing only)
+         */
+        uint32_t get_overruns () const {
+            return this->m_overruns;
+        }
+
+    protected:
+        void init () {
+            this->m_cog           = -1;
+            this->m_write         = 0;
+            this->m_read          = 0;
+            this->m_frameStart    = 0;
+            this->m_frameHead     = 0;
+            this->m_frameTail     = 0;
+            this->m_remaining     = 0;
+            this->m_cobsCode      = UINT8_MAX;
+            this->m_escaped       = false;
+            this->m_discarding    = false;
+            this->m_droppedFrames = 0;
+            this->m_overruns      = 0;
+        }
+
+        /**
+         * @brief   Feed one received byte through the framing state machine
+         */
+        void process (const uint8_t byte) {
+            switch (this->m_framing) {
+                case RAW:
+                    if (this->m_write - this->m_read > this->m_bufferMask)
+                        ++this->m_overruns;
+                    else {
+                        this->m_buffer[this->m_write & this->m_bufferMask] = byte;
+                        ++this->m_write;
+                    }
+                    break;
+                case DELIMITED:
+                    if (this->m_delimiter == byte)
+                        this->end_frame();
+                    else
+                        this->append(byte);
+                    break;
+                case LENGTH_PREFIXED:
+                    if (this->m_remaining) {
+                        this->append(byte);
+                        if (!--this->m_remaining)
+                            this->end_frame();
+                    } else
+                        this->m_remaining = byte;
+                    break;
+                case SLIP:
+                    if (SLIP_END == byte)
+                        this->end_frame();
+                    else if (this->m_escaped) {
+                        this->m_escaped = false;
+                        if (SLIP_ESC_END == byte)
+                            this->append(SLIP_END);
+                        else if (SLIP_ESC_ESC == byte)
+                            this->append(SLIP_ESC);
+                        else
+                            this->discard_frame();
+                    } else if (SLIP_ESC == byte)
+                        this->m_escaped = true;
+                    else
+                        this->append(byte);
+                    break;
+                case COBS:
+                    if (!byte) {
+                        if (this->m_remaining)
+                            this->discard_frame();
+                        this->end_frame();
+                    } else if (this->m_remaining) {
+                        this->append(byte);
+                        --this->m_remaining;
+                    } else {
+                        // Every block except the last (and any with the maximum code) was followed by a zero
+                        if (UINT8_MAX != this->m_cobsCode)
+                            this->append(0);
+                        this->m_cobsCode  = byte;
+                        this->m_remaining = byte - 1;
+                    }
+                    break;
+            }
+        }
+
+        /**
+         * @brief   Add a decoded byte to the frame in progress
+         */
+        void append (const uint8_t byte) {
+            if (this->m_discarding)
+                return;
+            else if (this->m_write - this->m_read > this->m_bufferMask)
+                this->discard_frame();
+            else {
+                this->m_buffer[this->m_write & this->m_bufferMask] = byte;
+                ++this->m_write;
+            }
+        }
+
+        /**
+         * @brief   Publish the frame in progress to the queue and reset the decoder for the next one
+         */
+        void end_frame () {
+            if (this->m_discarding)
+                this->m_discarding = false;
+            else if (this->m_write != this->m_frameStart) {
+                if (this->m_frameHead - this->m_frameTail > this->m_frameMask) {
+                    ++this->m_droppedFrames;
+                    this->m_write = this->m_frameStart;
+                } else {
+                    Frame &frame = this->m_frames[this->m_frameHead & this->m_frameMask];
+                    frame.start  = this->m_frameStart;
+                    frame.length = this->m_write - this->m_frameStart;
+                    ++this->m_frameHead;
+                    this->m_frameStart = this->m_write;
+                }
+            }
+
+            this->m_escaped  = false;
+            this->m_cobsCode = UINT8_MAX;
+            if (COBS == this->m_framing)
+                this->m_remaining = 0;
+        }
+
+        /**
+         * @brief   Drop the frame in progress because one of its words arrived with a parity error
+         */
+        void parity_error () {
+            this->discard_frame();
+
+            // The corrupted word still counts towards the length of a length-prefixed frame
+            if (LENGTH_PREFIXED == this->m_framing && this->m_remaining && !--this->m_remaining)
+                this->end_frame();
+        }
+
+        /**
+         * @brief   Throw away the frame in progress and ignore further bytes until the next frame boundary
+         */
+        void discard_frame () {
+            if (RAW == this->m_framing)
+                ++this->m_overruns;
+            else if (!this->m_discarding) {
+                ++this->m_droppedFrames;
+                this->m_discarding = true;
+                this->m_write      = this->m_frameStart;
+            }
+        }
+
+    protected:
+        const UARTRX  *m_uart;
+        const Framing m_framing;
+        const uint8_t m_delimiter;
+        uint8_t       *m_buffer;
+        const size_t  m_bufferMask;
+        Frame         *m_frames;
+        const size_t  m_frameMask;
+        int8_t        m_cog;
+
+        // Written only by the receiver cog
+        volatile uint32_t m_write;
+        uint32_t          m_frameStart;
+        volatile uint32_t m_frameHead;
+        uint32_t          m_remaining;
+        uint8_t           m_cobsCode;
+        bool              m_escaped;
+        bool              m_discarding;
+        volatile uint32_t m_droppedFrames;
+        volatile uint32_t m_overruns;
+
+        // Written only by the consuming cog
+        volatile uint32_t m_read;
+        volatile uint32_t m_frameTail;
+};
+
+}
@@ -0,0 +1,314 @@
+/**
+ * @file        PropWare/serial/uart/buffereduarttx.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/PropWare.h>
+#include <PropWare/concurrent/runnable.h>
+#include <PropWare/serial/uart/uarttx.h>
+#include <PropWare/hmi/output/printcapable.h>
+#include <string.h>
+
+namespace PropWare {
+
+/**
+ * @brief   Buffered `PropWare::PrintCapable` whose characters are transmitted by a dedicated cog
+ *
+ * `PropWare::Printer` calls `put_char()` for every character it formats. With a `PropWare::UARTTX` behind it, each of
+ * those calls waits for the whole word to be shifted out. `BufferedUARTTX` copies characters straight into a ring
+ * buffer in HUB RAM instead. A transmitter cog (started via `PropWare::Runnable`) hands contiguous runs of that ring to
+ * `UARTTX::send_array()`, so `printf()` returns as soon as formatting is done. The `UARTTX` instance handed to the
+ * constructor supplies the pin, baud rate and framing, and may be any subclass such as `PropWare::CounterUARTTX`.
+ *
+ * When the ring is full, the `OverflowPolicy` decides what happens to new characters:
+ *
+ * - `BLOCK`: wait for the transmitter cog to make room; nothing is lost
+ * - `DROP_OLDEST`: overwrite the oldest characters that have not yet been sent
+ * - `DROP_NEWEST`: discard the characters that do not fit
+ *
+ * Characters lost to either drop policy are counted by `get_dropped_bytes()`.
+ *
+ * @code
+ * int main () {
+ *     static uint32_t stack[64];
+ *     static uint8_t  buffer[512];
+ *
+ *     const UARTTX   uart;
+ *     BufferedUARTTX bufferedUart(uart, buffer, stack, BufferedUARTTX::DROP_OLDEST);
+ *     Printer        debug(bufferedUart);
+ *     bufferedUart.start();
+ *
+ *     while (1) {
+ *         const int32_t error = read_sensor() - setpoint;
+ *         update_output(error);
+ *         debug.printf("error = %d\n", error);
+ *     }
+ * }
+ * @endcode
+ *
+ * @note    `start()` takes the TX pin away from the calling cog and `stop()` returns it, so both must be invoked from
+ *          the cog that constructed the `UARTTX` instance
+ *
+ * @warning Only a single cog may print to any one `BufferedUARTTX` instance
+ */
+class BufferedUARTTX : public Runnable,
+                       public PrintCapable {
+    public:
+        /**
+         * What to do with new characters when the ring buffer is full
+         */
+        typedef enum {
+            /** Wait for the transmitter cog to make room */           BLOCK,
+            /** Overwrite the oldest characters not yet transmitted */ DROP_OLDEST,
+            /** Discard the characters that do not fit */              DROP_NEWEST
+        } OverflowPolicy;
+
+        /** Maximum number of bytes copied out of the ring per transmission when the policy is `DROP_OLDEST` */
+        static const size_t CHUNK_SIZE = 16;
+
+    public:
+        /**
+         * @brief       Construct a buffered transmitter
+         *
+         * @tparam[in]  BUFFER_SIZE     Size of the ring buffer; must be a power of two
+         * @tparam[in]  STACK_SIZE      Number of 32-bit words in the stack
+         * @param[in]   uart            Configured transmitter; must outlive this object
+         * @param[in]   buffer          Ring buffer for characters waiting to be transmitted
+         * @param[in]   stack           Stack for the transmitter cog. Should be at least 64 32-bit words
+         * @param[in]   policy          Behavior when the ring buffer is full
+         */
+        template<size_t BUFFER_SIZE, size_t STACK_SIZE>
+        BufferedUARTTX (const UARTTX &uart, uint8_t (&buffer)[BUFFER_SIZE], const uint32_t (&stack)[STACK_SIZE],
+                        const OverflowPolicy policy = BLOCK)
+                : Runnable(stack),
+                  m_uart(&uart),
+                  m_policy(policy),
+                  m_buffer(buffer),
+                  m_bufferMask(BUFFER_SIZE - 1),
+                  m_cog(-1),
+                  m_write(0),
+                  m_reserved(0),
+                  m_read(0),
+                  m_droppedBytes(0) {
+            static_assert(!(BUFFER_SIZE & (BUFFER_SIZE - 1)), "BufferedUARTTX buffer size must be a power of two");
+        }
+
+        /**
+         * @brief   Stop the transmitter cog
+         */
+        ~BufferedUARTTX () {
+            this->stop();
+        }
+
+        /**
+         * @brief   Release the TX pin in the calling cog and start the transmitter cog
+         *
+         * @return  Cog ID of the transmitter cog. -1 for failure
+         */
+        int8_t start () {
+            if (0 > this->m_cog) {
+                // Any cog driving the pin high would hold the line idle, so only the transmitter cog may drive it
+                Pin(this->m_uart->get_tx_mask()).set_dir_in();
+                this->m_cog = Runnable::invoke(*this);
+            }
+            return this->m_cog;
+        }
+
+        /**
+         * @brief   Stop the transmitter cog and return the TX pin to the calling cog. Characters still in the ring are
+         *          not lost, but they will not be sent until the cog is restarted
+         */
+        void stop () {
+            if (-1 != this->m_cog) {
+                cogstop(this->m_cog);
+                this->m_cog = -1;
+
+                const Pin pin(this->m_uart->get_tx_mask());
+                pin.set();
+                pin.set_dir_out();
+            }
+        }
+
+        /**
+         * @brief   Invoked in the transmitter cog
+         */
+        void run () {
+            const Pin pin(this->m_uart->get_tx_mask());
+            pin.set();
+            pin.set_dir_out();
+
+            while (1) {
+                while (this->m_read == this->m_write);
+
+                if (DROP_OLDEST == this->m_policy)
+                    this->send_copy();
+                else
+                    this->send_in_place();
+            }
+        }
+
+        /**
+         * @see PropWare::PrintCapable::put_char
+         */
+        virtual void put_char (const char c) {
+            this->write((const uint8_t *) &c, 1);
+        }
+
+        /**
+         * @see PropWare::PrintCapable::puts
+         */
+        virtual void puts (const char string[]) {
+            this->write((const uint8_t *) string, strlen(string));
+        }
+
+        /**
+         * @brief       Copy a block of bytes into the ring buffer
+         *
+         * @param[in]   data        Bytes to be transmitted
+         * @param[in]   length      Number of bytes in `data`
+         *
+         * @return      Number of bytes accepted; less than `length` only when the policy is `DROP_NEWEST`
+         */
+        size_t write (const uint8_t data[], const size_t length) {
+            size_t written = 0;
+            while (written < length) {
+                const uint32_t head  = this->m_write;
+                const uint32_t index = head & this->m_bufferMask;
+                size_t         span  = length - written;
+
+                if (DROP_OLDEST != this->m_policy) {
+                    const size_t space = this->m_bufferMask + 1 - (head - this->m_read);
+                    if (space)
+                        span = span < space ? span : space;
+                    else if (DROP_NEWEST == this->m_policy) {
+                        this->m_droppedBytes += length - written;
+                        break;
+                    } else
+                        continue;
+                }
+
+                const size_t toEnd = this->m_bufferMask + 1 - index;
+                span = span < toEnd ? span : toEnd;
+
+                // Announce which slots are about to change so that the transmitter cog can skip them
+                this->m_reserved = head + span;
+                memcpy(&this->m_buffer[index], &data[written], span);
+                this->m_write = head + span;
+                written += span;
+            }
+            return written;
+        }
+
+        /**
+         * @brief   Wait until every character in the ring buffer has been transmitted
+         *
+         * @pre     The transmitter cog must be running
+         */
+        void flush () const {
+            while (this->m_read != this->m_write);
+        }
+
+        /**
+         * @brief   Number of bytes which were discarded because the ring buffer was full
+         *
+         * With `DROP_OLDEST`, overwritten bytes are only counted once the transmitter cog gets to them.
+         */
+        uint32_t get_dropped_bytes () const {
+            return this->m_droppedBytes;
+        }
+
+    protected:
+        /**
+         * @brief   Transmit the longest contiguous run of the ring directly from HUB RAM (`BLOCK` and `DROP_NEWEST`)
+         */
+        void send_in_place () {
+            const uint32_t tail      = this->m_read;
+            const uint32_t index     = tail & this->m_bufferMask;
+            const size_t   available = this->m_write - tail;
+            const size_t   toEnd     = this->m_bufferMask + 1 - index;
+            const size_t   length    = available < toEnd ? available : toEnd;
+
+            this->m_uart->send_array((const char *) &this->m_buffer[index], length);
+            this->m_read = tail + length;
+        }
+
+        /**
+         * @brief   Copy up to `CHUNK_SIZE` bytes out of the ring before transmitting them, since the printing cog may
+         *          overwrite the ring at any time (`DROP_OLDEST`)
+         */
+        void send_copy () {
+            uint8_t        chunk[CHUNK_SIZE];
+            const uint32_t tail      = this->skip_overwritten(this->m_read);
+            const size_t   available = this->m_write - tail;
+            const size_t   length    = available < CHUNK_SIZE ? available : CHUNK_SIZE;
+
+            for (size_t i = 0; i < length; ++i)
+                chunk[i] = this->m_buffer[(tail + i) & this->m_bufferMask];
+
+            // Anything the printing cog reached during the copy is not what was written in the first place
+            const uint32_t valid = this->skip_overwritten(tail);
+            if (valid - tail >= length)
+                this->m_read = valid;
+            else {
+                this->m_uart->send_array((const char *) &chunk[valid - tail], length - (valid - tail));
+                this->m_read = tail + length;
+            }
+        }
+
+        /**
+         * @brief       Find the oldest byte that has not been (and is not being) overwritten
+         *
+         * @param[in]   tail    Free-running index of the next byte to be transmitted
+         *
+         * @return      `tail`, or a later index if the printing cog has overtaken it. Any bytes skipped are counted
+         */
+        uint32_t skip_overwritten (const uint32_t tail) {
+            const uint32_t oldest = this->m_reserved - (this->m_bufferMask + 1);
+            if ((int32_t) (oldest - tail) > 0) {
+                this->m_droppedBytes += oldest - tail;
+                return oldest;
+            } else
+                return tail;
+        }
+
+    protected:
+        const UARTTX         *m_uart;
+        const OverflowPolicy m_policy;
+        uint8_t              *m_buffer;
+        const size_t         m_bufferMask;
+        int8_t               m_cog;
+
+        // Written only by the printing cog
+        volatile uint32_t m_write;
+        volatile uint32_t m_reserved;
+
+        // Written only by the transmitter cog
+        volatile uint32_t m_read;
+
+        // Written by the printing cog with DROP_NEWEST and by the transmitter cog with DROP_OLDEST
+        volatile uint32_t m_droppedBytes;
+};
+
+}
@@ -0,0 +1,226 @@
+/**
+ * @file        PropWare/serial/uart/counteruarttx.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/serial/uart/uarttx.h>
+
+namespace PropWare {
+
+/**
+ * @brief   UART transmitter which lets counter A drive the pin, reaching up to one bit every 8 clock cycles
+ *
+ * `PropWare::UARTTX::send_array` spends a `waitcnt`, a `shr` and a `muxc` on every bit, which caps it near
+ * `UART::MAX_BAUD`. This class instead puts CTRA in single-ended NCO mode with `FRQA` at zero, so that the pin simply
+ * follows bit 31 of `PHSA`. Each word is bit-reversed and loaded into `PHSA` with its start and stop bits already in
+ * place, after which a single `shl phsa, #1` per bit moves the next bit onto the pin.
+ *
+ * - Baud rates up to `CLKFREQ / 10` (8 Mbaud at 80 MHz) are timed with `waitcnt`, one instruction pair per bit
+ * - Exactly `CLKFREQ / 8` (10 Mbaud at 80 MHz) runs an unrolled, instruction-timed loop
+ *
+ * No other bit time is possible, so `set_baud_rate` rounds any rate faster than `CLKFREQ / 10` to one of these two.
+ *
+ * Neither loop sends words back to back. The `waitcnt` loop holds every stop bit for one extra bit period, plus the
+ * 30 to 50 clock cycles it takes to fetch and prepare the next byte, so each word occupies 11 bit periods plus that
+ * overhead rather than 10. That is roughly 9% below the nominal byte rate at ordinary baud rates, and about a third
+ * below it at `CLKFREQ / 10`, where the overhead alone is worth another four bits. The unrolled loop stretches each
+ * stop bit by the fetch instead, to roughly 112 clock cycles per word in place of 80. Long stop bits are perfectly
+ * legal UART framing.
+ *
+ * Only 8N1 framing is accelerated; any other configuration falls back to `PropWare::UARTTX::send_array`, as do single
+ * words sent via `send()`/`put_char()`.
+ *
+ * @note    Counter A of the calling cog is borrowed for the duration of each `send_array()` call and its previous
+ *          configuration is restored afterwards
+ */
+class CounterUARTTX : public UARTTX {
+    public:
+        /** Clock cycles per bit of the instruction-timed loop */
+        static const uint32_t MIN_BIT_CYCLES     = 8;
+        /** Fewest clock cycles per bit that the `waitcnt`-timed loop can produce */
+        static const uint32_t MIN_WAITCNT_CYCLES = 10;
+
+    public:
+        CounterUARTTX ()
+                : UARTTX() {
+            this->round_bit_cycles();
+        }
+
+        CounterUARTTX (const Pin::Mask tx)
+                : UARTTX(tx) {
+            this->round_bit_cycles();
+        }
+
+        /**
+         * @brief       Set the baud rate, rounding anything faster than `CLKFREQ / MIN_WAITCNT_CYCLES` to a rate that
+         *              can actually be produced
+         *
+         * A bit time shorter than `MIN_WAITCNT_CYCLES` becomes `MIN_BIT_CYCLES` if it is no longer than that, or
+         * `MIN_WAITCNT_CYCLES` otherwise. `get_baud_rate()` reports the rate in use.
+         *
+         * @param[in]   baudRate    Requested baud rate
+         */
+        void set_baud_rate (const int32_t baudRate) {
+            UARTTX::set_baud_rate(baudRate);
+            this->round_bit_cycles();
+        }
+
+        virtual void send_array (const char array[], uint32_t words) const {
+            if (8 != this->m_dataWidth || Parity::NO_PARITY != this->m_parity || 1 != this->m_stopBitWidth)
+                UARTTX::send_array(array, words);
+            else if (words) {
+                const uint32_t ctrMode = CTR_NCO_SINGLE_ENDED | this->m_pin.get_pin_number();
+                if (MIN_BIT_CYCLES == this->m_bitCycles)
+                    this->shift_out_array_unrolled((const uint8_t *) array, words, ctrMode);
+                else if (MIN_WAITCNT_CYCLES <= this->m_bitCycles)
+                    this->shift_out_array_timed((const uint8_t *) array, words, ctrMode);
+                else
+                    // Only reachable when the rate was set through a reference to the base class
+                    UARTTX::send_array(array, words);
+            }
+        }
+
+    protected:
+        /**
+         * @brief   Round a bit time that neither loop can produce to the nearest one that the unrolled loop or the
+         *          `waitcnt` loop can, preferring the slower rate when halfway between them
+         */
+        void round_bit_cycles () {
+            if (MIN_BIT_CYCLES >= this->m_bitCycles)
+                this->m_bitCycles = MIN_BIT_CYCLES;
+            else if (MIN_WAITCNT_CYCLES > this->m_bitCycles)
+                this->m_bitCycles = MIN_WAITCNT_CYCLES;
+        }
+
+    protected:
+        /** CTRMODE field for single-ended NCO: the pin follows PHSA[31] */
+        static const uint32_t CTR_NCO_SINGLE_ENDED = 0x04 << 26;
+        /** Once shifted into position, the stop bit and idle level for every remaining shift */
+        static const uint32_t STOP_BITS            = (1 << 23) - 1;
+
+        /**
+         * @brief       Shift out an array of 8N1 words with `waitcnt` timing each bit (FCache function)
+         */
+        void shift_out_array_timed (const uint8_t *arrayPtr, uint32_t words, const uint32_t ctrMode) const {
+#ifndef DOXYGEN_IGNORE
+            uint32_t data = 0, waitCycles = 0, savedCtr = 0, savedFrq = 0;
+
+            __asm__ volatile (
+#define SHIFT_BIT "        waitcnt %[_waitCycles], %[_bitCycles]                                     \n\t" \
+                  "        shl phsa, #1                                                              \n\t"
+            FC_START("ShiftOutTimedStart%=", "ShiftOutTimedEnd%=")
+                    "        mov %[_savedCtr], ctra                                                    \n\t"
+                    "        mov %[_savedFrq], frqa                                                    \n\t"
+                    // Idle high through the counter, then hand the pin over to it
+                    "        neg phsa, #1                                                              \n\t"
+                    "        mov frqa, #0                                                              \n\t"
+                    "        mov ctra, %[_ctrMode]                                                     \n\t"
+                    "        andn outa, %[_mask]                                                       \n\t"
+
+                    "byteLoop%=:                                                                       \n\t"
+                    "        rdbyte %[_data], %[_arrayPtr]                                             \n\t"
+                    "        add %[_arrayPtr], #1                                                      \n\t"
+                    // LSB first: reverse the byte, put the start bit in bit 31 and the stop bit below the data
+                    "        rev %[_data], #24                                                         \n\t"
+                    "        shl %[_data], #23                                                         \n\t"
+                    "        or %[_data], %[_stopBits]                                                 \n\t"
+                    "        mov %[_waitCycles], CNT                                                   \n\t"
+                    "        add %[_waitCycles], %[_bitCycles]                                         \n\t"
+                    "        waitcnt %[_waitCycles], %[_bitCycles]                                     \n\t"
+                    "        mov phsa, %[_data]                                                        \n\t"
+                    SHIFT_BIT SHIFT_BIT SHIFT_BIT SHIFT_BIT SHIFT_BIT SHIFT_BIT SHIFT_BIT SHIFT_BIT
+                    // Stop bit
+                    SHIFT_BIT
+                    "        waitcnt %[_waitCycles], %[_bitCycles]                                     \n\t"
+                    "        djnz %[_words], #" FC_ADDR("byteLoop%=", "ShiftOutTimedStart%=") "        \n\t"
+
+                    "        or outa, %[_mask]                                                         \n\t"
+                    "        mov ctra, %[_savedCtr]                                                    \n\t"
+                    "        mov frqa, %[_savedFrq]                                                    \n\t"
+                    FC_END("ShiftOutTimedEnd%=")
+#undef SHIFT_BIT
+            : [_data] "+r"(data),
+            [_waitCycles] "+r"(waitCycles),
+            [_arrayPtr] "+r"(arrayPtr),
+            [_words] "+r"(words),
+            [_savedCtr] "+r"(savedCtr),
+            [_savedFrq] "+r"(savedFrq)
+            : [_mask] "r"(this->m_pin.get_mask()),
+            [_bitCycles] "r"(this->m_bitCycles),
+            [_ctrMode] "r"(ctrMode),
+            [_stopBits] "r"(STOP_BITS));
+#endif
+        }
+
+        /**
+         * @brief       Shift out an array of 8N1 words at exactly `MIN_BIT_CYCLES` per bit (FCache function)
+         *
+         * Every bit is one `shl` followed by a `nop`, so no `waitcnt` is needed to keep time.
+         */
+        void shift_out_array_unrolled (const uint8_t *arrayPtr, uint32_t words, const uint32_t ctrMode) const {
+#ifndef DOXYGEN_IGNORE
+            uint32_t data = 0, savedCtr = 0, savedFrq = 0;
+
+            __asm__ volatile (
+#define SHIFT_BIT "        nop                                                                       \n\t" \
+                  "        shl phsa, #1                                                              \n\t"
+            FC_START("ShiftOutUnrolledStart%=", "ShiftOutUnrolledEnd%=")
+                    "        mov %[_savedCtr], ctra                                                    \n\t"
+                    "        mov %[_savedFrq], frqa                                                    \n\t"
+                    "        neg phsa, #1                                                              \n\t"
+                    "        mov frqa, #0                                                              \n\t"
+                    "        mov ctra, %[_ctrMode]                                                     \n\t"
+                    "        andn outa, %[_mask]                                                       \n\t"
+
+                    "byteLoop%=:                                                                       \n\t"
+                    "        rdbyte %[_data], %[_arrayPtr]                                             \n\t"
+                    "        add %[_arrayPtr], #1                                                      \n\t"
+                    "        rev %[_data], #24                                                         \n\t"
+                    "        shl %[_data], #23                                                         \n\t"
+                    "        or %[_data], %[_stopBits]                                                 \n\t"
+                    "        mov phsa, %[_data]                                                        \n\t"
+                    SHIFT_BIT SHIFT_BIT SHIFT_BIT SHIFT_BIT SHIFT_BIT SHIFT_BIT SHIFT_BIT SHIFT_BIT
+                    // Stop bit; held through the loop overhead that fetches the next byte
+                    SHIFT_BIT
+                    "        djnz %[_words], #" FC_ADDR("byteLoop%=", "ShiftOutUnrolledStart%=") "     \n\t"
+
+                    "        or outa, %[_mask]                                                         \n\t"
+                    "        mov ctra, %[_savedCtr]                                                    \n\t"
+                    "        mov frqa, %[_savedFrq]                                                    \n\t"
+                    FC_END("ShiftOutUnrolledEnd%=")
+#undef SHIFT_BIT
+            : [_data] "+r"(data),
+            [_arrayPtr] "+r"(arrayPtr),
+            [_words] "+r"(words),
+            [_savedCtr] "+r"(savedCtr),
+            [_savedFrq] "+r"(savedFrq)
+            : [_mask] "r"(this->m_pin.get_mask()),
+            [_ctrMode] "r"(ctrMode),
+            [_stopBits] "r"(STOP_BITS));
+#endif
+        }
+};
+
+}
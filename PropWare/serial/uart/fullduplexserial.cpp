@@ -61,8 +61,10 @@ __asm__ (
 "            rdlong  bitticks, t1                                     \n"
 "            add     t1, #4                                           \n"
 "            rdlong  rxbuff, t1                                       \n"
-"            mov     txbuff, rxbuff                                   \n"
-"            add     txbuff, #$10                                     \n"
+"            add     t1, #4                                           \n"
+"            rdlong  txbuff, t1                                       \n"
+"            add     t1, #4                                           \n"
+"            rdlong  bufmask, t1                                      \n"
 "            test    rxtxmode, #4    wz                               \n"
 "            test    rxtxmode, #2    wc                               \n"
 "  if_z_ne_c or      OUTA, txmask                                     \n"
@@ -101,8 +103,17 @@ __asm__ (
 "            wrbyte  rxdata, t2                                       \n"
 "            sub     t2, rxbuff                                       \n"
 "            add     t2, #1                                           \n"
-"            and     t2, #$f                                          \n"
-"            wrlong  t2, PAR                                          \n"
+"            and     t2, bufmask                                      \n"
+"            mov     t1, PAR                                          \n"
+"            add     t1, #4                                           \n"
+"            rdlong  t1, t1                                           \n"
+"            cmp     t2, t1    wz                                     \n"
+"  if_nz     wrlong  t2, PAR                                          \n"
+"  if_z      mov     t1, PAR                                          \n"
+"  if_z      add     t1, #(11 << 2)                                   \n"
+"  if_z      rdlong  t2, t1                                           \n"
+"  if_z      add     t2, #1                                           \n"
+"  if_z      wrlong  t2, t1                                           \n"
 "            jmp     #receive                                         \n"
 "                                                                     \n"
 "transmit                                                             \n"
@@ -118,7 +129,7 @@ __asm__ (
 "            rdbyte  txdata, t3                                       \n"
 "            sub     t3, txbuff                                       \n"
 "            add     t3, #1                                           \n"
-"            and     t3, #$f                                          \n"
+"            and     t3, bufmask                                      \n"
 "            wrlong  t3, t1                                           \n"
 "            or      txdata, #$100                                    \n"
 "            shl     txdata, #2                                       \n"
@@ -168,6 +179,9 @@ __asm__ (
 "rxbuff                                                               \n"
 "            .res    1                                                \n"
 "                                                                     \n"
+"bufmask                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
 "rxdata                                                               \n"
 "            .res    1                                                \n"
 "                                                                     \n"
@@ -31,16 +31,26 @@
 #include <PropWare/serial/uart/uartcommondata.h>
 #include <PropWare/hmi/output/printcapable.h>
 #include <PropWare/hmi/input/scancapable.h>
+#include <string.h>
 
 namespace PropWare {
 
 void *get_full_duplex_serial_driver ();
 
+class FullDuplexSerial4Port;
+
 /**
- * @brief   Converted to C++ using spin2cpp and then modified to become a PrintCapable object in PropWare's arsenal.
+ * @brief   Buffered, full-duplex UART port serviced by a PASM driver cog
+ *
+ * Holds everything the driver cog shares with the calling cog: the ring buffers' head and tail indices, the pin
+ * configuration and pointers to the buffers themselves. The buffers are provided by PropWare::BasicFullDuplexSerial,
+ * which also knows how to start a dedicated driver cog; PropWare::FullDuplexSerial4Port can instead service up to four
+ * ports from a single cog.
  */
-class FullDuplexSerial : public PrintCapable,
-                         public ScanCapable {
+class FullDuplexSerialPort : public PrintCapable,
+                             public ScanCapable {
+    friend class FullDuplexSerial4Port;
+
     public:
         typedef enum {
             INVERT_RX            = BIT_0,
@@ -49,50 +59,12 @@ class FullDuplexSerial : public PrintCapable,
             IGNORE_TX_ECHO_ON_RX = BIT_3
         } Mode;
 
-        static const size_t BUFFER_SIZE = 16;
-
     public:
         /**
-         * Construct a full-duplex, buffered UART instance
-         *
-         * This object requires a dedicated cog to run the driver code. The driver must be started by invoking
-         * PropWare::FullDuplexSerial::start() on this object.
-         *
-         * @param rxPinNumber   Pin number to receive data
-         * @param txPinNumber   Pin number to transmit data
-         * @param mode          Combination of some, none, or all of the Mode values which can change the behavior of
-         *                      the device
-         * @param baudrate      Baudrate to run the transmit and recieve routines
-         */
-        FullDuplexSerial (const int rxPinNumber = _cfg_rxpin, const int txPinNumber = _cfg_txpin,
-                          const uint32_t mode = 0, const int baudrate = _cfg_baudrate)
-                : m_transmitLock(locknew()),
-                  m_stringLock(locknew()),
-                  m_cogID(-1),
-                  m_receivePinNumber(rxPinNumber),
-                  m_transmitPinNumber(txPinNumber),
-                  m_mode(mode),
-                  m_bitTicks(CLKFREQ / baudrate),
-                  m_bufferPointer((uint32_t) this->m_receiveBuffer) {
-        }
-
-        /**
-         * @brief   Stop the driver cog and return the locks
+         * @brief   Return the lock
          */
-        ~FullDuplexSerial () {
-            if (-1 != this->m_cogID)
-                cogstop(this->m_cogID);
+        ~FullDuplexSerialPort () {
             lockret(this->m_transmitLock);
-            lockret(this->m_stringLock);
-        }
-
-        /**
-         * @brief   Start the driver cog
-         *
-         * @return  Cog ID of the driver cog. -1 for failure
-         */
-        int start () {
-            return this->m_cogID = cognew(get_full_duplex_serial_driver(), (int32_t) (&this->m_receiveHead));
         }
 
         /**
@@ -122,7 +94,7 @@ class FullDuplexSerial : public PrintCapable,
         bool get_char_non_blocking (char &c) {
             if (this->receive_ready()) {
                 c = this->m_receiveBuffer[this->m_receiveTail];
-                this->m_receiveTail = (this->m_receiveTail + 1) & 0xf;
+                this->m_receiveTail = (this->m_receiveTail + 1) & this->m_bufferMask;
                 return true;
             } else
                 return false;
@@ -153,28 +125,152 @@ class FullDuplexSerial : public PrintCapable,
         void put_char (const char c) {
             // Send byte (may wait for room in buffer)
             while (lockset(this->m_transmitLock));
-            while (this->m_transmitTail == ((this->m_transmitHead + 1) & 0xf));
+            while (this->m_transmitTail == ((this->m_transmitHead + 1) & this->m_bufferMask));
             this->m_transmitBuffer[this->m_transmitHead] = c;
-            this->m_transmitHead = (this->m_transmitHead + 1) & 0xf;
+            this->m_transmitHead = (this->m_transmitHead + 1) & this->m_bufferMask;
             lockclr(this->m_transmitLock);
             if (this->m_mode & IGNORE_TX_ECHO_ON_RX)
                 this->get_char();
         }
 
         void puts (const char string[]) {
-            const unsigned int length = strlen(string);
-            while (lockset(this->m_stringLock));
-            for (unsigned int i = 0; i < length; i++)
-                this->put_char((string++)[0]);
-            lockclr(this->m_stringLock);
+            this->write((const uint8_t *) string, strlen(string));
+        }
+
+        /**
+         * @brief       Queue a block of bytes for transmission (may wait for room in the buffer)
+         *
+         * The transmit lock is taken once for the whole block, so the bytes are never interleaved with those of
+         * another cog, and each contiguous span of free buffer space is filled with a single copy.
+         *
+         * In IGNORE_TX_ECHO_ON_RX mode, each byte's echo is read before the next byte is queued, just as with
+         * `put_char`. Queueing the whole block first would let a block longer than the receive buffer overrun it,
+         * leaving this method waiting forever for echoes that the driver cog had already dropped.
+         *
+         * @param[in]   data        Bytes to be sent
+         * @param[in]   length      Number of bytes in `data`
+         */
+        void write (const uint8_t data[], const size_t length) {
+            size_t written = 0;
+
+            while (lockset(this->m_transmitLock));
+            if (this->m_mode & IGNORE_TX_ECHO_ON_RX) {
+                for (; written < length; ++written) {
+                    while (this->m_transmitTail == ((this->m_transmitHead + 1) & this->m_bufferMask));
+                    this->m_transmitBuffer[this->m_transmitHead] = data[written];
+                    this->m_transmitHead = (this->m_transmitHead + 1) & this->m_bufferMask;
+                    this->get_char();
+                }
+            } else {
+                while (written < length) {
+                    const uint32_t head = this->m_transmitHead;
+
+                    // One slot always stays empty so that a full buffer can be told apart from an empty one
+                    size_t span = (this->m_transmitTail - head - 1) & this->m_bufferMask;
+                    if (span) {
+                        span = this->clamp_span(span, head, length - written);
+                        memcpy(&this->m_transmitBuffer[head], &data[written], span);
+                        this->m_transmitHead = (head + span) & this->m_bufferMask;
+                        written += span;
+                    }
+                }
+            }
+            lockclr(this->m_transmitLock);
+        }
+
+        /**
+         * @brief       Read a block of bytes, copying each contiguous span of the receive buffer at once
+         *
+         * @param[out]  buffer      Destination for received bytes
+         * @param[in]   length      Maximum number of bytes to read
+         * @param[in]   timeout     Timeout (in clock ticks), measured from the start of the call, after which the
+         *                          function returns with whatever has been received
+         *
+         * @return      Number of bytes stored in `buffer`
+         */
+        size_t read (uint8_t buffer[], const size_t length, const unsigned int timeout) {
+            const unsigned int startTime = CNT;
+            size_t             received  = 0;
+
+            while (received < length) {
+                const uint32_t tail = this->m_receiveTail;
+                size_t         span = (this->m_receiveHead - tail) & this->m_bufferMask;
+                if (span) {
+                    span = this->clamp_span(span, tail, length - received);
+                    memcpy(&buffer[received], &this->m_receiveBuffer[tail], span);
+                    this->m_receiveTail = (tail + span) & this->m_bufferMask;
+                    received += span;
+                } else if ((CNT - startTime) >= timeout)
+                    break;
+            }
+            return received;
+        }
+
+        /**
+         * @brief   Number of bytes the driver cog has dropped because the receive buffer was full
+         */
+        uint32_t get_receive_overruns () const {
+            return this->m_receiveOverruns;
+        }
+
+        /**
+         * @brief   Reset the receive overrun counter
+         *
+         * @note    An overrun that the driver cog records at the same moment may be lost
+         */
+        void clear_receive_overruns () {
+            this->m_receiveOverruns = 0;
+        }
+
+    protected:
+        /**
+         * @param[in]   receiveBuffer   Ring buffer filled by the driver cog
+         * @param[in]   transmitBuffer  Ring buffer drained by the driver cog
+         * @param[in]   bufferSize      Size of each buffer, which must be a power of two
+         * @param[in]   rxPinNumber     Pin number to receive data
+         * @param[in]   txPinNumber     Pin number to transmit data
+         * @param[in]   mode            Combination of Mode values
+         * @param[in]   baudrate        Baudrate to run the transmit and receive routines
+         */
+        FullDuplexSerialPort (char receiveBuffer[], char transmitBuffer[], const size_t bufferSize,
+                              const int rxPinNumber, const int txPinNumber, const uint32_t mode, const int baudrate)
+                : m_transmitLock(locknew()),
+                  m_receiveBuffer(receiveBuffer),
+                  m_transmitBuffer(transmitBuffer),
+                  m_receiveHead(0),
+                  m_receiveTail(0),
+                  m_transmitHead(0),
+                  m_transmitTail(0),
+                  m_receivePinNumber(rxPinNumber),
+                  m_transmitPinNumber(txPinNumber),
+                  m_mode(mode),
+                  m_bitTicks(CLKFREQ / baudrate),
+                  m_receiveBufferPointer((uint32_t) receiveBuffer),
+                  m_transmitBufferPointer((uint32_t) transmitBuffer),
+                  m_bufferMask(bufferSize - 1),
+                  m_receiveOverruns(0) {
+        }
+
+        /**
+         * @brief   Address of the block of longs read by the driver cog
+         */
+        int32_t mailbox () const {
+            return (int32_t) &this->m_receiveHead;
+        }
+
+        /**
+         * @brief   Shorten a span of the ring buffer so that it neither wraps nor exceeds the bytes requested
+         */
+        size_t clamp_span (const size_t span, const uint32_t index, const size_t requested) const {
+            const size_t toEnd  = this->m_bufferMask + 1 - index;
+            const size_t result = span < toEnd ? span : toEnd;
+            return result < requested ? result : requested;
         }
 
     protected:
         const uint8_t m_transmitLock;
-        const uint8_t m_stringLock;
-        int32_t       m_cogID;
-        char          m_receiveBuffer[BUFFER_SIZE];
-        char          m_transmitBuffer[BUFFER_SIZE];
+        char          *m_receiveBuffer;
+        char          *m_transmitBuffer;
 
         // These variables must appear in this order. The assembly code relies on the exact order
         volatile uint32_t m_receiveHead;
@@ -185,7 +281,72 @@ class FullDuplexSerial : public PrintCapable,
         const int         m_transmitPinNumber;
         const uint32_t    m_mode;
         const uint32_t    m_bitTicks;
-        const uint32_t    m_bufferPointer;
+        const uint32_t    m_receiveBufferPointer;
+        const uint32_t    m_transmitBufferPointer;
+        const uint32_t    m_bufferMask;
+        volatile uint32_t m_receiveOverruns;
+};
+
+/**
+ * @brief   Converted to C++ using spin2cpp and then modified to become a PrintCapable object in PropWare's arsenal.
+ *
+ * @param   <N>     Depth of both the receive and transmit buffers. Must be a power of two; deeper buffers let the
+ *                  consuming cog fall further behind at high baudrates before received bytes are lost.
+ */
+template<size_t N>
+class BasicFullDuplexSerial : public FullDuplexSerialPort {
+    static_assert(N >= 2 && !(N & (N - 1)), "FullDuplexSerial buffer size must be a power of two");
+
+    public:
+        static const size_t BUFFER_SIZE = N;
+
+    public:
+        /**
+         * Construct a full-duplex, buffered UART instance
+         *
+         * This object requires a dedicated cog to run the driver code. The driver must be started by invoking
+         * PropWare::BasicFullDuplexSerial::start() on this object, unless the port is instead handed to a
+         * PropWare::FullDuplexSerial4Port.
+         *
+         * @param rxPinNumber   Pin number to receive data
+         * @param txPinNumber   Pin number to transmit data
+         * @param mode          Combination of some, none, or all of the Mode values which can change the behavior of
+         *                      the device
+         * @param baudrate      Baudrate to run the transmit and recieve routines
+         */
+        BasicFullDuplexSerial (const int rxPinNumber = _cfg_rxpin, const int txPinNumber = _cfg_txpin,
+                               const uint32_t mode = 0, const int baudrate = _cfg_baudrate)
+                : FullDuplexSerialPort(this->m_receiveBufferStorage, this->m_transmitBufferStorage, N, rxPinNumber,
+                                       txPinNumber, mode, baudrate),
+                  m_cogID(-1) {
+        }
+
+        /**
+         * @brief   Stop the driver cog
+         */
+        ~BasicFullDuplexSerial () {
+            if (-1 != this->m_cogID)
+                cogstop(this->m_cogID);
+        }
+
+        /**
+         * @brief   Start the driver cog
+         *
+         * @return  Cog ID of the driver cog. -1 for failure
+         */
+        int start () {
+            return this->m_cogID = cognew(get_full_duplex_serial_driver(), this->mailbox());
+        }
+
+    protected:
+        int32_t m_cogID;
+        char    m_receiveBufferStorage[N];
+        char    m_transmitBufferStorage[N];
 };
 
+/**
+ * @brief   The original FullDuplexSerial, with 16-byte buffers
+ */
+typedef BasicFullDuplexSerial<16> FullDuplexSerial;
+
 }
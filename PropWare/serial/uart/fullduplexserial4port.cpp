@@ -0,0 +1,741 @@
+/**
+ * @file    PropWare/serial/uart/fullduplexserial4port.cpp
+ *
+ * @author  Chip Gracey
+ * @author  Jeff Martin
+ *
+ * Assembly code from Full-Duplex Serial Driver, replicated for four ports sharing one cog
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>2006-2009 Parallax, Inc.<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdint.h>
+
+
+extern uint8_t _load_start_FullDuplexSerial4Port_cog[];
+
+namespace PropWare {
+
+void *get_full_duplex_serial_4port_driver () {
+    return _load_start_FullDuplexSerial4Port_cog;
+}
+
+}
+
+__asm__ (
+"            .section .FullDuplexSerial4Port.cog, \"ax\"              \n"
+"            .compress off                                            \n"
+"..start                                                              \n"
+"            .org    0                                                \n"
+"                                                                     \n"
+"entry                                                                \n"
+"            mov     rxcode0, #((rxidle0-..start)/4)                  \n"
+"            mov     txcode0, #((txidle0-..start)/4)                  \n"
+"            mov     rxcode1, #((rxidle1-..start)/4)                  \n"
+"            mov     txcode1, #((txidle1-..start)/4)                  \n"
+"            mov     rxcode2, #((rxidle2-..start)/4)                  \n"
+"            mov     txcode2, #((txidle2-..start)/4)                  \n"
+"            mov     rxcode3, #((rxidle3-..start)/4)                  \n"
+"            mov     txcode3, #((txidle3-..start)/4)                  \n"
+"            mov     t3, PAR                                          \n"
+"                                                                     \n"
+"            rdlong  mbox0, t3    wz                                  \n"
+"            add     t3, #4                                           \n"
+"  if_z      jmp     #init1                                           \n"
+"            mov     t1, mbox0                                        \n"
+"            add     t1, #(4 << 2)                                    \n"
+"            rdlong  t2, t1                                           \n"
+"            mov     rxmask0, #1                                      \n"
+"            shl     rxmask0, t2                                      \n"
+"            cmps    t2, #0    wc                                     \n"
+"  if_nc     mov     rxcode0, #((receive0-..start)/4)                 \n"
+"            add     t1, #4                                           \n"
+"            rdlong  t2, t1                                           \n"
+"            mov     txmask0, #1                                      \n"
+"            shl     txmask0, t2                                      \n"
+"            cmps    t2, #0    wc                                     \n"
+"  if_c      mov     txmask0, #0                                      \n"
+"            add     t1, #4                                           \n"
+"            rdlong  rxtxmode0, t1                                    \n"
+"            add     t1, #4                                           \n"
+"            rdlong  bitticks0, t1                                    \n"
+"            add     t1, #4                                           \n"
+"            rdlong  rxbuff0, t1                                      \n"
+"            add     t1, #4                                           \n"
+"            rdlong  txbuff0, t1                                      \n"
+"            add     t1, #4                                           \n"
+"            rdlong  bufmask0, t1                                     \n"
+"            test    rxtxmode0, #4    wz                              \n"
+"            test    rxtxmode0, #2    wc                              \n"
+"  if_z_ne_c or      OUTA, txmask0                                    \n"
+"  if_z      or      DIRA, txmask0                                    \n"
+"            mov     txcode0, #((transmit0-..start)/4)                \n"
+"                                                                     \n"
+"init1                                                                \n"
+"            rdlong  mbox1, t3    wz                                  \n"
+"            add     t3, #4                                           \n"
+"  if_z      jmp     #init2                                           \n"
+"            mov     t1, mbox1                                        \n"
+"            add     t1, #(4 << 2)                                    \n"
+"            rdlong  t2, t1                                           \n"
+"            mov     rxmask1, #1                                      \n"
+"            shl     rxmask1, t2                                      \n"
+"            cmps    t2, #0    wc                                     \n"
+"  if_nc     mov     rxcode1, #((receive1-..start)/4)                 \n"
+"            add     t1, #4                                           \n"
+"            rdlong  t2, t1                                           \n"
+"            mov     txmask1, #1                                      \n"
+"            shl     txmask1, t2                                      \n"
+"            cmps    t2, #0    wc                                     \n"
+"  if_c      mov     txmask1, #0                                      \n"
+"            add     t1, #4                                           \n"
+"            rdlong  rxtxmode1, t1                                    \n"
+"            add     t1, #4                                           \n"
+"            rdlong  bitticks1, t1                                    \n"
+"            add     t1, #4                                           \n"
+"            rdlong  rxbuff1, t1                                      \n"
+"            add     t1, #4                                           \n"
+"            rdlong  txbuff1, t1                                      \n"
+"            add     t1, #4                                           \n"
+"            rdlong  bufmask1, t1                                     \n"
+"            test    rxtxmode1, #4    wz                              \n"
+"            test    rxtxmode1, #2    wc                              \n"
+"  if_z_ne_c or      OUTA, txmask1                                    \n"
+"  if_z      or      DIRA, txmask1                                    \n"
+"            mov     txcode1, #((transmit1-..start)/4)                \n"
+"                                                                     \n"
+"init2                                                                \n"
+"            rdlong  mbox2, t3    wz                                  \n"
+"            add     t3, #4                                           \n"
+"  if_z      jmp     #init3                                           \n"
+"            mov     t1, mbox2                                        \n"
+"            add     t1, #(4 << 2)                                    \n"
+"            rdlong  t2, t1                                           \n"
+"            mov     rxmask2, #1                                      \n"
+"            shl     rxmask2, t2                                      \n"
+"            cmps    t2, #0    wc                                     \n"
+"  if_nc     mov     rxcode2, #((receive2-..start)/4)                 \n"
+"            add     t1, #4                                           \n"
+"            rdlong  t2, t1                                           \n"
+"            mov     txmask2, #1                                      \n"
+"            shl     txmask2, t2                                      \n"
+"            cmps    t2, #0    wc                                     \n"
+"  if_c      mov     txmask2, #0                                      \n"
+"            add     t1, #4                                           \n"
+"            rdlong  rxtxmode2, t1                                    \n"
+"            add     t1, #4                                           \n"
+"            rdlong  bitticks2, t1                                    \n"
+"            add     t1, #4                                           \n"
+"            rdlong  rxbuff2, t1                                      \n"
+"            add     t1, #4                                           \n"
+"            rdlong  txbuff2, t1                                      \n"
+"            add     t1, #4                                           \n"
+"            rdlong  bufmask2, t1                                     \n"
+"            test    rxtxmode2, #4    wz                              \n"
+"            test    rxtxmode2, #2    wc                              \n"
+"  if_z_ne_c or      OUTA, txmask2                                    \n"
+"  if_z      or      DIRA, txmask2                                    \n"
+"            mov     txcode2, #((transmit2-..start)/4)                \n"
+"                                                                     \n"
+"init3                                                                \n"
+"            rdlong  mbox3, t3    wz                                  \n"
+"            add     t3, #4                                           \n"
+"  if_z      jmp     #init_done                                       \n"
+"            mov     t1, mbox3                                        \n"
+"            add     t1, #(4 << 2)                                    \n"
+"            rdlong  t2, t1                                           \n"
+"            mov     rxmask3, #1                                      \n"
+"            shl     rxmask3, t2                                      \n"
+"            cmps    t2, #0    wc                                     \n"
+"  if_nc     mov     rxcode3, #((receive3-..start)/4)                 \n"
+"            add     t1, #4                                           \n"
+"            rdlong  t2, t1                                           \n"
+"            mov     txmask3, #1                                      \n"
+"            shl     txmask3, t2                                      \n"
+"            cmps    t2, #0    wc                                     \n"
+"  if_c      mov     txmask3, #0                                      \n"
+"            add     t1, #4                                           \n"
+"            rdlong  rxtxmode3, t1                                    \n"
+"            add     t1, #4                                           \n"
+"            rdlong  bitticks3, t1                                    \n"
+"            add     t1, #4                                           \n"
+"            rdlong  rxbuff3, t1                                      \n"
+"            add     t1, #4                                           \n"
+"            rdlong  txbuff3, t1                                      \n"
+"            add     t1, #4                                           \n"
+"            rdlong  bufmask3, t1                                     \n"
+"            test    rxtxmode3, #4    wz                              \n"
+"            test    rxtxmode3, #2    wc                              \n"
+"  if_z_ne_c or      OUTA, txmask3                                    \n"
+"  if_z      or      DIRA, txmask3                                    \n"
+"            mov     txcode3, #((transmit3-..start)/4)                \n"
+"init_done                                                            \n"
+"            jmp     rxcode0                                          \n"
+"                                                                     \n"
+"rxidle0                                                              \n"
+"            jmpret  rxcode0, txcode0                                 \n"
+"            jmp     #rxidle0                                         \n"
+"                                                                     \n"
+"txidle0                                                              \n"
+"            jmpret  txcode0, rxcode1                                 \n"
+"            jmp     #txidle0                                         \n"
+"                                                                     \n"
+"receive0                                                             \n"
+"            jmpret  rxcode0, txcode0                                 \n"
+"            test    rxtxmode0, #1    wz                              \n"
+"            test    rxmask0, INA    wc                               \n"
+"  if_z_eq_c jmp     #receive0                                        \n"
+"            mov     rxbits0, #9                                      \n"
+"            mov     rxcnt0, bitticks0                                \n"
+"            shr     rxcnt0, #1                                       \n"
+"            add     rxcnt0, CNT                                      \n"
+"                                                                     \n"
+"Receive_bit0                                                         \n"
+"            add     rxcnt0, bitticks0                                \n"
+"                                                                     \n"
+"Receive_wait0                                                        \n"
+"            jmpret  rxcode0, txcode0                                 \n"
+"            mov     t1, rxcnt0                                       \n"
+"            sub     t1, CNT                                          \n"
+"            cmps    t1, #0    wc                                     \n"
+"  if_nc     jmp     #Receive_wait0                                   \n"
+"            test    rxmask0, INA    wc                               \n"
+"            rcr     rxdata0, #1                                      \n"
+"            djnz    rxbits0, #Receive_bit0                           \n"
+"            shr     rxdata0, #($20 - 9)                              \n"
+"            and     rxdata0, #$ff                                    \n"
+"            test    rxtxmode0, #1    wz                              \n"
+"  if_nz     xor     rxdata0, #$ff                                    \n"
+"            rdlong  t2, mbox0                                        \n"
+"            add     t2, rxbuff0                                      \n"
+"            wrbyte  rxdata0, t2                                      \n"
+"            sub     t2, rxbuff0                                      \n"
+"            add     t2, #1                                           \n"
+"            and     t2, bufmask0                                     \n"
+"            mov     t1, mbox0                                        \n"
+"            jmpret  rxpublish_ret, #rxpublish                        \n"
+"            jmp     #receive0                                        \n"
+"                                                                     \n"
+"transmit0                                                            \n"
+"            jmpret  txcode0, rxcode1                                 \n"
+"            mov     t1, mbox0                                        \n"
+"            add     t1, #(2 << 2)                                    \n"
+"            rdlong  t2, t1                                           \n"
+"            add     t1, #(1 << 2)                                    \n"
+"            rdlong  t3, t1                                           \n"
+"            cmp     t2, t3    wz                                     \n"
+"  if_z      jmp     #transmit0                                       \n"
+"            add     t3, txbuff0                                      \n"
+"            rdbyte  txdata0, t3                                      \n"
+"            sub     t3, txbuff0                                      \n"
+"            add     t3, #1                                           \n"
+"            and     t3, bufmask0                                     \n"
+"            wrlong  t3, t1                                           \n"
+"            or      txdata0, #$100                                   \n"
+"            shl     txdata0, #2                                      \n"
+"            or      txdata0, #1                                      \n"
+"            mov     txbits0, #$b                                     \n"
+"            mov     txcnt0, CNT                                      \n"
+"                                                                     \n"
+"Transmit_bit0                                                        \n"
+"            test    rxtxmode0, #4    wz                              \n"
+"            test    rxtxmode0, #2    wc                              \n"
+"  if_z_and_c xor     txdata0, #1                                     \n"
+"            shr     txdata0, #1    wc                                \n"
+"  if_z      muxc    OUTA, txmask0                                    \n"
+"  if_nz     muxnc   DIRA, txmask0                                    \n"
+"            add     txcnt0, bitticks0                                \n"
+"                                                                     \n"
+"Transmit_wait0                                                       \n"
+"            jmpret  txcode0, rxcode1                                 \n"
+"            mov     t1, txcnt0                                       \n"
+"            sub     t1, CNT                                          \n"
+"            cmps    t1, #0    wc                                     \n"
+"  if_nc     jmp     #Transmit_wait0                                  \n"
+"            djnz    txbits0, #Transmit_bit0                          \n"
+"            jmp     #transmit0                                       \n"
+"                                                                     \n"
+"rxidle1                                                              \n"
+"            jmpret  rxcode1, txcode1                                 \n"
+"            jmp     #rxidle1                                         \n"
+"                                                                     \n"
+"txidle1                                                              \n"
+"            jmpret  txcode1, rxcode2                                 \n"
+"            jmp     #txidle1                                         \n"
+"                                                                     \n"
+"receive1                                                             \n"
+"            jmpret  rxcode1, txcode1                                 \n"
+"            test    rxtxmode1, #1    wz                              \n"
+"            test    rxmask1, INA    wc                               \n"
+"  if_z_eq_c jmp     #receive1                                        \n"
+"            mov     rxbits1, #9                                      \n"
+"            mov     rxcnt1, bitticks1                                \n"
+"            shr     rxcnt1, #1                                       \n"
+"            add     rxcnt1, CNT                                      \n"
+"                                                                     \n"
+"Receive_bit1                                                         \n"
+"            add     rxcnt1, bitticks1                                \n"
+"                                                                     \n"
+"Receive_wait1                                                        \n"
+"            jmpret  rxcode1, txcode1                                 \n"
+"            mov     t1, rxcnt1                                       \n"
+"            sub     t1, CNT                                          \n"
+"            cmps    t1, #0    wc                                     \n"
+"  if_nc     jmp     #Receive_wait1                                   \n"
+"            test    rxmask1, INA    wc                               \n"
+"            rcr     rxdata1, #1                                      \n"
+"            djnz    rxbits1, #Receive_bit1                           \n"
+"            shr     rxdata1, #($20 - 9)                              \n"
+"            and     rxdata1, #$ff                                    \n"
+"            test    rxtxmode1, #1    wz                              \n"
+"  if_nz     xor     rxdata1, #$ff                                    \n"
+"            rdlong  t2, mbox1                                        \n"
+"            add     t2, rxbuff1                                      \n"
+"            wrbyte  rxdata1, t2                                      \n"
+"            sub     t2, rxbuff1                                      \n"
+"            add     t2, #1                                           \n"
+"            and     t2, bufmask1                                     \n"
+"            mov     t1, mbox1                                        \n"
+"            jmpret  rxpublish_ret, #rxpublish                        \n"
+"            jmp     #receive1                                        \n"
+"                                                                     \n"
+"transmit1                                                            \n"
+"            jmpret  txcode1, rxcode2                                 \n"
+"            mov     t1, mbox1                                        \n"
+"            add     t1, #(2 << 2)                                    \n"
+"            rdlong  t2, t1                                           \n"
+"            add     t1, #(1 << 2)                                    \n"
+"            rdlong  t3, t1                                           \n"
+"            cmp     t2, t3    wz                                     \n"
+"  if_z      jmp     #transmit1                                       \n"
+"            add     t3, txbuff1                                      \n"
+"            rdbyte  txdata1, t3                                      \n"
+"            sub     t3, txbuff1                                      \n"
+"            add     t3, #1                                           \n"
+"            and     t3, bufmask1                                     \n"
+"            wrlong  t3, t1                                           \n"
+"            or      txdata1, #$100                                   \n"
+"            shl     txdata1, #2                                      \n"
+"            or      txdata1, #1                                      \n"
+"            mov     txbits1, #$b                                     \n"
+"            mov     txcnt1, CNT                                      \n"
+"                                                                     \n"
+"Transmit_bit1                                                        \n"
+"            test    rxtxmode1, #4    wz                              \n"
+"            test    rxtxmode1, #2    wc                              \n"
+"  if_z_and_c xor     txdata1, #1                                     \n"
+"            shr     txdata1, #1    wc                                \n"
+"  if_z      muxc    OUTA, txmask1                                    \n"
+"  if_nz     muxnc   DIRA, txmask1                                    \n"
+"            add     txcnt1, bitticks1                                \n"
+"                                                                     \n"
+"Transmit_wait1                                                       \n"
+"            jmpret  txcode1, rxcode2                                 \n"
+"            mov     t1, txcnt1                                       \n"
+"            sub     t1, CNT                                          \n"
+"            cmps    t1, #0    wc                                     \n"
+"  if_nc     jmp     #Transmit_wait1                                  \n"
+"            djnz    txbits1, #Transmit_bit1                          \n"
+"            jmp     #transmit1                                       \n"
+"                                                                     \n"
+"rxidle2                                                              \n"
+"            jmpret  rxcode2, txcode2                                 \n"
+"            jmp     #rxidle2                                         \n"
+"                                                                     \n"
+"txidle2                                                              \n"
+"            jmpret  txcode2, rxcode3                                 \n"
+"            jmp     #txidle2                                         \n"
+"                                                                     \n"
+"receive2                                                             \n"
+"            jmpret  rxcode2, txcode2                                 \n"
+"            test    rxtxmode2, #1    wz                              \n"
+"            test    rxmask2, INA    wc                               \n"
+"  if_z_eq_c jmp     #receive2                                        \n"
+"            mov     rxbits2, #9                                      \n"
+"            mov     rxcnt2, bitticks2                                \n"
+"            shr     rxcnt2, #1                                       \n"
+"            add     rxcnt2, CNT                                      \n"
+"                                                                     \n"
+"Receive_bit2                                                         \n"
+"            add     rxcnt2, bitticks2                                \n"
+"                                                                     \n"
+"Receive_wait2                                                        \n"
+"            jmpret  rxcode2, txcode2                                 \n"
+"            mov     t1, rxcnt2                                       \n"
+"            sub     t1, CNT                                          \n"
+"            cmps    t1, #0    wc                                     \n"
+"  if_nc     jmp     #Receive_wait2                                   \n"
+"            test    rxmask2, INA    wc                               \n"
+"            rcr     rxdata2, #1                                      \n"
+"            djnz    rxbits2, #Receive_bit2                           \n"
+"            shr     rxdata2, #($20 - 9)                              \n"
+"            and     rxdata2, #$ff                                    \n"
+"            test    rxtxmode2, #1    wz                              \n"
+"  if_nz     xor     rxdata2, #$ff                                    \n"
+"            rdlong  t2, mbox2                                        \n"
+"            add     t2, rxbuff2                                      \n"
+"            wrbyte  rxdata2, t2                                      \n"
+"            sub     t2, rxbuff2                                      \n"
+"            add     t2, #1                                           \n"
+"            and     t2, bufmask2                                     \n"
+"            mov     t1, mbox2                                        \n"
+"            jmpret  rxpublish_ret, #rxpublish                        \n"
+"            jmp     #receive2                                        \n"
+"                                                                     \n"
+"transmit2                                                            \n"
+"            jmpret  txcode2, rxcode3                                 \n"
+"            mov     t1, mbox2                                        \n"
+"            add     t1, #(2 << 2)                                    \n"
+"            rdlong  t2, t1                                           \n"
+"            add     t1, #(1 << 2)                                    \n"
+"            rdlong  t3, t1                                           \n"
+"            cmp     t2, t3    wz                                     \n"
+"  if_z      jmp     #transmit2                                       \n"
+"            add     t3, txbuff2                                      \n"
+"            rdbyte  txdata2, t3                                      \n"
+"            sub     t3, txbuff2                                      \n"
+"            add     t3, #1                                           \n"
+"            and     t3, bufmask2                                     \n"
+"            wrlong  t3, t1                                           \n"
+"            or      txdata2, #$100                                   \n"
+"            shl     txdata2, #2                                      \n"
+"            or      txdata2, #1                                      \n"
+"            mov     txbits2, #$b                                     \n"
+"            mov     txcnt2, CNT                                      \n"
+"                                                                     \n"
+"Transmit_bit2                                                        \n"
+"            test    rxtxmode2, #4    wz                              \n"
+"            test    rxtxmode2, #2    wc                              \n"
+"  if_z_and_c xor     txdata2, #1                                     \n"
+"            shr     txdata2, #1    wc                                \n"
+"  if_z      muxc    OUTA, txmask2                                    \n"
+"  if_nz     muxnc   DIRA, txmask2                                    \n"
+"            add     txcnt2, bitticks2                                \n"
+"                                                                     \n"
+"Transmit_wait2                                                       \n"
+"            jmpret  txcode2, rxcode3                                 \n"
+"            mov     t1, txcnt2                                       \n"
+"            sub     t1, CNT                                          \n"
+"            cmps    t1, #0    wc                                     \n"
+"  if_nc     jmp     #Transmit_wait2                                  \n"
+"            djnz    txbits2, #Transmit_bit2                          \n"
+"            jmp     #transmit2                                       \n"
+"                                                                     \n"
+"rxidle3                                                              \n"
+"            jmpret  rxcode3, txcode3                                 \n"
+"            jmp     #rxidle3                                         \n"
+"                                                                     \n"
+"txidle3                                                              \n"
+"            jmpret  txcode3, rxcode0                                 \n"
+"            jmp     #txidle3                                         \n"
+"                                                                     \n"
+"receive3                                                             \n"
+"            jmpret  rxcode3, txcode3                                 \n"
+"            test    rxtxmode3, #1    wz                              \n"
+"            test    rxmask3, INA    wc                               \n"
+"  if_z_eq_c jmp     #receive3                                        \n"
+"            mov     rxbits3, #9                                      \n"
+"            mov     rxcnt3, bitticks3                                \n"
+"            shr     rxcnt3, #1                                       \n"
+"            add     rxcnt3, CNT                                      \n"
+"                                                                     \n"
+"Receive_bit3                                                         \n"
+"            add     rxcnt3, bitticks3                                \n"
+"                                                                     \n"
+"Receive_wait3                                                        \n"
+"            jmpret  rxcode3, txcode3                                 \n"
+"            mov     t1, rxcnt3                                       \n"
+"            sub     t1, CNT                                          \n"
+"            cmps    t1, #0    wc                                     \n"
+"  if_nc     jmp     #Receive_wait3                                   \n"
+"            test    rxmask3, INA    wc                               \n"
+"            rcr     rxdata3, #1                                      \n"
+"            djnz    rxbits3, #Receive_bit3                           \n"
+"            shr     rxdata3, #($20 - 9)                              \n"
+"            and     rxdata3, #$ff                                    \n"
+"            test    rxtxmode3, #1    wz                              \n"
+"  if_nz     xor     rxdata3, #$ff                                    \n"
+"            rdlong  t2, mbox3                                        \n"
+"            add     t2, rxbuff3                                      \n"
+"            wrbyte  rxdata3, t2                                      \n"
+"            sub     t2, rxbuff3                                      \n"
+"            add     t2, #1                                           \n"
+"            and     t2, bufmask3                                     \n"
+"            mov     t1, mbox3                                        \n"
+"            jmpret  rxpublish_ret, #rxpublish                        \n"
+"            jmp     #receive3                                        \n"
+"                                                                     \n"
+"transmit3                                                            \n"
+"            jmpret  txcode3, rxcode0                                 \n"
+"            mov     t1, mbox3                                        \n"
+"            add     t1, #(2 << 2)                                    \n"
+"            rdlong  t2, t1                                           \n"
+"            add     t1, #(1 << 2)                                    \n"
+"            rdlong  t3, t1                                           \n"
+"            cmp     t2, t3    wz                                     \n"
+"  if_z      jmp     #transmit3                                       \n"
+"            add     t3, txbuff3                                      \n"
+"            rdbyte  txdata3, t3                                      \n"
+"            sub     t3, txbuff3                                      \n"
+"            add     t3, #1                                           \n"
+"            and     t3, bufmask3                                     \n"
+"            wrlong  t3, t1                                           \n"
+"            or      txdata3, #$100                                   \n"
+"            shl     txdata3, #2                                      \n"
+"            or      txdata3, #1                                      \n"
+"            mov     txbits3, #$b                                     \n"
+"            mov     txcnt3, CNT                                      \n"
+"                                                                     \n"
+"Transmit_bit3                                                        \n"
+"            test    rxtxmode3, #4    wz                              \n"
+"            test    rxtxmode3, #2    wc                              \n"
+"  if_z_and_c xor     txdata3, #1                                     \n"
+"            shr     txdata3, #1    wc                                \n"
+"  if_z      muxc    OUTA, txmask3                                    \n"
+"  if_nz     muxnc   DIRA, txmask3                                    \n"
+"            add     txcnt3, bitticks3                                \n"
+"                                                                     \n"
+"Transmit_wait3                                                       \n"
+"            jmpret  txcode3, rxcode0                                 \n"
+"            mov     t1, txcnt3                                       \n"
+"            sub     t1, CNT                                          \n"
+"            cmps    t1, #0    wc                                     \n"
+"  if_nc     jmp     #Transmit_wait3                                  \n"
+"            djnz    txbits3, #Transmit_bit3                          \n"
+"            jmp     #transmit3                                       \n"
+"                                                                     \n"
+// Publish the new receive head in t2 to the mailbox at t1, unless the buffer is full, in which case the byte is
+// dropped and counted instead
+"rxpublish                                                            \n"
+"            mov     t3, t1                                           \n"
+"            add     t3, #4                                           \n"
+"            rdlong  t3, t3                                           \n"
+"            cmp     t2, t3    wz                                     \n"
+"  if_nz     wrlong  t2, t1                                           \n"
+"  if_z      add     t1, #(11 << 2)                                   \n"
+"  if_z      rdlong  t2, t1                                           \n"
+"  if_z      add     t2, #1                                           \n"
+"  if_z      wrlong  t2, t1                                           \n"
+"rxpublish_ret                                                        \n"
+"            ret                                                      \n"
+"                                                                     \n"
+"t1                                                                   \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"t2                                                                   \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"t3                                                                   \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"mbox0                                                                \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxtxmode0                                                            \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"bitticks0                                                            \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"bufmask0                                                             \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxmask0                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxbuff0                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxdata0                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxbits0                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxcnt0                                                               \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxcode0                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txmask0                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txbuff0                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txdata0                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txbits0                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txcnt0                                                               \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txcode0                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"mbox1                                                                \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxtxmode1                                                            \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"bitticks1                                                            \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"bufmask1                                                             \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxmask1                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxbuff1                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxdata1                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxbits1                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxcnt1                                                               \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxcode1                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txmask1                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txbuff1                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txdata1                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txbits1                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txcnt1                                                               \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txcode1                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"mbox2                                                                \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxtxmode2                                                            \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"bitticks2                                                            \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"bufmask2                                                             \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxmask2                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxbuff2                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxdata2                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxbits2                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxcnt2                                                               \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxcode2                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txmask2                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txbuff2                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txdata2                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txbits2                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txcnt2                                                               \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txcode2                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"mbox3                                                                \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxtxmode3                                                            \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"bitticks3                                                            \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"bufmask3                                                             \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxmask3                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxbuff3                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxdata3                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxbits3                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxcnt3                                                               \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxcode3                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txmask3                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txbuff3                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txdata3                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txbits3                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txcnt3                                                               \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"txcode3                                                              \n"
+"            .res    1                                                \n"
+"            .compress default                                        \n"
+"            .text                                                    \n"
+);
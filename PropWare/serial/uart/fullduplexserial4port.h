@@ -0,0 +1,98 @@
+/**
+ * @file    PropWare/serial/uart/fullduplexserial4port.h
+ *
+ * @author  Chip Gracey
+ * @author  Jeff Martin
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>2006-2009 Parallax, Inc.<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/serial/uart/fullduplexserial.h>
+
+namespace PropWare {
+
+void *get_full_duplex_serial_4port_driver ();
+
+/**
+ * @brief   Service up to four FullDuplexSerial ports from a single driver cog
+ *
+ * Each port keeps its own pins, mode, baudrate and buffer depth; only the driver cog is shared. The eight receive and
+ * transmit routines take turns in a round robin, so the sum of the work limits how fast each port can run: with an
+ * 80 MHz system clock, four active ports are comfortable up to 115,200 baud. A port with a negative receive pin only
+ * transmits, and a port with a negative transmit pin only receives.
+ *
+ * Ports handed to this object must not also be started with PropWare::BasicFullDuplexSerial::start().
+ *
+ * @code
+ * BasicFullDuplexSerial<256> gps(GPS_RX, GPS_TX, 0, 9600);
+ * BasicFullDuplexSerial<64>  modem(MODEM_RX, MODEM_TX, 0, 115200);
+ * FullDuplexSerial4Port      driver(gps, &modem);
+ * driver.start();
+ *
+ * Printer modemPrinter(modem);
+ * modemPrinter << "Position: " << gps.get_char() << '\n';
+ * @endcode
+ */
+class FullDuplexSerial4Port {
+    public:
+        static const unsigned int PORTS = 4;
+
+    public:
+        /**
+         * @param[in]   port0   First port; always serviced
+         * @param[in]   port1   Second port, or NULL if unused
+         * @param[in]   port2   Third port, or NULL if unused
+         * @param[in]   port3   Fourth port, or NULL if unused
+         */
+        FullDuplexSerial4Port (const FullDuplexSerialPort &port0, const FullDuplexSerialPort *port1 = NULL,
+                               const FullDuplexSerialPort *port2 = NULL, const FullDuplexSerialPort *port3 = NULL)
+                : m_cogID(-1) {
+            this->m_mailboxes[0] = port0.mailbox();
+            this->m_mailboxes[1] = port1 ? port1->mailbox() : 0;
+            this->m_mailboxes[2] = port2 ? port2->mailbox() : 0;
+            this->m_mailboxes[3] = port3 ? port3->mailbox() : 0;
+        }
+
+        /**
+         * @brief   Stop the driver cog
+         */
+        ~FullDuplexSerial4Port () {
+            if (-1 != this->m_cogID)
+                cogstop(this->m_cogID);
+        }
+
+        /**
+         * @brief   Start the driver cog
+         *
+         * @return  Cog ID of the driver cog. -1 for failure
+         */
+        int start () {
+            return this->m_cogID = cognew(get_full_duplex_serial_4port_driver(), (int32_t) this->m_mailboxes);
+        }
+
+    protected:
+        int32_t m_cogID;
+        int32_t m_mailboxes[PORTS];
+};
+
+}
@@ -0,0 +1,221 @@
+/**
+ * @file    asyncsd_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareTests.h"
+#include <PropWare/memory/asyncsd.h>
+
+using PropWare::AsyncSD;
+using PropWare::SD;
+
+static const uint8_t RING_LENGTH = 4;
+static const size_t  STACK_SIZE  = 160;
+
+class AsyncSdTest {
+    public:
+        AsyncSdTest ()
+                : testable(this->ring, RING_LENGTH, this->stack) {
+        }
+
+        void error_checker (const PropWare::ErrorCode err) {
+            if (err)
+                AsyncSD::print_error_str(pwOut, (AsyncSD::ErrorCode) err);
+        }
+
+    public:
+        uint32_t         stack[STACK_SIZE];
+        AsyncSD::Request ring[RING_LENGTH];
+        AsyncSD          testable;
+};
+
+TEST_F(AsyncSdTest, Start) {
+    PropWare::ErrorCode err = testable.start();
+    error_checker(err);
+    ASSERT_EQ_MSG(AsyncSD::NO_ERROR, err);
+    ASSERT_NEQ_MSG(-1, testable.get_cog_id());
+}
+
+TEST_F(AsyncSdTest, SubmitRead_matchesSynchronousDriver) {
+    uint8_t expected[SD::SECTOR_SIZE];
+    uint8_t actual[SD::SECTOR_SIZE];
+
+    PropWare::ErrorCode err = testable.start();
+    error_checker(err);
+    ASSERT_EQ_MSG(AsyncSD::NO_ERROR, err);
+
+    memset(actual, 0, sizeof(actual));
+    AsyncSD::Request *request = testable.submit_read(0, actual);
+    ASSERT_NEQ_MSG(NULL, request);
+    ASSERT_EQ_MSG(1, testable.get_outstanding());
+
+    err = testable.wait(*request);
+    error_checker(err);
+    ASSERT_EQ_MSG(AsyncSD::NO_ERROR, err);
+    ASSERT_EQ_MSG(0, testable.get_outstanding());
+
+    err = testable.read_data_block(0, expected);
+    error_checker(err);
+    ASSERT_EQ_MSG(AsyncSD::NO_ERROR, err);
+    ASSERT_EQ_MSG(0, memcmp(expected, actual, SD::SECTOR_SIZE));
+}
+
+TEST_F(AsyncSdTest, Submit_returnsNullWhenRingIsFull) {
+    uint8_t buffer[SD::SECTOR_SIZE];
+
+    PropWare::ErrorCode err = testable.start();
+    error_checker(err);
+    ASSERT_EQ_MSG(AsyncSD::NO_ERROR, err);
+
+    AsyncSD::Request *requests[RING_LENGTH];
+    for (uint8_t i = 0; i < RING_LENGTH; ++i) {
+        requests[i] = testable.submit_read(0, buffer);
+        ASSERT_NEQ_MSG(NULL, requests[i]);
+    }
+    ASSERT_EQ_MSG(NULL, testable.submit_read(0, buffer));
+
+    for (uint8_t i = 0; i < RING_LENGTH; ++i) {
+        err = testable.wait(*requests[i]);
+        error_checker(err);
+        ASSERT_EQ_MSG(AsyncSD::NO_ERROR, err);
+    }
+    ASSERT_NEQ_MSG(NULL, testable.submit_read(0, buffer));
+}
+
+TEST_F(AsyncSdTest, SubmitWrite) {
+    const uint32_t sdBlockAddr = 1;
+    uint8_t        original[SD::SECTOR_SIZE];
+    uint8_t        myData[SD::SECTOR_SIZE];
+    uint8_t        readBack[SD::SECTOR_SIZE];
+
+    for (unsigned int i = 0; i < sizeof(myData); ++i)
+        myData[i] = (uint8_t) ~i;
+
+    PropWare::ErrorCode err = testable.start();
+    error_checker(err);
+    ASSERT_EQ_MSG(AsyncSD::NO_ERROR, err);
+
+    err = testable.read_data_block(sdBlockAddr, original);
+    error_checker(err);
+    ASSERT_EQ_MSG(AsyncSD::NO_ERROR, err);
+
+    // Queue the write and the read-back together; the engine must service them in order
+    AsyncSD::Request *write = testable.submit_write(sdBlockAddr, myData);
+    AsyncSD::Request *read  = testable.submit_read(sdBlockAddr, readBack);
+    ASSERT_NEQ_MSG(NULL, write);
+    ASSERT_NEQ_MSG(NULL, read);
+
+    err = testable.wait(*write);
+    error_checker(err);
+    ASSERT_EQ_MSG(AsyncSD::NO_ERROR, err);
+    err = testable.wait(*read);
+    error_checker(err);
+    ASSERT_EQ_MSG(AsyncSD::NO_ERROR, err);
+    ASSERT_EQ_MSG(0, memcmp(myData, readBack, SD::SECTOR_SIZE));
+
+    err = testable.write_data_block(sdBlockAddr, original);
+    error_checker(err);
+    ASSERT_EQ_MSG(AsyncSD::NO_ERROR, err);
+}
+
+TEST_F(AsyncSdTest, ReadAhead_doesNotBlockSynchronousReads) {
+    uint8_t expected[SD::SECTOR_SIZE];
+    uint8_t ahead[SD::SECTOR_SIZE];
+    uint8_t buffer[SD::SECTOR_SIZE];
+
+    PropWare::ErrorCode err = testable.start();
+    error_checker(err);
+    ASSERT_EQ_MSG(AsyncSD::NO_ERROR, err);
+
+    err = testable.read_data_block(0, expected);
+    error_checker(err);
+    ASSERT_EQ_MSG(AsyncSD::NO_ERROR, err);
+
+    memset(ahead, 0, sizeof(ahead));
+    err = testable.start_read_ahead(0, ahead);
+    error_checker(err);
+    ASSERT_EQ_MSG(AsyncSD::NO_ERROR, err);
+    ASSERT_EQ_MSG(1, testable.get_outstanding());
+
+    // More synchronous transfers than there are mailboxes, while the read-ahead's result is still uncollected
+    for (uint8_t i = 0; i < 2 * RING_LENGTH; ++i) {
+        err = testable.read_data_block(0, buffer);
+        error_checker(err);
+        ASSERT_EQ_MSG(AsyncSD::NO_ERROR, err);
+    }
+    ASSERT_EQ_MSG(1, testable.get_outstanding());
+
+    err = testable.wait_for_read_ahead(ahead);
+    error_checker(err);
+    ASSERT_EQ_MSG(AsyncSD::NO_ERROR, err);
+    ASSERT_EQ_MSG(0, testable.get_outstanding());
+    ASSERT_EQ_MSG(0, memcmp(expected, ahead, SD::SECTOR_SIZE));
+}
+
+TEST_F(AsyncSdTest, ReadAhead_fallsBackWhenRingIsFull) {
+    uint8_t buffer[SD::SECTOR_SIZE];
+    uint8_t ahead[SD::SECTOR_SIZE];
+
+    PropWare::ErrorCode err = testable.start();
+    error_checker(err);
+    ASSERT_EQ_MSG(AsyncSD::NO_ERROR, err);
+
+    AsyncSD::Request *requests[RING_LENGTH];
+    for (uint8_t i = 0; i < RING_LENGTH; ++i) {
+        requests[i] = testable.submit_read(0, buffer);
+        ASSERT_NEQ_MSG(NULL, requests[i]);
+    }
+
+    // Neither the blocking fallback nor a plain synchronous read may wait for the ring to drain
+    err = testable.start_read_ahead(0, ahead);
+    error_checker(err);
+    ASSERT_EQ_MSG(AsyncSD::NO_ERROR, err);
+    err = testable.read_data_block(0, ahead);
+    error_checker(err);
+    ASSERT_EQ_MSG(AsyncSD::NO_ERROR, err);
+
+    // Collecting results out of order frees mailboxes for reuse
+    err = testable.wait(*requests[RING_LENGTH - 1]);
+    error_checker(err);
+    ASSERT_EQ_MSG(AsyncSD::NO_ERROR, err);
+    ASSERT_EQ_MSG(requests[RING_LENGTH - 1], testable.submit_read(0, buffer));
+
+    for (uint8_t i = 0; i < RING_LENGTH; ++i) {
+        err = testable.wait(*requests[i]);
+        error_checker(err);
+        ASSERT_EQ_MSG(AsyncSD::NO_ERROR, err);
+    }
+}
+
+int main () {
+    START(AsyncSdTest);
+
+    RUN_TEST_F(AsyncSdTest, Start);
+    RUN_TEST_F(AsyncSdTest, SubmitRead_matchesSynchronousDriver);
+    RUN_TEST_F(AsyncSdTest, Submit_returnsNullWhenRingIsFull);
+    RUN_TEST_F(AsyncSdTest, SubmitWrite);
+    RUN_TEST_F(AsyncSdTest, ReadAhead_doesNotBlockSynchronousReads);
+    RUN_TEST_F(AsyncSdTest, ReadAhead_fallsBackWhenRingIsFull);
+
+    COMPLETE();
+}
@@ -0,0 +1,176 @@
+/**
+ * @file    asyncuartrx_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareTests.h"
+#include <PropWare/serial/uart/asyncuartrx.h>
+
+using PropWare::AsyncUARTRX;
+using PropWare::UARTRX;
+using PropWare::Port;
+
+class AsyncUARTRXTest {
+    public:
+        AsyncUARTRXTest ()
+                : uart(Port::P12) {
+        }
+
+        void feed (AsyncUARTRX &testable, const uint8_t bytes[], const size_t length) {
+            for (size_t i = 0; i < length; ++i)
+                testable.process(bytes[i]);
+        }
+
+    public:
+        UARTRX             uart;
+        uint8_t            buffer[16];
+        AsyncUARTRX::Frame frames[2];
+        uint32_t           stack[64];
+        uint8_t            frame[16];
+};
+
+TEST_F(AsyncUARTRXTest, Raw_passesBytesThrough) {
+    AsyncUARTRX testable(uart, buffer, stack);
+    const uint8_t bytes[] = {'a', 'b'};
+    feed(testable, bytes, sizeof(bytes));
+
+    ASSERT_TRUE(testable.receive_ready());
+    ASSERT_EQ_MSG('a', testable.get_char());
+    ASSERT_EQ_MSG('b', testable.get_char());
+    ASSERT_FALSE(testable.receive_ready());
+}
+
+TEST_F(AsyncUARTRXTest, Raw_countsOverruns) {
+    AsyncUARTRX testable(uart, buffer, stack);
+    for (uint8_t i = 0; i < sizeof(buffer) + 3; ++i)
+        testable.process(i);
+
+    ASSERT_EQ_MSG(3, testable.get_overruns());
+    ASSERT_EQ_MSG(0, testable.get_char());
+}
+
+TEST_F(AsyncUARTRXTest, Delimited_splitsFrames) {
+    AsyncUARTRX testable(uart, buffer, frames, stack, AsyncUARTRX::DELIMITED, '\n');
+    const uint8_t bytes[] = {'h', 'i', '\n', '\n', 'y', 'o', '\n'};
+    feed(testable, bytes, sizeof(bytes));
+
+    ASSERT_EQ_MSG(2, testable.get_frame(frame, sizeof(frame)));
+    ASSERT_EQ_MSG(0, memcmp("hi", frame, 2));
+    ASSERT_EQ_MSG(2, testable.get_frame(frame, sizeof(frame)));
+    ASSERT_EQ_MSG(0, memcmp("yo", frame, 2));
+    ASSERT_FALSE(testable.frame_ready());
+}
+
+TEST_F(AsyncUARTRXTest, LengthPrefixed_readsPayload) {
+    AsyncUARTRX testable(uart, buffer, frames, stack, AsyncUARTRX::LENGTH_PREFIXED);
+    const uint8_t bytes[] = {3, 'a', 'b', 'c', 1, 'd'};
+    feed(testable, bytes, sizeof(bytes));
+
+    ASSERT_EQ_MSG(3, testable.get_frame(frame, sizeof(frame)));
+    ASSERT_EQ_MSG(0, memcmp("abc", frame, 3));
+    ASSERT_EQ_MSG(1, testable.get_frame(frame, sizeof(frame)));
+    ASSERT_EQ_MSG('d', frame[0]);
+}
+
+TEST_F(AsyncUARTRXTest, LengthPrefixed_parityErrorKeepsFramesInSync) {
+    AsyncUARTRX testable(uart, buffer, frames, stack, AsyncUARTRX::LENGTH_PREFIXED);
+    const uint8_t before[] = {3, 'a'};
+    const uint8_t after[]  = {'c', 1, 'd'};
+    feed(testable, before, sizeof(before));
+    testable.parity_error();
+    feed(testable, after, sizeof(after));
+
+    ASSERT_EQ_MSG(1, testable.get_dropped_frames());
+    ASSERT_EQ_MSG(1, testable.get_frame(frame, sizeof(frame)));
+    ASSERT_EQ_MSG('d', frame[0]);
+    ASSERT_FALSE(testable.frame_ready());
+}
+
+TEST_F(AsyncUARTRXTest, Slip_decodesEscapes) {
+    AsyncUARTRX testable(uart, buffer, frames, stack, AsyncUARTRX::SLIP);
+    const uint8_t bytes[] = {AsyncUARTRX::SLIP_END, 1, AsyncUARTRX::SLIP_ESC, AsyncUARTRX::SLIP_ESC_END,
+                             AsyncUARTRX::SLIP_ESC, AsyncUARTRX::SLIP_ESC_ESC, 2, AsyncUARTRX::SLIP_END};
+    feed(testable, bytes, sizeof(bytes));
+
+    const uint8_t expected[] = {1, AsyncUARTRX::SLIP_END, AsyncUARTRX::SLIP_ESC, 2};
+    ASSERT_EQ_MSG(sizeof(expected), testable.get_frame(frame, sizeof(frame)));
+    ASSERT_EQ_MSG(0, memcmp(expected, frame, sizeof(expected)));
+    ASSERT_FALSE(testable.frame_ready());
+}
+
+TEST_F(AsyncUARTRXTest, Cobs_decodesZeros) {
+    AsyncUARTRX testable(uart, buffer, frames, stack, AsyncUARTRX::COBS);
+    // Encoding of {0x11, 0x00, 0x00, 0x22}
+    const uint8_t bytes[] = {0x02, 0x11, 0x01, 0x02, 0x22, 0x00};
+    feed(testable, bytes, sizeof(bytes));
+
+    const uint8_t expected[] = {0x11, 0x00, 0x00, 0x22};
+    ASSERT_EQ_MSG(sizeof(expected), testable.get_frame(frame, sizeof(frame)));
+    ASSERT_EQ_MSG(0, memcmp(expected, frame, sizeof(expected)));
+}
+
+TEST_F(AsyncUARTRXTest, Cobs_dropsTruncatedFrame) {
+    AsyncUARTRX testable(uart, buffer, frames, stack, AsyncUARTRX::COBS);
+    const uint8_t bytes[] = {0x05, 0x11, 0x00, 0x02, 0x33, 0x00};
+    feed(testable, bytes, sizeof(bytes));
+
+    ASSERT_EQ_MSG(1, testable.get_dropped_frames());
+    ASSERT_EQ_MSG(1, testable.get_frame(frame, sizeof(frame)));
+    ASSERT_EQ_MSG(0x33, frame[0]);
+}
+
+TEST_F(AsyncUARTRXTest, Frames_wrapAroundRingAndDropWhenFull) {
+    AsyncUARTRX testable(uart, buffer, frames, stack, AsyncUARTRX::LENGTH_PREFIXED);
+    uint8_t     bytes[11] = {10};
+    for (uint8_t i = 1; i < sizeof(bytes); ++i)
+        bytes[i] = i;
+
+    feed(testable, bytes, sizeof(bytes));
+    ASSERT_EQ_MSG(10, testable.get_frame(frame, sizeof(frame)));
+
+    // Second frame starts at offset 10 and wraps past the end of the 16-byte ring
+    feed(testable, bytes, sizeof(bytes));
+    // Third frame does not fit beside the second
+    feed(testable, bytes, sizeof(bytes));
+    ASSERT_EQ_MSG(1, testable.get_dropped_frames());
+
+    ASSERT_EQ_MSG(10, testable.get_frame(frame, sizeof(frame)));
+    ASSERT_EQ_MSG(0, memcmp(&bytes[1], frame, 10));
+    ASSERT_FALSE(testable.frame_ready());
+}
+
+int main () {
+    START(AsyncUARTRXTest);
+
+    RUN_TEST_F(AsyncUARTRXTest, Raw_passesBytesThrough);
+    RUN_TEST_F(AsyncUARTRXTest, Raw_countsOverruns);
+    RUN_TEST_F(AsyncUARTRXTest, Delimited_splitsFrames);
+    RUN_TEST_F(AsyncUARTRXTest, LengthPrefixed_readsPayload);
+    RUN_TEST_F(AsyncUARTRXTest, LengthPrefixed_parityErrorKeepsFramesInSync);
+    RUN_TEST_F(AsyncUARTRXTest, Slip_decodesEscapes);
+    RUN_TEST_F(AsyncUARTRXTest, Cobs_decodesZeros);
+    RUN_TEST_F(AsyncUARTRXTest, Cobs_dropsTruncatedFrame);
+    RUN_TEST_F(AsyncUARTRXTest, Frames_wrapAroundRingAndDropWhenFull);
+
+    COMPLETE();
+}
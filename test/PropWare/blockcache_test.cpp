@@ -0,0 +1,201 @@
+/**
+ * @file    blockcache_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareTests.h"
+#include <PropWare/memory/blockcache.h>
+
+using PropWare::BlockStorage;
+using PropWare::BlockCache;
+
+static const uint16_t SECTOR_SIZE       = 512;
+static const uint8_t  SECTOR_SIZE_SHIFT = 9;
+static const uint8_t  DEVICE_BLOCKS     = 8;
+static const uint8_t  CACHE_LINES       = 3;
+
+/**
+ * Simple RAM-backed device which counts every access
+ *
+ * Every access is served from HUB RAM, so the suite needs no SD card or other peripheral and runs on any Propeller
+ * board (it is labelled `hardware-independent`). Like every other PropWare unit test, it is built with the Propeller
+ * toolchain and executed through `propeller-load`; there is no Linux host build of the test framework.
+ */
+class CountingBlockStorage : public BlockStorage {
+    public:
+        CountingBlockStorage ()
+                : reads(0),
+                  writes(0) {
+            for (uint_fast8_t block = 0; block < DEVICE_BLOCKS; ++block)
+                memset(this->data[block], block, SECTOR_SIZE);
+        }
+
+        PropWare::ErrorCode start () const {
+            return 0;
+        }
+
+        PropWare::ErrorCode read_data_block (uint32_t address, uint8_t buf[]) const {
+            ++this->reads;
+            memcpy(buf, this->data[address], SECTOR_SIZE);
+            return 0;
+        }
+
+        PropWare::ErrorCode write_data_block (uint32_t address, const uint8_t dat[]) const {
+            ++this->writes;
+            memcpy(this->data[address], dat, SECTOR_SIZE);
+            return 0;
+        }
+
+        uint16_t get_short (const uint16_t offset, const uint8_t buf[]) const {
+            return (buf[offset + 1] << 8) + buf[offset];
+        }
+
+        uint32_t get_long (const uint16_t offset, const uint8_t buf[]) const {
+            return (buf[offset + 3] << 24) + (buf[offset + 2] << 16) + (buf[offset + 1] << 8) + buf[offset];
+        }
+
+        void write_short (const uint16_t offset, uint8_t buf[], const uint16_t value) const {
+            buf[offset + 1] = value >> 8;
+            buf[offset]     = value;
+        }
+
+        void write_long (const uint16_t offset, uint8_t buf[], const uint32_t value) const {
+            buf[offset + 3] = (uint8_t) (value >> 24);
+            buf[offset + 2] = (uint8_t) (value >> 16);
+            buf[offset + 1] = (uint8_t) (value >> 8);
+            buf[offset]     = (uint8_t) value;
+        }
+
+        uint16_t get_sector_size () const {
+            return SECTOR_SIZE;
+        }
+
+        uint8_t get_sector_size_shift () const {
+            return SECTOR_SIZE_SHIFT;
+        }
+
+    public:
+        mutable uint8_t      data[DEVICE_BLOCKS][SECTOR_SIZE];
+        mutable unsigned int reads;
+        mutable unsigned int writes;
+};
+
+class BlockCacheTest {
+    public:
+        BlockCacheTest ()
+                : testable(device, pool, lines, CACHE_LINES) {
+        }
+
+    public:
+        CountingBlockStorage  device;
+        uint8_t               pool[CACHE_LINES * SECTOR_SIZE];
+        BlockCache::CacheLine lines[CACHE_LINES];
+        uint8_t               buffer[SECTOR_SIZE];
+        BlockCache            testable;
+};
+
+TEST_F(BlockCacheTest, Read_missThenHit) {
+    ASSERT_EQ_MSG(0, testable.read_data_block(2, buffer));
+    ASSERT_EQ_MSG(1, device.reads);
+    ASSERT_EQ_MSG(2, buffer[0]);
+    ASSERT_EQ_MSG(2, buffer[SECTOR_SIZE - 1]);
+
+    memset(buffer, 0, SECTOR_SIZE);
+    ASSERT_EQ_MSG(0, testable.read_data_block(2, buffer));
+    ASSERT_EQ_MSG(1, device.reads);
+    ASSERT_EQ_MSG(2, buffer[0]);
+
+    ASSERT_EQ_MSG(1, testable.get_hits());
+    ASSERT_EQ_MSG(1, testable.get_misses());
+}
+
+TEST_F(BlockCacheTest, Write_deferredUntilFlush) {
+    memset(buffer, 0xAB, SECTOR_SIZE);
+    ASSERT_EQ_MSG(0, testable.write_data_block(1, buffer));
+    ASSERT_EQ_MSG(0, device.writes);
+    ASSERT_EQ_MSG(0, device.reads);
+    ASSERT_EQ_MSG(1, device.data[1][0]);
+
+    memset(buffer, 0, SECTOR_SIZE);
+    ASSERT_EQ_MSG(0, testable.read_data_block(1, buffer));
+    ASSERT_EQ_MSG(0xAB, buffer[0]);
+
+    ASSERT_EQ_MSG(0, testable.flush_all());
+    ASSERT_EQ_MSG(1, device.writes);
+    ASSERT_EQ_MSG(0xAB, device.data[1][0]);
+
+    // Clean lines must not be written a second time
+    ASSERT_EQ_MSG(0, testable.flush_all());
+    ASSERT_EQ_MSG(1, device.writes);
+}
+
+TEST_F(BlockCacheTest, Evict_leastRecentlyUsed) {
+    ASSERT_EQ_MSG(0, testable.read_data_block(0, buffer));
+    ASSERT_EQ_MSG(0, testable.read_data_block(1, buffer));
+    ASSERT_EQ_MSG(0, testable.read_data_block(2, buffer));
+
+    // Touch block 0 so that block 1 becomes the oldest
+    ASSERT_EQ_MSG(0, testable.read_data_block(0, buffer));
+    ASSERT_EQ_MSG(3, device.reads);
+
+    ASSERT_EQ_MSG(0, testable.read_data_block(3, buffer));
+    ASSERT_EQ_MSG(4, device.reads);
+
+    ASSERT_EQ_MSG(0, testable.read_data_block(0, buffer));
+    ASSERT_EQ_MSG(0, testable.read_data_block(2, buffer));
+    ASSERT_EQ_MSG(4, device.reads);
+
+    ASSERT_EQ_MSG(0, testable.read_data_block(1, buffer));
+    ASSERT_EQ_MSG(5, device.reads);
+}
+
+TEST_F(BlockCacheTest, Evict_writesBackDirtyLine) {
+    memset(buffer, 0xCD, SECTOR_SIZE);
+    ASSERT_EQ_MSG(0, testable.write_data_block(4, buffer));
+
+    for (uint8_t block = 0; block < CACHE_LINES; ++block)
+        ASSERT_EQ_MSG(0, testable.read_data_block(block, buffer));
+
+    ASSERT_EQ_MSG(1, device.writes);
+    ASSERT_EQ_MSG(0xCD, device.data[4][0]);
+    ASSERT_EQ_MSG(0xCD, device.data[4][SECTOR_SIZE - 1]);
+}
+
+TEST_F(BlockCacheTest, InvalidateAll_discardsLines) {
+    ASSERT_EQ_MSG(0, testable.read_data_block(5, buffer));
+    testable.invalidate_all();
+    ASSERT_EQ_MSG(0, testable.read_data_block(5, buffer));
+    ASSERT_EQ_MSG(2, device.reads);
+}
+
+int main () {
+    START(BlockCacheTest);
+
+    RUN_TEST_F(BlockCacheTest, Read_missThenHit);
+    RUN_TEST_F(BlockCacheTest, Write_deferredUntilFlush);
+    RUN_TEST_F(BlockCacheTest, Evict_leastRecentlyUsed);
+    RUN_TEST_F(BlockCacheTest, Evict_writesBackDirtyLine);
+    RUN_TEST_F(BlockCacheTest, InvalidateAll_discardsLines);
+
+    COMPLETE();
+}
@@ -0,0 +1,143 @@
+/**
+ * @file    buffereduarttx_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareTests.h"
+#include <PropWare/serial/uart/buffereduarttx.h>
+#include <PropWare/hmi/output/printer.h>
+
+using PropWare::BufferedUARTTX;
+using PropWare::UARTTX;
+using PropWare::Printer;
+using PropWare::Port;
+
+class RecordingUARTTX : public UARTTX {
+    public:
+        RecordingUARTTX ()
+                : UARTTX(Port::P12),
+                  length(0) {
+        }
+
+        virtual void send_array (const char array[], uint32_t words) const {
+            memcpy(&this->sent[this->length], array, words);
+            this->length += words;
+        }
+
+    public:
+        mutable char   sent[64];
+        mutable size_t length;
+};
+
+class BufferedUARTTXTest {
+    public:
+        void drain (BufferedUARTTX &testable) {
+            while (testable.m_read != testable.m_write)
+                if (BufferedUARTTX::DROP_OLDEST == testable.m_policy)
+                    testable.send_copy();
+                else
+                    testable.send_in_place();
+        }
+
+    public:
+        RecordingUARTTX uart;
+        uint8_t         buffer[16];
+        uint32_t        stack[64];
+};
+
+TEST_F(BufferedUARTTXTest, Printer_returnsBeforeTransmitting) {
+    BufferedUARTTX testable(uart, buffer, stack);
+    Printer        printer(testable, false);
+    printer.printf("x=%d", 42);
+
+    ASSERT_EQ_MSG(0, uart.length);
+    drain(testable);
+    ASSERT_EQ_MSG(4, uart.length);
+    ASSERT_EQ_MSG(0, memcmp("x=42", uart.sent, 4));
+}
+
+TEST_F(BufferedUARTTXTest, Block_wrapsAroundRing) {
+    BufferedUARTTX testable(uart, buffer, stack, BufferedUARTTX::BLOCK);
+    const uint8_t  bytes[] = "0123456789abc";
+
+    ASSERT_EQ_MSG(12, testable.write(bytes, 12));
+    drain(testable);
+    ASSERT_EQ_MSG(13, testable.write(bytes, 13));
+    drain(testable);
+
+    ASSERT_EQ_MSG(25, uart.length);
+    ASSERT_EQ_MSG(0, memcmp("0123456789ab0123456789abc", uart.sent, 25));
+    ASSERT_EQ_MSG(0, testable.get_dropped_bytes());
+}
+
+TEST_F(BufferedUARTTXTest, DropNewest_discardsBytesThatDoNotFit) {
+    BufferedUARTTX testable(uart, buffer, stack, BufferedUARTTX::DROP_NEWEST);
+    const uint8_t  bytes[] = "0123456789abcdefghij";
+
+    ASSERT_EQ_MSG(16, testable.write(bytes, 20));
+    testable.put_char('!');
+    ASSERT_EQ_MSG(5, testable.get_dropped_bytes());
+
+    drain(testable);
+    ASSERT_EQ_MSG(16, uart.length);
+    ASSERT_EQ_MSG(0, memcmp(bytes, uart.sent, 16));
+}
+
+TEST_F(BufferedUARTTXTest, DropOldest_keepsNewestBytes) {
+    BufferedUARTTX testable(uart, buffer, stack, BufferedUARTTX::DROP_OLDEST);
+    const uint8_t  bytes[] = "0123456789abcdefghij";
+
+    ASSERT_EQ_MSG(20, testable.write(bytes, 20));
+    testable.put_char('!');
+
+    drain(testable);
+    ASSERT_EQ_MSG(5, testable.get_dropped_bytes());
+    ASSERT_EQ_MSG(16, uart.length);
+    ASSERT_EQ_MSG(0, memcmp("56789abcdefghij!", uart.sent, 16));
+}
+
+TEST_F(BufferedUARTTXTest, DropOldest_skipsBytesOverwrittenDuringCopy) {
+    BufferedUARTTX testable(uart, buffer, stack, BufferedUARTTX::DROP_OLDEST);
+    const uint8_t  bytes[] = "0123456789abcdef";
+
+    testable.write(bytes, 16);
+    // Pretend the printing cog has announced it is about to overwrite the first three slots
+    testable.m_reserved += 3;
+
+    testable.send_copy();
+    ASSERT_EQ_MSG(3, testable.get_dropped_bytes());
+    ASSERT_EQ_MSG(13, uart.length);
+    ASSERT_EQ_MSG(0, memcmp("3456789abcdef", uart.sent, 13));
+}
+
+int main () {
+    START(BufferedUARTTXTest);
+
+    RUN_TEST_F(BufferedUARTTXTest, Printer_returnsBeforeTransmitting);
+    RUN_TEST_F(BufferedUARTTXTest, Block_wrapsAroundRing);
+    RUN_TEST_F(BufferedUARTTXTest, DropNewest_discardsBytesThatDoNotFit);
+    RUN_TEST_F(BufferedUARTTXTest, DropOldest_keepsNewestBytes);
+    RUN_TEST_F(BufferedUARTTXTest, DropOldest_skipsBytesOverwrittenDuringCopy);
+
+    COMPLETE();
+}
@@ -0,0 +1,101 @@
+/**
+ * @file    bufferpool_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareTests.h"
+#include <PropWare/memory/bufferpool.h>
+
+using PropWare::BlockStorage;
+using PropWare::BufferPool;
+
+static const uint16_t SECTOR_SIZE = 512;
+static const uint8_t  POOL_SLOTS  = 2;
+
+class BufferPoolTest {
+    public:
+        BufferPoolTest ()
+                : testable(pool, slots, POOL_SLOTS, SECTOR_SIZE) {
+        }
+
+    public:
+        uint8_t          pool[POOL_SLOTS * SECTOR_SIZE];
+        BufferPool::Slot slots[POOL_SLOTS];
+        BufferPool       testable;
+};
+
+TEST_F(BufferPoolTest, Acquire_distinctBuffersWhileAvailable) {
+    BlockStorage::Buffer &first  = testable.acquire();
+    BlockStorage::Buffer &second = testable.acquire();
+
+    ASSERT_NEQ_MSG((unsigned int) &first, (unsigned int) &second);
+    ASSERT_NEQ_MSG((unsigned int) first.buf, (unsigned int) second.buf);
+    ASSERT_EQ_MSG(1, testable.get_max_users());
+}
+
+TEST_F(BufferPoolTest, Acquire_sharesOldestWhenExhausted) {
+    BlockStorage::Buffer &first = testable.acquire();
+    testable.acquire();
+    BlockStorage::Buffer &third = testable.acquire();
+
+    ASSERT_EQ_MSG((unsigned int) &first, (unsigned int) &third);
+    ASSERT_EQ_MSG(2, testable.get_max_users());
+}
+
+TEST_F(BufferPoolTest, Release_makesBufferAvailable) {
+    testable.acquire();
+    BlockStorage::Buffer &second = testable.acquire();
+
+    testable.release(second);
+    BlockStorage::Buffer &third = testable.acquire();
+
+    ASSERT_EQ_MSG((unsigned int) &second, (unsigned int) &third);
+    ASSERT_EQ_MSG(1, testable.get_max_users());
+}
+
+TEST_F(BufferPoolTest, Exchange_movesSharedUserToFreeBuffer) {
+    BlockStorage::Buffer &first  = testable.acquire();
+    BlockStorage::Buffer &second = testable.acquire();
+    BlockStorage::Buffer &shared = testable.acquire();
+
+    // Nothing is free yet
+    ASSERT_EQ_MSG((unsigned int) &shared, (unsigned int) &testable.exchange(shared));
+
+    testable.release(second);
+    ASSERT_EQ_MSG((unsigned int) &second, (unsigned int) &testable.exchange(shared));
+    ASSERT_EQ_MSG(1, testable.get_max_users());
+
+    // A buffer with only one user is never traded away
+    ASSERT_EQ_MSG((unsigned int) &first, (unsigned int) &testable.exchange(first));
+}
+
+int main () {
+    START(BufferPoolTest);
+
+    RUN_TEST_F(BufferPoolTest, Acquire_distinctBuffersWhileAvailable);
+    RUN_TEST_F(BufferPoolTest, Acquire_sharesOldestWhenExhausted);
+    RUN_TEST_F(BufferPoolTest, Release_makesBufferAvailable);
+    RUN_TEST_F(BufferPoolTest, Exchange_movesSharedUserToFreeBuffer);
+
+    COMPLETE();
+}
@@ -105,6 +105,46 @@ TEST_F(EepromTest, PutGet_Array) {
     ASSERT_EQ_MSG(0, strcmp((char *) sampleBytes2, (char *) buffer));
 }
 
+TEST_F(EepromTest, PutGet_ArrayAcrossPageBoundary) {
+    const uint16_t startAddress = Eeprom::DEFAULT_INITIAL_MEMORY_ADDRESS + Eeprom::PAGE_SIZE - 10;
+    uint8_t        sampleBytes[100];
+    uint8_t        buffer[sizeof(sampleBytes)];
+
+    for (unsigned int i = 0; i < sizeof(sampleBytes); ++i)
+        sampleBytes[i] = (uint8_t) (i + 1);
+
+    ASSERT_TRUE(testable.put(startAddress, sampleBytes, sizeof(sampleBytes)));
+    ASSERT_TRUE(testable.get(startAddress, buffer, sizeof(buffer)));
+    ASSERT_EQ_MSG(0, memcmp(sampleBytes, buffer, sizeof(buffer)));
+}
+
+TEST_F(EepromTest, PutChar_CombinesUntilFlush) {
+    testable.put_char('H');
+    testable.put_char('i');
+    ASSERT_EQ_MSG(Eeprom::DEFAULT_INITIAL_MEMORY_ADDRESS, testable.m_pendingAddress);
+    ASSERT_EQ_MSG(2, testable.m_pendingLength);
+
+    ASSERT_TRUE(testable.flush());
+    ASSERT_EQ_MSG(0, testable.m_pendingLength);
+
+    ASSERT_EQ_MSG('H', testable.get(Eeprom::DEFAULT_INITIAL_MEMORY_ADDRESS));
+    ASSERT_EQ_MSG('i', testable.get(Eeprom::DEFAULT_INITIAL_MEMORY_ADDRESS + 1));
+}
+
+TEST_F(EepromTest, PutChar_CommitsAtPageBoundary) {
+    const uint16_t pageStart = Eeprom::DEFAULT_INITIAL_MEMORY_ADDRESS + Eeprom::PAGE_SIZE;
+
+    testable.set_memory_address(pageStart - 1);
+    testable.put_char('a');
+    testable.put_char('b');
+    ASSERT_EQ_MSG(pageStart, testable.m_pendingAddress);
+    ASSERT_EQ_MSG(1, testable.m_pendingLength);
+
+    ASSERT_EQ_MSG('a', testable.get(pageStart - 1));
+    ASSERT_EQ_MSG(0, testable.m_pendingLength);
+    ASSERT_EQ_MSG('b', testable.get(pageStart));
+}
+
 TEST_F(EepromTest, PutChar_IncrementEnabled) {
     testable.set_auto_increment(true);
 
@@ -174,6 +214,9 @@ int main () {
     RUN_TEST_F(EepromTest, Ping);
     RUN_TEST_F(EepromTest, PutGet_SingleByte);
     RUN_TEST_F(EepromTest, PutGet_Array);
+    RUN_TEST_F(EepromTest, PutGet_ArrayAcrossPageBoundary);
+    RUN_TEST_F(EepromTest, PutChar_CombinesUntilFlush);
+    RUN_TEST_F(EepromTest, PutChar_CommitsAtPageBoundary);
     RUN_TEST_F(EepromTest, PutChar_IncrementEnabled);
     RUN_TEST_F(EepromTest, PutChar_IncrementDisabled);
     RUN_TEST_F(EepromTest, GetChar_IncrementEnabled);
@@ -0,0 +1,86 @@
+/**
+ * @file    eepromblockstorage_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * Hardware:
+ *      Standard Propeller with an EEPROM 64 kB or greater
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareTests.h"
+#include <PropWare/memory/eepromblockstorage.h>
+
+using PropWare::Eeprom;
+using PropWare::EepromBlockStorage;
+
+class EepromBlockStorageTest {
+    public:
+        EepromBlockStorageTest ()
+                : testable(eeprom) {
+        }
+
+    public:
+        Eeprom             eeprom;
+        uint8_t            original[EepromBlockStorage::SECTOR_SIZE];
+        uint8_t            buffer[EepromBlockStorage::SECTOR_SIZE];
+        EepromBlockStorage testable;
+};
+
+TEST_F(EepromBlockStorageTest, Start) {
+    ASSERT_EQ_MSG(0, testable.start());
+    ASSERT_EQ_MSG(EepromBlockStorage::DEFAULT_BLOCK_COUNT, testable.get_block_count());
+}
+
+TEST_F(EepromBlockStorageTest, ReadWrite_roundTrip) {
+    const uint32_t address = EepromBlockStorage::DEFAULT_BLOCK_COUNT - 1;
+    uint8_t        myData[EepromBlockStorage::SECTOR_SIZE];
+
+    for (unsigned int i = 0; i < sizeof(myData); ++i)
+        myData[i] = (uint8_t) (i * 3);
+
+    ASSERT_EQ_MSG(0, testable.read_data_block(address, original));
+
+    ASSERT_EQ_MSG(0, testable.write_data_block(address, myData));
+    ASSERT_EQ_MSG(0, testable.read_data_block(address, buffer));
+    ASSERT_EQ_MSG(0, memcmp(myData, buffer, sizeof(buffer)));
+
+    ASSERT_EQ_MSG(0, testable.write_data_block(address, original));
+    ASSERT_EQ_MSG(0, testable.read_data_block(address, buffer));
+    ASSERT_EQ_MSG(0, memcmp(original, buffer, sizeof(buffer)));
+}
+
+TEST_F(EepromBlockStorageTest, ReadWrite_rejectsAddressBeyondEnd) {
+    ASSERT_EQ_MSG(EepromBlockStorage::INVALID_ADDRESS,
+                  testable.read_data_block(EepromBlockStorage::DEFAULT_BLOCK_COUNT, buffer));
+    ASSERT_EQ_MSG(EepromBlockStorage::INVALID_ADDRESS,
+                  testable.write_data_block(EepromBlockStorage::DEFAULT_BLOCK_COUNT, buffer));
+}
+
+int main () {
+    START(EepromBlockStorageTest);
+
+    RUN_TEST_F(EepromBlockStorageTest, Start);
+    RUN_TEST_F(EepromBlockStorageTest, ReadWrite_roundTrip);
+    RUN_TEST_F(EepromBlockStorageTest, ReadWrite_rejectsAddressBeyondEnd);
+
+    COMPLETE();
+}
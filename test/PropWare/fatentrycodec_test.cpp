@@ -0,0 +1,87 @@
+/**
+ * @file    fatentrycodec_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareTests.h"
+#include <PropWare/filesystem/fat/fatentrycodec.h>
+
+using PropWare::FatEntryCodec;
+using PropWare::Fat12EntryCodec;
+using PropWare::Fat16EntryCodec;
+using PropWare::Fat32EntryCodec;
+using PropWare::ExFatEntryCodec;
+
+TEST(Fat12_neighborsShareAByte) {
+    const FatEntryCodec &codec = Fat12EntryCodec::get_instance();
+    uint8_t             fat[6] = {0};
+
+    ASSERT_EQ_MSG(3, codec.get_offset(2));
+    ASSERT_EQ_MSG(4, codec.get_offset(3));
+
+    // Write entries 2 and 3, which share the middle byte of fat[3..5]
+    uint32_t raw = fat[3] | (fat[4] << 8);
+    raw = codec.encode(raw, 2, 0xABC);
+    fat[3] = (uint8_t) raw;
+    fat[4] = (uint8_t) (raw >> 8);
+
+    raw = fat[4] | (fat[5] << 8);
+    raw = codec.encode(raw, 3, 0x123);
+    fat[4] = (uint8_t) raw;
+    fat[5] = (uint8_t) (raw >> 8);
+
+    ASSERT_EQ_MSG(0xBC, fat[3]);
+    ASSERT_EQ_MSG(0x3A, fat[4]);
+    ASSERT_EQ_MSG(0x12, fat[5]);
+
+    ASSERT_EQ_MSG(0xABC, codec.decode(fat[3] | (fat[4] << 8), 2));
+    ASSERT_EQ_MSG(0x123, codec.decode(fat[4] | (fat[5] << 8), 3));
+}
+
+TEST(Fat32_preservesReservedBits) {
+    const FatEntryCodec &codec = Fat32EntryCodec::get_instance();
+
+    ASSERT_EQ_MSG(0xF0000005, codec.encode(0xF1234567, 7, 5));
+    ASSERT_EQ_MSG(0x01234567, codec.decode(0xF1234567, 7));
+}
+
+TEST(IsEoc_eachFlavor) {
+    ASSERT_TRUE(Fat12EntryCodec::get_instance().is_eoc(0xFF8));
+    ASSERT_FALSE(Fat12EntryCodec::get_instance().is_eoc(0xFF7));
+    ASSERT_TRUE(Fat16EntryCodec::get_instance().is_eoc(0xFFFF));
+    ASSERT_FALSE(Fat16EntryCodec::get_instance().is_eoc(0xFFF7));
+    ASSERT_TRUE(Fat32EntryCodec::get_instance().is_eoc(0xFFFFFFF8));
+    ASSERT_FALSE(Fat32EntryCodec::get_instance().is_eoc(0x0FFFFFF7));
+    ASSERT_TRUE(ExFatEntryCodec::get_instance().is_eoc(0xFFFFFFFF));
+    ASSERT_FALSE(ExFatEntryCodec::get_instance().is_eoc(0x0FFFFFFF));
+}
+
+int main () {
+    START(FatEntryCodecTest);
+
+    RUN_TEST(Fat12_neighborsShareAByte);
+    RUN_TEST(Fat32_preservesReservedBits);
+    RUN_TEST(IsEoc_eachFlavor);
+
+    COMPLETE();
+}
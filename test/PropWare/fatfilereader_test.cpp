@@ -64,6 +64,8 @@ void error_checker (const PropWare::ErrorCode err) {
         FatFS::print_error_str(pwOut, (const Filesystem::ErrorCode) err);
     else if (FatFS::BEG_ERROR <= err && err <= FatFS::END_ERROR)
         pwOut << "No print string yet for FatFS's error #" << err - FatFS::BEG_ERROR << " (raw = " << err << ")\n";
+    else if (FatFile::BEG_ERROR <= err && err <= FatFile::END_ERROR)
+        FatFile::print_error_str(pwOut, (const FatFile::ErrorCode) err);
     else if (err)
         pwOut << "Unknown error: " << err << '\n';
 }
@@ -211,6 +213,206 @@ TEST_F(FatFileReaderTest, Seek) {
     }
 }
 
+TEST_F(FatFileReaderTest, Seek_withExtentCache) {
+    const int           SEEK_ITERATIONS = 2048;
+    char                stringBuffer[SEEK_ITERATIONS];
+    StaticStringBuilder stringBuilder(stringBuffer);
+    FatFile::Extent     extents[4];
+    PropWare::ErrorCode err;
+
+    testable = new FatFileReader(g_fs, FILE_NAME);
+    err      = testable->open();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    testable->set_extent_cache(extents, 4);
+    ASSERT_EQ_MSG(1, testable->m_extentCoverage);
+
+    for (int i = 0; i < SEEK_ITERATIONS - 1; ++i) {
+        char c;
+        err = testable->safe_get_char(c);
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+        stringBuilder.put_char(c);
+    }
+    ASSERT_EQ_MSG(testable->m_curTier2 + 1, testable->m_extentCoverage);
+
+    srand(CNT);
+    for (int i = 0; i < 128; ++i) {
+        const int charIndex = rand() % (SEEK_ITERATIONS - 1);
+        err = testable->seek(charIndex, File::SeekDir::BEG);
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+
+        char actual;
+        err = testable->safe_get_char(actual);
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+        ASSERT_EQ_MSG(stringBuilder.to_string()[charIndex], actual);
+    }
+}
+
+TEST_F(FatFileReaderTest, GetChar_withReadAhead) {
+    const int           CHARS = 2048;
+    char                stringBuffer[CHARS];
+    StaticStringBuilder stringBuilder(stringBuffer);
+    uint8_t             *readAhead = new uint8_t[g_driver.get_sector_size()];
+    PropWare::ErrorCode err;
+
+    testable = new FatFileReader(g_fs, FILE_NAME);
+    err      = testable->open();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    for (int i = 0; i < CHARS - 1; ++i) {
+        char c;
+        err = testable->safe_get_char(c);
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+        stringBuilder.put_char(c);
+    }
+
+    err = testable->seek(0, File::SeekDir::BEG);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    err = testable->set_read_ahead(readAhead);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    for (int i = 0; i < CHARS - 1; ++i) {
+        char actual;
+        err = testable->safe_get_char(actual);
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+        ASSERT_EQ_MSG(stringBuilder.to_string()[i], actual);
+    }
+    // Reading sequentially must leave the sector after the current one waiting in the read-ahead buffer
+    ASSERT_EQ_MSG(testable->m_curTier1 + 1, testable->m_readAheadSector);
+
+    testable->close();
+    delete readAhead;
+}
+
+TEST_F(FatFileReaderTest, Read_unalignedAcrossSectors) {
+    const int           CHARS  = 2048;
+    const int           OFFSET = 37;
+    char                stringBuffer[CHARS];
+    StaticStringBuilder stringBuilder(stringBuffer);
+    uint8_t             *direct = new uint8_t[CHARS];
+    size_t              bytesRead;
+    PropWare::ErrorCode err;
+
+    testable = new FatFileReader(g_fs, FILE_NAME);
+    err      = testable->open();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    for (int i = 0; i < CHARS - 1; ++i) {
+        char c;
+        err = testable->safe_get_char(c);
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+        stringBuilder.put_char(c);
+    }
+
+    // The buffer now holds the last sector, so starting part way into the first sends everything up to the last
+    // sector boundary through BlockStorage::read_data_segments
+    err = testable->seek(OFFSET, File::SeekDir::BEG);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    err = testable->read(direct, CHARS - 1 - OFFSET, &bytesRead);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    ASSERT_EQ_MSG(CHARS - 1 - OFFSET, bytesRead);
+    ASSERT_EQ_MSG(0, memcmp(&stringBuilder.to_string()[OFFSET], direct, bytesRead));
+
+    testable->close();
+    delete direct;
+}
+
+TEST_F(FatFileReaderTest, Read_withReadAheadPending) {
+    const int           CHARS  = 2048;
+    const int           OFFSET = g_driver.get_sector_size() + 10;
+    char                stringBuffer[CHARS];
+    StaticStringBuilder stringBuilder(stringBuffer);
+    uint8_t             *readAhead = new uint8_t[g_driver.get_sector_size()];
+    uint8_t             *direct    = new uint8_t[CHARS];
+    size_t              bytesRead;
+    PropWare::ErrorCode err;
+
+    testable = new FatFileReader(g_fs, FILE_NAME);
+    err      = testable->open();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    for (int i = 0; i < CHARS - 1; ++i) {
+        char c;
+        err = testable->safe_get_char(c);
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+        stringBuilder.put_char(c);
+    }
+
+    err = testable->seek(0, File::SeekDir::BEG);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    err = testable->set_read_ahead(readAhead);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    // Moving sequentially into the second sector begins fetching the third
+    for (int i = 0; i < OFFSET; ++i) {
+        char c;
+        err = testable->safe_get_char(c);
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+    }
+    ASSERT_EQ_MSG(2, testable->m_readAheadSector);
+
+    // The rest of the file must come from the read-ahead buffer and direct reads that wait for it
+    err = testable->read(direct, CHARS - 1 - OFFSET, &bytesRead);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    ASSERT_EQ_MSG(CHARS - 1 - OFFSET, bytesRead);
+    ASSERT_EQ_MSG(0, memcmp(&stringBuilder.to_string()[OFFSET], direct, bytesRead));
+    ASSERT_FALSE(testable->m_readAheadPending);
+
+    testable->close();
+    delete direct;
+    delete readAhead;
+}
+
+TEST_F(FatFileReaderTest, ReadSectors_unalignedPointer) {
+    const int           OFFSET = 37;
+    uint8_t             *direct = new uint8_t[g_driver.get_sector_size()];
+    PropWare::ErrorCode err;
+
+    testable = new FatFileReader(g_fs, FILE_NAME);
+    err      = testable->open();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    err = testable->seek(OFFSET, File::SeekDir::BEG);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    // The error must be reported as FatFile's own code, not as one shared with FatFS
+    err = testable->read_sectors(direct, 1);
+    ASSERT_EQ_MSG(FatFile::UNALIGNED_POINTER, err);
+    ASSERT_TRUE(FatFS::END_ERROR < err);
+    ASSERT_EQ_MSG(OFFSET, testable->tell());
+
+    err = testable->seek(0, File::SeekDir::BEG);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    err = testable->read_sectors(direct, 1);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    ASSERT_EQ_MSG(g_driver.get_sector_size(), testable->tell());
+
+    testable->close();
+    delete direct;
+}
+
 int main () {
     START(FatFileReaderTest);
 
@@ -232,6 +434,11 @@ int main () {
     RUN_TEST_F(FatFileReaderTest, SafeGetChar);
     RUN_TEST_F(FatFileReaderTest, Tell);
     RUN_TEST_F(FatFileReaderTest, Seek);
+    RUN_TEST_F(FatFileReaderTest, Seek_withExtentCache);
+    RUN_TEST_F(FatFileReaderTest, GetChar_withReadAhead);
+    RUN_TEST_F(FatFileReaderTest, Read_unalignedAcrossSectors);
+    RUN_TEST_F(FatFileReaderTest, Read_withReadAheadPending);
+    RUN_TEST_F(FatFileReaderTest, ReadSectors_unalignedPointer);
 
     COMPLETE();
 }
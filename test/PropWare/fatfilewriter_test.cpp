@@ -44,12 +44,20 @@ using PropWare::Filesystem;
 using PropWare::FatFS;
 using PropWare::FatFileWriter;
 using PropWare::FatFileReader;
+using PropWare::FatFile;
 using PropWare::BlockStorage;
 using PropWare::File;
 
 static const char EXISTING_FILE[]       = "fat_test.txt";
 static const char EXISTING_FILE_UPPER[] = "FAT_TEST.TXT";
 static const char NEW_FILE_NAME[]       = "new_test.txt";
+static const char LONG_FILE_NAME[]      = "Long File Name Test.txt";
+static const char LONG_FILE_ALIAS[]     = "LONGFI~1.TXT";
+static const char VERY_LONG_FILE_NAME[] = "A file name much longer than thirty-two characters, "
+                                          "spanning six entries.txt";
+static const char TEST_DIRECTORY[]      = "test_dir";
+static const char FILE_IN_DIRECTORY[]   = "/test_dir/in_dir.txt";
+static const char LONG_PATH[]           = "/test_dir/./../test_dir/a name that is longer than thirty-two.txt";
 static SD         g_driver;
 static FatFS      g_fs(g_driver);
 
@@ -63,6 +71,8 @@ void error_checker (const PropWare::ErrorCode err) {
             FatFS::print_error_str(pwOut, (const Filesystem::ErrorCode) err);
         else if (FatFS::BEG_ERROR <= err && err <= FatFS::END_ERROR)
             pwOut << "No print string yet for FatFS's error #" << err - FatFS::BEG_ERROR << " (raw = " << err << ")\n";
+        else if (FatFile::BEG_ERROR <= err && err <= FatFile::END_ERROR)
+            FatFile::print_error_str(pwOut, (const FatFile::ErrorCode) err);
         else
             pwOut << "Unknown error: " << err << '\n';
     }
@@ -178,6 +188,165 @@ TEST_F(FatFileWriterTest, OpenCloseDelete_NonExistingFile) {
     ASSERT_FALSE(testable->exists());
 }
 
+TEST_F(FatFileWriterTest, OpenCloseDelete_LongFileName) {
+    PropWare::ErrorCode       err;
+    FatFS::DirectoryIndexSlot index[32];
+
+    g_fs.set_directory_index(index, sizeof(index) / sizeof(index[0]));
+
+    testable = new FatFileWriter(g_fs, LONG_FILE_NAME);
+    ASSERT_FALSE(testable->exists());
+
+    err = testable->open();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    err = testable->close();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    clear_buffer(testable);
+
+    // The file can be found by its long name, regardless of case, and by its short alias
+    FatFileReader byLongName(g_fs, "LONG FILE NAME TEST.TXT", m_buffer);
+    ASSERT_EQ_MSG(0, byLongName.open());
+    byLongName.close();
+    FatFileReader byAlias(g_fs, LONG_FILE_ALIAS, m_buffer);
+    ASSERT_EQ_MSG(0, byAlias.open());
+    byAlias.close();
+    clear_buffer(g_fs.get_driver(), &m_buffer);
+
+    err = testable->remove();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    clear_buffer(testable);
+    ASSERT_FALSE(testable->exists());
+    FatFileReader removedAlias(g_fs, LONG_FILE_ALIAS, m_buffer);
+    ASSERT_EQ_MSG(FatFile::FILENAME_NOT_FOUND, removedAlias.open());
+
+    g_fs.set_directory_index(NULL, 0);
+}
+
+TEST_F(FatFileWriterTest, OpenCloseDelete_VeryLongFileName) {
+    PropWare::ErrorCode err;
+
+    testable = new FatFileWriter(g_fs, VERY_LONG_FILE_NAME);
+    err = testable->open();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    err = testable->close();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    clear_buffer(testable);
+
+    FatFileReader byLongName(g_fs, VERY_LONG_FILE_NAME, m_buffer);
+    ASSERT_EQ_MSG(0, byLongName.open());
+    byLongName.close();
+    clear_buffer(g_fs.get_driver(), &m_buffer);
+
+    err = testable->remove();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    clear_buffer(testable);
+    ASSERT_FALSE(testable->exists());
+}
+
+TEST_F(FatFileWriterTest, Open_nameTooLong) {
+    char name[File::MAX_FILENAME_LENGTH + 1];
+    memset(name, 'a', sizeof(name) - 1);
+    name[sizeof(name) - 1] = 0;
+
+    testable = new FatFileWriter(g_fs, name);
+    ASSERT_EQ_MSG(File::INVALID_FILENAME, testable->open());
+    ASSERT_FALSE(testable->exists());
+}
+
+TEST_F(FatFileWriterTest, Mkdir_openByPathAndChdir) {
+    PropWare::ErrorCode err;
+
+    // Directories can not yet be removed, so the one from a previous run may still be here
+    err = g_fs.mkdir(TEST_DIRECTORY, m_buffer);
+    if (FatFile::ENTRY_EXISTS != err) {
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+    }
+    clear_buffer(g_fs.get_driver(), &m_buffer);
+    ASSERT_EQ_MSG(FatFile::ENTRY_EXISTS, g_fs.mkdir("TEST_DIR", m_buffer));
+    clear_buffer(g_fs.get_driver(), &m_buffer);
+    ASSERT_EQ_MSG(FatFile::ENTRY_NOT_DIRECTORY, g_fs.mkdir("fat_test.txt/nope", m_buffer));
+    clear_buffer(g_fs.get_driver(), &m_buffer);
+
+    testable = new FatFileWriter(g_fs, FILE_IN_DIRECTORY);
+    err = testable->open();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    testable->put_char('x');
+    err = testable->close();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    clear_buffer(testable);
+
+    // The file is not in the root directory, but can be reached relative to its own
+    FatFileReader fromRoot(g_fs, "in_dir.txt", m_buffer);
+    ASSERT_EQ_MSG(FatFile::FILENAME_NOT_FOUND, fromRoot.open());
+    clear_buffer(g_fs.get_driver(), &m_buffer);
+
+    ASSERT_EQ_MSG(0, g_fs.chdir(TEST_DIRECTORY, m_buffer));
+    FatFileReader relative(g_fs, "in_dir.txt", m_buffer);
+    ASSERT_EQ_MSG(0, relative.open());
+    ASSERT_EQ_MSG(1, relative.get_length());
+    relative.close();
+    clear_buffer(g_fs.get_driver(), &m_buffer);
+    FatFileReader parent(g_fs, "../fat_test.txt", m_buffer);
+    ASSERT_EQ_MSG(0, parent.open());
+    parent.close();
+    clear_buffer(g_fs.get_driver(), &m_buffer);
+    ASSERT_EQ_MSG(0, g_fs.chdir("/", m_buffer));
+    clear_buffer(g_fs.get_driver(), &m_buffer);
+
+    err = testable->remove();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+}
+
+TEST_F(FatFileWriterTest, Open_longPathThroughDirectories) {
+    PropWare::ErrorCode err;
+    char                tooLong[File::MAX_FILENAME_LENGTH + 1];
+
+    err = g_fs.mkdir(TEST_DIRECTORY, m_buffer);
+    if (FatFile::ENTRY_EXISTS != err) {
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+    }
+    clear_buffer(g_fs.get_driver(), &m_buffer);
+
+    testable = new FatFileWriter(g_fs, LONG_PATH);
+    err = testable->open();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    err = testable->close();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    clear_buffer(testable);
+
+    FatFileReader reader(g_fs, "/TEST_DIR/A Name That Is Longer Than Thirty-Two.txt", m_buffer);
+    ASSERT_EQ_MSG(0, reader.open());
+    reader.close();
+    clear_buffer(g_fs.get_driver(), &m_buffer);
+
+    // Paths that do not fit are rejected rather than truncated
+    memset(tooLong, 0, sizeof(tooLong));
+    strcpy(tooLong, "/test_dir/");
+    memset(&tooLong[strlen(tooLong)], 'a', sizeof(tooLong) - strlen(tooLong) - 1);
+    ASSERT_EQ_MSG(File::INVALID_FILENAME, g_fs.chdir(tooLong, m_buffer));
+    FatFileReader tooLongReader(g_fs, tooLong, m_buffer);
+    ASSERT_EQ_MSG(File::INVALID_FILENAME, tooLongReader.open());
+    clear_buffer(g_fs.get_driver(), &m_buffer);
+
+    err = testable->remove();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+}
+
 TEST_F(FatFileWriterTest, SafePutChar_FileNotOpened) {
     // TODO
 }
@@ -352,6 +521,224 @@ TEST_F(FatFileWriterTest, CopyFile) {
     ASSERT_FALSE(testable->exists());
 }
 
+TEST_F(FatFileWriterTest, Preallocate_releasesUnusedClustersOnClose) {
+    PropWare::ErrorCode err;
+
+    testable = new FatFileWriter(g_fs, NEW_FILE_NAME);
+    err = testable->open();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    const uint32_t clusterSize   = (uint32_t) g_driver.get_sector_size() << g_fs.get_tier1s_per_tier2_shift();
+    const uint32_t freeAfterOpen = g_fs.get_free_cluster_count();
+
+    err = testable->preallocate(4 * clusterSize);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    if (FatFS::UNKNOWN_FREE_COUNT != freeAfterOpen)
+        ASSERT_EQ_MSG(freeAfterOpen - 3, g_fs.get_free_cluster_count());
+
+    // The reserved clusters should be consecutive
+    uint32_t cluster;
+    ASSERT_EQ_MSG(0, g_fs.get_fat_value(testable->firstTier2, &cluster));
+    for (unsigned int i = 0; i < 2; ++i) {
+        uint32_t next;
+        ASSERT_EQ_MSG(0, g_fs.get_fat_value(cluster, &next));
+        ASSERT_EQ_MSG(cluster + 1, next);
+        cluster = next;
+    }
+
+    const char testString[] = "Sample text line\n";
+    err = testable->safe_puts(testString);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    err = testable->close();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    ASSERT_EQ_MSG(freeAfterOpen, g_fs.get_free_cluster_count());
+    ASSERT_EQ_MSG(0, g_fs.get_fat_value(testable->firstTier2, &cluster));
+    ASSERT_TRUE(g_fs.is_eoc(cluster));
+
+    err = testable->remove();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err); // testable->remove()
+    err = testable->flush();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err); // testable->flush()
+
+    clear_buffer(testable);
+    ASSERT_FALSE(testable->exists());
+}
+
+TEST_F(FatFileWriterTest, OpenJournaled_directoryUpdatedOnClose) {
+    PropWare::ErrorCode err;
+
+    testable = new FatFileWriter(g_fs, NEW_FILE_NAME);
+    err = testable->open_journaled();
+    if (FatFS::JOURNAL_UNAVAILABLE == err)
+        // The test card is formatted without room for a journal (such as FAT16) - nothing to test
+        return;
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    const char testString[] = "Sample text line\n";
+    ASSERT_EQ_MSG(0, testable->safe_puts(testString));
+    ASSERT_EQ_MSG(0, testable->commit());
+    clear_buffer(testable);
+
+    // Only one file can be journaled at a time
+    FatFileWriter other(g_fs, EXISTING_FILE, m_buffer);
+    ASSERT_EQ_MSG(FatFS::JOURNAL_BUSY, other.open_journaled());
+
+    // Commits leave the directory entry alone...
+    FatFileReader whileOpen(g_fs, NEW_FILE_NAME, m_buffer);
+    ASSERT_EQ_MSG(0, whileOpen.open());
+    ASSERT_EQ_MSG(0, whileOpen.get_length());
+    whileOpen.close();
+    clear_buffer(g_fs.get_driver(), &m_buffer);
+
+    // ...which is brought up to date when the file is closed
+    err = testable->close();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    clear_buffer(testable);
+    FatFileReader afterClose(g_fs, NEW_FILE_NAME, m_buffer);
+    ASSERT_EQ_MSG(0, afterClose.open());
+    ASSERT_EQ_MSG(sizeof(testString) - 1, afterClose.get_length());
+    afterClose.close();
+    clear_buffer(g_fs.get_driver(), &m_buffer);
+
+    err = testable->remove();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+}
+
+TEST_F(FatFileWriterTest, Write_unalignedAndAlignedSpans) {
+    PropWare::ErrorCode err;
+    const size_t        sectorSize = g_driver.get_sector_size();
+    const size_t        totalSize  = 5 * sectorSize;
+    uint8_t             *expected  = new uint8_t[totalSize];
+    uint8_t             *actual    = new uint8_t[totalSize];
+
+    for (size_t i = 0; i < totalSize; ++i)
+        expected[i] = (uint8_t) (i * 7 + (i >> 8));
+
+    testable = new FatFileWriter(g_fs, NEW_FILE_NAME);
+    err = testable->open();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    // A partial sector, then enough to finish that sector plus several whole sectors, then the remainder
+    const size_t firstSpan  = 17;
+    const size_t secondSpan = 3 * sectorSize;
+    err = testable->write(expected, firstSpan);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    err = testable->write(&expected[firstSpan], secondSpan);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    err = testable->write(&expected[firstSpan + secondSpan], totalSize - firstSpan - secondSpan);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    ASSERT_EQ_MSG(totalSize, testable->get_length());
+
+    err = testable->close();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    {
+        const BlockStorage   *driver = testable->m_driver;
+        BlockStorage::Buffer *buffer = testable->m_buf;
+        delete testable;
+        g_fs.flush_fat();
+
+        clear_buffer(driver, buffer);
+    }
+
+    FatFileReader reader(g_fs, NEW_FILE_NAME, m_buffer);
+    ASSERT_EQ_MSG(0, reader.open());
+    ASSERT_EQ_MSG(totalSize, reader.get_length());
+    size_t bytesRead;
+    ASSERT_EQ_MSG(0, reader.read(actual, 3, &bytesRead));
+    ASSERT_EQ_MSG(3, bytesRead);
+    ASSERT_EQ_MSG(File::EOF_ERROR, reader.read(&actual[3], totalSize, &bytesRead));
+    ASSERT_EQ_MSG(totalSize - 3, bytesRead);
+    ASSERT_EQ_MSG(0, memcmp(expected, actual, totalSize));
+    reader.close();
+
+    delete[] expected;
+    delete[] actual;
+
+    testable = new FatFileWriter(g_fs, NEW_FILE_NAME, m_buffer);
+    err      = testable->remove();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err); // testable->remove()
+    err = testable->flush();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err); // testable->flush()
+
+    clear_buffer(testable);
+    ASSERT_FALSE(testable->exists());
+}
+
+TEST_F(FatFileWriterTest, SafePutChar_withWriteBehind) {
+    PropWare::ErrorCode err;
+    const size_t        sectorSize   = g_driver.get_sector_size();
+    const size_t        totalSize    = 3 * sectorSize + 100;
+    uint8_t             *writeBehind = new uint8_t[sectorSize];
+
+    testable = new FatFileWriter(g_fs, NEW_FILE_NAME);
+    err = testable->open();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    err = testable->set_write_behind(writeBehind);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    for (size_t i = 0; i < totalSize; ++i) {
+        err = testable->safe_put_char((char) (i * 3 + (i >> 8)));
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+    }
+
+    err = testable->close();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    ASSERT_FALSE(testable->m_writeBehindPending);
+
+    {
+        const BlockStorage   *driver = testable->m_driver;
+        BlockStorage::Buffer *buffer = testable->m_buf;
+        delete testable;
+        g_fs.flush_fat();
+
+        clear_buffer(driver, buffer);
+    }
+    delete[] writeBehind;
+
+    FatFileReader reader(g_fs, NEW_FILE_NAME, m_buffer);
+    ASSERT_EQ_MSG(0, reader.open());
+    ASSERT_EQ_MSG(totalSize, reader.get_length());
+    for (size_t i = 0; i < totalSize; ++i) {
+        char c;
+        ASSERT_EQ_MSG(0, reader.safe_get_char(c));
+        ASSERT_EQ_MSG((char) (i * 3 + (i >> 8)), c);
+    }
+    reader.close();
+
+    testable = new FatFileWriter(g_fs, NEW_FILE_NAME, m_buffer);
+    err      = testable->remove();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err); // testable->remove()
+    err = testable->flush();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err); // testable->flush()
+
+    clear_buffer(testable);
+    ASSERT_FALSE(testable->exists());
+}
+
 int main () {
     PropWare::ErrorCode err;
 
@@ -370,9 +757,18 @@ int main () {
     RUN_TEST_F(FatFileWriterTest, Exists_doesExist);
     RUN_TEST_F(FatFileWriterTest, OpenClose_ExistingFile);
     RUN_TEST_F(FatFileWriterTest, OpenCloseDelete_NonExistingFile);
+    RUN_TEST_F(FatFileWriterTest, OpenCloseDelete_LongFileName);
+    RUN_TEST_F(FatFileWriterTest, OpenCloseDelete_VeryLongFileName);
+    RUN_TEST_F(FatFileWriterTest, Open_nameTooLong);
+    RUN_TEST_F(FatFileWriterTest, Mkdir_openByPathAndChdir);
+    RUN_TEST_F(FatFileWriterTest, Open_longPathThroughDirectories);
     RUN_TEST_F(FatFileWriterTest, SafePutChar_singleChar);
     RUN_TEST_F(FatFileWriterTest, SafePutChar_MultiLine);
     RUN_TEST_F(FatFileWriterTest, CopyFile);
+    RUN_TEST_F(FatFileWriterTest, Preallocate_releasesUnusedClustersOnClose);
+    RUN_TEST_F(FatFileWriterTest, Write_unalignedAndAlignedSpans);
+    RUN_TEST_F(FatFileWriterTest, SafePutChar_withWriteBehind);
+    RUN_TEST_F(FatFileWriterTest, OpenJournaled_directoryUpdatedOnClose);
 
     COMPLETE();
 }
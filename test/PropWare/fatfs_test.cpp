@@ -114,6 +114,107 @@ TEST_F(FatFsTest, Mount_partition4) {
     ASSERT_EQ_MSG(FatFS::UNSUPPORTED_FILESYSTEM, err);
 }
 
+TEST_F(FatFsTest, FindEmptySpace_usesAndMaintainsNextFreeHint) {
+    PropWare::ErrorCode err;
+    uint8_t             buffer[g_driver.get_sector_size()];
+    uint32_t            allocUnit;
+
+    err = testable.mount(buffer);
+    error_checker(err);
+    ASSERT_EQ_MSG(FatFS::NO_ERROR, err);
+
+    const uint32_t hint      = testable.m_nextFreeHint;
+    const uint32_t freeCount = testable.get_free_cluster_count();
+
+    err = testable.find_empty_space(&allocUnit);
+    error_checker(err);
+    ASSERT_EQ_MSG(FatFS::NO_ERROR, err);
+    ASSERT_TRUE(hint <= allocUnit);
+    ASSERT_EQ_MSG(allocUnit + 1, testable.m_nextFreeHint);
+    if (FatFS::UNKNOWN_FREE_COUNT != freeCount)
+        ASSERT_EQ_MSG(freeCount - 1, testable.get_free_cluster_count());
+
+    // Release the cluster again so that the card is left untouched
+    err = testable.clear_chain(allocUnit);
+    error_checker(err);
+    ASSERT_EQ_MSG(FatFS::NO_ERROR, err);
+    ASSERT_EQ_MSG(allocUnit, testable.m_nextFreeHint);
+    ASSERT_EQ_MSG(freeCount, testable.get_free_cluster_count());
+
+    err = testable.unmount();
+    error_checker(err);
+    ASSERT_EQ_MSG(FatFS::NO_ERROR, err);
+}
+
+TEST_F(FatFsTest, MarkAllocated_wrapsNextFreeHintAtEndOfVolume) {
+    PropWare::ErrorCode err;
+    uint8_t             buffer[g_driver.get_sector_size()];
+
+    err = testable.mount(buffer);
+    error_checker(err);
+    ASSERT_EQ_MSG(FatFS::NO_ERROR, err);
+
+    const uint32_t hint      = testable.m_nextFreeHint;
+    const uint32_t freeCount = testable.m_freeClusterCount;
+
+    testable.mark_allocated(testable.last_cluster() - 1, 1);
+    ASSERT_EQ_MSG(testable.last_cluster(), testable.m_nextFreeHint);
+    testable.mark_allocated(testable.last_cluster(), 1);
+    ASSERT_EQ_MSG(testable.first_free_search(), testable.m_nextFreeHint);
+
+    // Nothing was really allocated, so keep FSInfo on the card untouched
+    testable.m_nextFreeHint     = hint;
+    testable.m_freeClusterCount = freeCount;
+    testable.m_fsInfoMod        = false;
+
+    err = testable.unmount();
+    error_checker(err);
+    ASSERT_EQ_MSG(FatFS::NO_ERROR, err);
+}
+
+TEST_F(FatFsTest, SyncMirror_copiesDeferredSectors) {
+    PropWare::ErrorCode err;
+    uint8_t             buffer[g_driver.get_sector_size()];
+    uint8_t             primary[g_driver.get_sector_size()];
+    uint8_t             mirror[g_driver.get_sector_size()];
+    uint8_t             bitmap[16];
+    uint32_t            allocUnit;
+
+    err = testable.mount(buffer);
+    error_checker(err);
+    ASSERT_EQ_MSG(FatFS::NO_ERROR, err);
+    ASSERT_EQ_MSG(FatFS::NO_ERROR, testable.set_mirror_bitmap(bitmap, sizeof(bitmap)));
+
+    err = testable.find_empty_space(&allocUnit);
+    error_checker(err);
+    ASSERT_EQ_MSG(FatFS::NO_ERROR, err);
+    const uint32_t fatSector = testable.m_curFatSector;
+    ASSERT_EQ_MSG(FatFS::NO_ERROR, testable.flush_fat());
+
+    // Only the first FAT has been written so far
+    if (fatSector < 8 * sizeof(bitmap)) {
+        ASSERT_TRUE(testable.is_mirror_pending(fatSector));
+    }
+
+    err = testable.sync_mirror();
+    error_checker(err);
+    ASSERT_EQ_MSG(FatFS::NO_ERROR, err);
+    ASSERT_FALSE(testable.is_mirror_pending(fatSector));
+    ASSERT_EQ_MSG(0, g_driver.read_data_block(testable.m_fatStart + fatSector, primary));
+    ASSERT_EQ_MSG(0, g_driver.read_data_block(testable.m_fatStart + testable.m_fatSize + fatSector, mirror));
+    ASSERT_EQ_MSG(0, memcmp(primary, mirror, g_driver.get_sector_size()));
+
+    // Release the cluster again so that the card is left untouched
+    err = testable.clear_chain(allocUnit);
+    error_checker(err);
+    ASSERT_EQ_MSG(FatFS::NO_ERROR, err);
+
+    err = testable.unmount();
+    error_checker(err);
+    ASSERT_EQ_MSG(FatFS::NO_ERROR, err);
+    ASSERT_FALSE(testable.is_mirror_pending(fatSector));
+}
+
 TEST_F(FatFsTest, ClearChain) {
     // TODO: Write test (and don't forget to invoke it in main)
 }
@@ -126,6 +227,9 @@ int main () {
     RUN_TEST_F(FatFsTest, Mount_partition0);
     RUN_TEST_F(FatFsTest, Mount_partition1);
     RUN_TEST_F(FatFsTest, Mount_partition4);
+    RUN_TEST_F(FatFsTest, FindEmptySpace_usesAndMaintainsNextFreeHint);
+    RUN_TEST_F(FatFsTest, MarkAllocated_wrapsNextFreeHintAtEndOfVolume);
+    RUN_TEST_F(FatFsTest, SyncMirror_copiesDeferredSectors);
 
     COMPLETE();
 }
@@ -0,0 +1,106 @@
+/**
+ * @file    fullduplexserial_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareTests.h"
+#include <PropWare/serial/uart/fullduplexserial.h>
+
+using PropWare::FullDuplexSerial;
+
+/**
+ * The driver reads the receive pin with INA, which also reflects a pin driven by the cog itself, so using the same pin
+ * for both directions loops every transmitted byte back into the receive buffer without any wiring
+ */
+static const int LOOPBACK_PIN = 12;
+static const int BAUD_RATE    = 115200;
+
+class FullDuplexSerialTest {
+    public:
+        /**
+         * @brief   Wait until the driver has sent everything queued and the last byte has had time to come back
+         */
+        void wait_for_loopback (const FullDuplexSerial &testable) {
+            while (testable.m_transmitTail != testable.m_transmitHead);
+            waitcnt(2 * 10 * (CLKFREQ / BAUD_RATE) + CNT);
+        }
+
+        void fill (const size_t length) {
+            for (size_t i = 0; i < length; ++i)
+                this->sent[i] = (uint8_t) ('A' + i);
+        }
+
+    public:
+        uint8_t sent[40];
+        uint8_t received[40];
+};
+
+TEST_F(FullDuplexSerialTest, Write_readBackOnLoopback) {
+    FullDuplexSerial testable(LOOPBACK_PIN, LOOPBACK_PIN, 0, BAUD_RATE);
+    ASSERT_NEQ_MSG(-1, testable.start());
+    fill(12);
+
+    testable.write(sent, 12);
+    ASSERT_EQ_MSG(12, testable.read(received, 12, CLKFREQ / 10));
+    ASSERT_EQ_MSG(0, memcmp(sent, received, 12));
+    ASSERT_EQ_MSG(0, testable.get_receive_overruns());
+}
+
+TEST_F(FullDuplexSerialTest, Write_countsReceiveOverruns) {
+    FullDuplexSerial testable(LOOPBACK_PIN, LOOPBACK_PIN, 0, BAUD_RATE);
+    ASSERT_NEQ_MSG(-1, testable.start());
+    fill(sizeof(sent));
+
+    // One slot of the receive ring always stays empty, so every byte after the first N - 1 is dropped
+    testable.write(sent, sizeof(sent));
+    wait_for_loopback(testable);
+    const size_t capacity = FullDuplexSerial::BUFFER_SIZE - 1;
+    ASSERT_EQ_MSG(sizeof(sent) - capacity, testable.get_receive_overruns());
+    ASSERT_EQ_MSG(capacity, testable.read(received, sizeof(received), CLKFREQ / 100));
+    ASSERT_EQ_MSG(0, memcmp(sent, received, capacity));
+
+    testable.clear_receive_overruns();
+    ASSERT_EQ_MSG(0, testable.get_receive_overruns());
+}
+
+TEST_F(FullDuplexSerialTest, Write_ignoresEchoesOfBlockLongerThanReceiveBuffer) {
+    FullDuplexSerial testable(LOOPBACK_PIN, LOOPBACK_PIN, FullDuplexSerial::IGNORE_TX_ECHO_ON_RX, BAUD_RATE);
+    ASSERT_NEQ_MSG(-1, testable.start());
+    fill(sizeof(sent));
+
+    // Returning at all shows that no echo was lost
+    testable.write(sent, sizeof(sent));
+    wait_for_loopback(testable);
+    ASSERT_EQ_MSG(0, testable.get_receive_overruns());
+    ASSERT_FALSE(testable.receive_ready());
+}
+
+int main () {
+    START(FullDuplexSerialTest);
+
+    RUN_TEST_F(FullDuplexSerialTest, Write_readBackOnLoopback);
+    RUN_TEST_F(FullDuplexSerialTest, Write_countsReceiveOverruns);
+    RUN_TEST_F(FullDuplexSerialTest, Write_ignoresEchoesOfBlockLongerThanReceiveBuffer);
+
+    COMPLETE();
+}
@@ -0,0 +1,83 @@
+/**
+ * @file    ramblockstorage_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareTests.h"
+#include <PropWare/memory/ramblockstorage.h>
+
+using PropWare::BlockStorage;
+using PropWare::RamBlockStorage;
+
+static const uint8_t DEVICE_BLOCKS = 4;
+
+class RamBlockStorageTest {
+    public:
+        RamBlockStorageTest ()
+                : testable(image, DEVICE_BLOCKS) {
+            for (uint_fast16_t i = 0; i < sizeof(this->image); ++i)
+                this->image[i] = (uint8_t) (i ^ (i >> 9));
+        }
+
+    public:
+        uint8_t         image[DEVICE_BLOCKS * RamBlockStorage::SECTOR_SIZE];
+        uint8_t         buffer[2 * RamBlockStorage::SECTOR_SIZE];
+        RamBlockStorage testable;
+};
+
+TEST_F(RamBlockStorageTest, ReadWrite_roundTrip) {
+    ASSERT_EQ_MSG(0, testable.read_data_block(2, buffer));
+    ASSERT_EQ_MSG(0, memcmp(&image[2 * RamBlockStorage::SECTOR_SIZE], buffer, RamBlockStorage::SECTOR_SIZE));
+
+    memset(buffer, 0xA5, sizeof(buffer));
+    ASSERT_EQ_MSG(0, testable.write_data_blocks(1, 2, buffer));
+    ASSERT_EQ_MSG(0, memcmp(&image[RamBlockStorage::SECTOR_SIZE], buffer, sizeof(buffer)));
+}
+
+TEST_F(RamBlockStorageTest, ReadWrite_rejectsAddressBeyondEnd) {
+    ASSERT_EQ_MSG(RamBlockStorage::INVALID_ADDRESS, testable.read_data_block(DEVICE_BLOCKS, buffer));
+    ASSERT_EQ_MSG(RamBlockStorage::INVALID_ADDRESS, testable.write_data_blocks(DEVICE_BLOCKS - 1, 2, buffer));
+}
+
+TEST_F(RamBlockStorageTest, ReadDataSegments_crossesBlocks) {
+    const uint16_t        offset = 500;
+    const size_t          length = 30;
+    BlockStorage::Segment segment;
+    segment.address = 1;
+    segment.offset  = offset;
+    segment.length  = length;
+    segment.buf     = buffer;
+
+    ASSERT_EQ_MSG(0, testable.read_data_segments(&segment, 1, NULL));
+    ASSERT_EQ_MSG(0, memcmp(&image[RamBlockStorage::SECTOR_SIZE + offset], buffer, length));
+}
+
+int main () {
+    START(RamBlockStorageTest);
+
+    RUN_TEST_F(RamBlockStorageTest, ReadWrite_roundTrip);
+    RUN_TEST_F(RamBlockStorageTest, ReadWrite_rejectsAddressBeyondEnd);
+    RUN_TEST_F(RamBlockStorageTest, ReadDataSegments_crossesBlocks);
+
+    COMPLETE();
+}
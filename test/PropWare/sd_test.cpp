@@ -62,6 +62,23 @@ TEST_F(SdTest, Start) {
     ASSERT_EQ_MSG(SD::NO_ERROR, err);
 }
 
+TEST_F(SdTest, Start_negotiatesClockFromCsd) {
+    uint8_t csd[SD::CSD_LENGTH];
+
+    PropWare::ErrorCode err = testable.start();
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SD::NO_ERROR, err);
+
+    // The register must survive its CRC check at whichever clock was negotiated
+    err = testable.read_csd(csd);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SD::NO_ERROR, err);
+
+    const uint32_t cardLimit = SD::decode_tran_speed(csd[SD::CSD_TRAN_SPEED]);
+    ASSERT_TRUE(SD::FULL_SPEED_SPI <= (uint32_t) testable.m_spi->get_clock());
+    ASSERT_TRUE(cardLimit >= (uint32_t) testable.m_spi->get_clock());
+}
+
 TEST_F(SdTest, ReadDataBlock) {
     uint8_t buffer[SD::SECTOR_SIZE];
 
@@ -131,13 +148,124 @@ TEST_F(SdTest, WriteDataBlock) {
     MESSAGE("WriteBlock: Modded block matches original");
 }
 
+TEST(Crc16_matchesKnownBlock) {
+    uint8_t buffer[SD::SECTOR_SIZE];
+    memset(buffer, 0xff, sizeof(buffer));
+
+    ASSERT_EQ_MSG(0x7FA1, SD::crc16(buffer, sizeof(buffer)));
+}
+
+TEST(Crc7_matchesFixedCommandCrcs) {
+    ASSERT_EQ_MSG((SD::CRC_IDLE >> 1), SD::crc7(SD::CMD_IDLE, 0));
+    ASSERT_EQ_MSG((SD::CRC_CMD8 >> 1), SD::crc7(SD::CMD_INTERFACE_COND, SD::ARG_CMD8));
+}
+
+TEST_F(SdTest, WriteDataBlock_withCrcChecking) {
+    uint8_t       originalBlock[SD::SECTOR_SIZE];
+    uint8_t       moddedBlock[SD::SECTOR_SIZE];
+    uint8_t       myData[SD::SECTOR_SIZE];
+    const uint8_t sdBlockAddr = 0;
+
+    for (unsigned int i = 0; i < sizeof(myData); ++i)
+        myData[i] = (uint8_t) (i * 7);
+
+    testable.set_crc_checking(true);
+    PropWare::ErrorCode err = testable.start();
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    err = testable.read_data_block(sdBlockAddr, originalBlock);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SD::NO_ERROR, err);
+
+    err = testable.write_data_block(sdBlockAddr, myData);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SD::NO_ERROR, err);
+
+    err = testable.read_data_block(sdBlockAddr, moddedBlock);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SD::NO_ERROR, err);
+    ASSERT_EQ_MSG(0, memcmp(myData, moddedBlock, SD::SECTOR_SIZE));
+
+    err = testable.write_data_block(sdBlockAddr, originalBlock);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SD::NO_ERROR, err);
+}
+
+TEST_F(SdTest, ReadDataBlocks_matchesSingleBlockReads) {
+    const unsigned int BLOCKS = 3;
+    uint8_t            multiBlock[BLOCKS * SD::SECTOR_SIZE];
+    uint8_t            singleBlock[SD::SECTOR_SIZE];
+
+    PropWare::ErrorCode err = testable.start();
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    err = testable.read_data_blocks(0, BLOCKS, multiBlock);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SD::NO_ERROR, err);
+
+    for (unsigned int i = 0; i < BLOCKS; ++i) {
+        err = testable.read_data_block(i, singleBlock);
+        sd_error_checker(err);
+        ASSERT_EQ_MSG(SD::NO_ERROR, err);
+        ASSERT_EQ_MSG(0, memcmp(singleBlock, &multiBlock[i * SD::SECTOR_SIZE], SD::SECTOR_SIZE));
+    }
+}
+
+TEST_F(SdTest, WriteDataBlocks) {
+    const unsigned int BLOCKS      = 3;
+    const uint32_t     sdBlockAddr = 1;
+    uint8_t            originalBlocks[BLOCKS * SD::SECTOR_SIZE];
+    uint8_t            moddedBlocks[BLOCKS * SD::SECTOR_SIZE];
+    uint8_t            myData[BLOCKS * SD::SECTOR_SIZE];
+
+    for (unsigned int i = 0; i < sizeof(myData); ++i)
+        myData[i] = (uint8_t) (i ^ (i >> 8));
+
+    PropWare::ErrorCode err = testable.start();
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    err = testable.read_data_blocks(sdBlockAddr, BLOCKS, originalBlocks);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SD::NO_ERROR, err);
+    MESSAGE("WriteBlocks: Original blocks read in");
+
+    err = testable.write_data_blocks(sdBlockAddr, BLOCKS, myData);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SD::NO_ERROR, err);
+
+    err = testable.read_data_blocks(sdBlockAddr, BLOCKS, moddedBlocks);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SD::NO_ERROR, err);
+    ASSERT_EQ_MSG(0, memcmp(myData, moddedBlocks, sizeof(myData)));
+    MESSAGE("WriteBlocks: Modded blocks match written data");
+
+    err = testable.write_data_blocks(sdBlockAddr, BLOCKS, originalBlocks);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SD::NO_ERROR, err);
+
+    err = testable.read_data_blocks(sdBlockAddr, BLOCKS, moddedBlocks);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SD::NO_ERROR, err);
+    ASSERT_EQ_MSG(0, memcmp(originalBlocks, moddedBlocks, sizeof(originalBlocks)));
+    MESSAGE("WriteBlocks: Original blocks restored");
+}
+
 int main () {
     START(SDTest);
 
     RUN_TEST_F(SdTest, DefaultConstructor_RELIES_ON_DNA_BOARD);
     RUN_TEST_F(SdTest, Start);
+    RUN_TEST_F(SdTest, Start_negotiatesClockFromCsd);
     RUN_TEST_F(SdTest, ReadDataBlock);
     RUN_TEST_F(SdTest, WriteDataBlock);
+    RUN_TEST(Crc16_matchesKnownBlock);
+    RUN_TEST(Crc7_matchesFixedCommandCrcs);
+    RUN_TEST_F(SdTest, WriteDataBlock_withCrcChecking);
+    RUN_TEST_F(SdTest, ReadDataBlocks_matchesSingleBlockReads);
+    RUN_TEST_F(SdTest, WriteDataBlocks);
 
     COMPLETE();
 }